@@ -22,11 +22,16 @@ run_benchmarks ()
   serializer="$1"/ichor_serializer_benchmark
   start="$1"/ichor_start_benchmark
   start_stop="$1"/ichor_start_stop_benchmark
+  start_scaling="$1"/ichor_start_scaling_benchmark
   eval $coroutine || exit 1
-  eval $event || exit 1
+  eval $event multimap || exit 1
+  eval $event multimap_batched || exit 1
+  eval $event priority_band || exit 1
+  eval $event inline || exit 1
   eval $serializer || exit 1
   eval $start || exit 1
   eval $start_stop || exit 1
+  eval $start_scaling || exit 1
 }
 
 rm -rf ../std_std ../std_mimalloc ../absl_std ../absl_mimalloc
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/CommunicationChannel.h>
+#include <ichor/events/SharedPayloadEvent.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+#ifdef __SANITIZE_ADDRESS__
+constexpr uint64_t EVENT_COUNT = 200'000;
+constexpr uint64_t ROUNDTRIP_COUNT = 20'000;
+constexpr uint64_t BROADCAST_COUNT = 200;
+#else
+constexpr uint64_t EVENT_COUNT = 2'000'000;
+constexpr uint64_t ROUNDTRIP_COUNT = 200'000;
+constexpr uint64_t BROADCAST_COUNT = 2'000;
+#endif
+constexpr uint64_t BROADCAST_MANAGER_COUNT = 8;
+
+using namespace Ichor;
+
+struct ValueEvent final : public Event {
+    explicit ValueEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _value) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority), value(_value) {}
+    ~ValueEvent() final = default;
+
+    uint64_t value;
+    static constexpr uint64_t TYPE = typeNameHash<ValueEvent>();
+    static constexpr std::string_view NAME = typeName<ValueEvent>();
+};
+
+struct BlobEvent final : public Event {
+    explicit BlobEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::vector<uint8_t> _blob) noexcept :
+            Event(TYPE, NAME, _id, _originatingService, _priority), blob(std::move(_blob)) {}
+    ~BlobEvent() final = default;
+
+    std::vector<uint8_t> blob;
+    static constexpr uint64_t TYPE = typeNameHash<BlobEvent>();
+    static constexpr std::string_view NAME = typeName<BlobEvent>();
+};
+
+// Quits its manager once "EventCount" ValueEvents arrived
+class ReceiverService final : public Service<ReceiverService> {
+public:
+    ReceiverService(Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        _expected = Ichor::any_cast<uint64_t>(getProperties().operator[]("EventCount"));
+    }
+    ~ReceiverService() final = default;
+
+    AsyncGenerator<void> handleEvent(ValueEvent const &) {
+        if(++_received == _expected) {
+            getManager().pushEvent<QuitEvent>(getServiceId());
+        }
+        co_return;
+    }
+
+private:
+    StartBehaviour start() final {
+        _handler = getManager().registerEventHandler<ValueEvent>(this);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _handler.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    EventHandlerRegistration _handler{};
+    uint64_t _expected{};
+    uint64_t _received{};
+};
+
+// Bounces a ValueEvent with its peer until ROUNDTRIP_COUNT round trips are done, either over the communication channel or by pushing into the peer directly
+class PingPongService final : public Service<PingPongService> {
+public:
+    PingPongService() = default;
+    ~PingPongService() final = default;
+
+    AsyncGenerator<void> handleEvent(ValueEvent const &evt) {
+        if(evt.value == ROUNDTRIP_COUNT * 2) {
+            send<QuitEvent>();
+            getManager().pushEvent<QuitEvent>(getServiceId());
+        } else {
+            send<ValueEvent>(evt.value + 1);
+        }
+        co_return;
+    }
+
+    // call before the manager starts
+    void setPeer(DependencyManager *peer, bool useChannel) {
+        _peer = peer;
+        _useChannel = useChannel;
+    }
+
+private:
+    StartBehaviour start() final {
+        _handler = getManager().registerEventHandler<ValueEvent>(this);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _handler.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    template <typename EventT, typename... Args>
+    void send(Args&&... args) {
+        if(_useChannel) {
+            getManager().getCommunicationChannel()->sendEventTo<EventT>(_peer->getId(), getServiceId(), std::forward<Args>(args)...);
+        } else {
+            _peer->pushEvent<EventT>(getServiceId(), std::forward<Args>(args)...);
+        }
+    }
+
+    EventHandlerRegistration _handler{};
+    DependencyManager *_peer{};
+    bool _useChannel{};
+};
+
+// Quits its manager once BROADCAST_COUNT blobs arrived, either copied in a BlobEvent or shared in a SharedPayloadEvent
+class BroadcastReceiverService final : public Service<BroadcastReceiverService> {
+public:
+    BroadcastReceiverService() = default;
+    ~BroadcastReceiverService() final = default;
+
+    AsyncGenerator<void> handleEvent(BlobEvent const &evt) {
+        received(evt.blob);
+        co_return;
+    }
+
+    AsyncGenerator<void> handleEvent(SharedPayloadEvent<std::vector<uint8_t>> const &evt) {
+        received(*evt.payload);
+        co_return;
+    }
+
+private:
+    StartBehaviour start() final {
+        _blobHandler = getManager().registerEventHandler<BlobEvent>(this);
+        _sharedHandler = getManager().registerEventHandler<SharedPayloadEvent<std::vector<uint8_t>>>(this);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _blobHandler.reset();
+        _sharedHandler.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    void received(std::vector<uint8_t> const &blob) {
+        _checksum += blob.back();
+        if(++_received == BROADCAST_COUNT) {
+            getManager().pushEvent<QuitEvent>(getServiceId());
+        }
+    }
+
+    EventHandlerRegistration _blobHandler{};
+    EventHandlerRegistration _sharedHandler{};
+    uint64_t _received{};
+    uint64_t _checksum{};
+};
+
+struct ICounterService {
+    virtual ~ICounterService() = default;
+    virtual uint64_t increment() = 0;
+};
+
+// Called through a RemoteService from another manager
+class CounterService final : public ICounterService, public Service<CounterService> {
+public:
+    CounterService() = default;
+    ~CounterService() final = default;
+
+    uint64_t increment() final {
+        return ++_count;
+    }
+
+private:
+    StartBehaviour start() final {
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    uint64_t _count{};
+};
@@ -0,0 +1,252 @@
+#include "TestService.h"
+#include <ichor/RemoteService.h>
+#include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/services/logging/LoggerAdmin.h>
+#include <ichor/services/logging/NullLogger.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <array>
+
+enum class SendMode {
+    DIRECT, // pushEvent into the receiving manager, through the lock of its queue
+    CHANNEL, // sendEventTo over the communication channel, through the mailbox of the receiving queue unless its event loop sleeps
+    CHANNEL_BATCHED // sendEventsTo over the communication channel, 256 events per call
+};
+
+constexpr uint64_t BATCH_SIZE = 256;
+
+// Threads outside of any manager sending ValueEvents to one receiving manager
+void runThroughputBenchmark(char *name, std::string_view modeName, SendMode mode, uint64_t producerCount) {
+    CommunicationChannel channel{};
+    auto queue = std::make_unique<MultimapQueue>();
+    auto &dm = queue->createManager();
+    channel.addManager(&dm);
+    uint64_t const eventsPerProducer = EVENT_COUNT / producerCount;
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread receiver([&] {
+        dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        dm.createServiceManager<ReceiverService>(Properties{{"EventCount", Ichor::make_any<uint64_t>(eventsPerProducer * producerCount)}});
+        queue->start(CaptureSigInt);
+    });
+
+    std::vector<std::thread> producers{};
+    for(uint64_t i = 0; i < producerCount; i++) {
+        producers.emplace_back([&] {
+            if(mode == SendMode::CHANNEL_BATCHED) {
+                std::vector<uint64_t> payloads(BATCH_SIZE);
+                for(uint64_t sent = 0; sent < eventsPerProducer; sent += BATCH_SIZE) {
+                    payloads.resize(std::min(BATCH_SIZE, eventsPerProducer - sent));
+                    channel.sendEventsTo<ValueEvent>(dm.getId(), 0, payloads);
+                }
+            } else {
+                for(uint64_t j = 0; j < eventsPerProducer; j++) {
+                    if(mode == SendMode::DIRECT) {
+                        dm.pushEvent<ValueEvent>(0, j);
+                    } else {
+                        channel.sendEventTo<ValueEvent>(dm.getId(), 0, j);
+                    }
+                }
+            }
+        });
+    }
+
+    for(auto &producer : producers) {
+        producer.join();
+    }
+    receiver.join();
+    auto end = std::chrono::steady_clock::now();
+    channel.removeManager(&dm);
+
+    auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << fmt::format("{} {} {} producers ran for {:L} µs ({:L} events/s)\n", name, modeName, producerCount, runtime,
+                             eventsPerProducer * producerCount * 1'000'000ull / static_cast<uint64_t>(std::max(runtime, decltype(runtime){1})));
+}
+
+// Two managers bouncing one event back and forth
+void runLatencyBenchmark(char *name, std::string_view modeName, bool useChannel) {
+    CommunicationChannel channel{};
+    auto queueOne = std::make_unique<MultimapQueue>();
+    auto &dmOne = queueOne->createManager();
+    auto queueTwo = std::make_unique<MultimapQueue>();
+    auto &dmTwo = queueTwo->createManager();
+    channel.addManager(&dmOne);
+    channel.addManager(&dmTwo);
+
+    // both services have to know their peer before the first event arrives
+    dmOne.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+    dmOne.createServiceManager<PingPongService>()->setPeer(&dmTwo, useChannel);
+    dmTwo.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+    dmTwo.createServiceManager<PingPongService>()->setPeer(&dmOne, useChannel);
+    dmOne.pushEvent<ValueEvent>(0, uint64_t{0});
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread t1([&] {
+        queueOne->start(CaptureSigInt);
+    });
+    std::thread t2([&] {
+        queueTwo->start(CaptureSigInt);
+    });
+
+    t1.join();
+    t2.join();
+    auto end = std::chrono::steady_clock::now();
+    channel.removeManager(&dmOne);
+    channel.removeManager(&dmTwo);
+
+    auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << fmt::format("{} {} ping pong ran for {:L} µs ({:L} ns per round trip)\n", name, modeName, runtime, static_cast<uint64_t>(runtime) * 1'000ull / ROUNDTRIP_COUNT);
+}
+
+// One manager bouncing one event to itself, which skips the mailbox when sent over the channel as well
+void runSelfLatencyBenchmark(char *name, std::string_view modeName, bool useChannel) {
+    CommunicationChannel channel{};
+    auto queue = std::make_unique<MultimapQueue>();
+    auto &dm = queue->createManager();
+    channel.addManager(&dm);
+
+    dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+    dm.createServiceManager<PingPongService>()->setPeer(&dm, useChannel);
+    dm.pushEvent<ValueEvent>(0, uint64_t{0});
+
+    auto start = std::chrono::steady_clock::now();
+    queue->start(CaptureSigInt);
+    auto end = std::chrono::steady_clock::now();
+    channel.removeManager(&dm);
+
+    auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << fmt::format("{} {} self ping pong ran for {:L} µs ({:L} ns per event)\n", name, modeName, runtime, static_cast<uint64_t>(runtime) * 1'000ull / (ROUNDTRIP_COUNT * 2));
+}
+
+// A coroutine on one manager awaiting calls to a service on another manager, one at a time. Compare with the ping pong over the channel, which does the same with hand-written events.
+void runRemoteCallBenchmark(char *name) {
+    CommunicationChannel channel{};
+    auto queueOne = std::make_unique<MultimapQueue>();
+    auto &dmOne = queueOne->createManager();
+    auto queueTwo = std::make_unique<MultimapQueue>();
+    auto &dmTwo = queueTwo->createManager();
+    channel.addManager(&dmOne);
+    channel.addManager(&dmTwo);
+
+    dmOne.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+    dmOne.createServiceManager<CounterService, ICounterService>();
+    dmTwo.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+    dmTwo.createServiceManager<CounterService, ICounterService>();
+    dmOne.pushEvent<RunFunctionEvent>(0, [peerId = dmTwo.getId()](DependencyManager &dm) -> AsyncGenerator<void> {
+        RemoteService<ICounterService> counter{dm, peerId};
+        for(uint64_t i = 0; i < ROUNDTRIP_COUNT; i++) {
+            co_await counter.call([](ICounterService &svc) { return svc.increment(); }).begin();
+        }
+        dm.getCommunicationChannel()->broadcastEvent<QuitEvent>(dm, uint64_t{0});
+        dm.pushEvent<QuitEvent>(0);
+        co_return;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread t1([&] {
+        queueOne->start(CaptureSigInt);
+    });
+    std::thread t2([&] {
+        queueTwo->start(CaptureSigInt);
+    });
+
+    t1.join();
+    t2.join();
+    auto end = std::chrono::steady_clock::now();
+    channel.removeManager(&dmOne);
+    channel.removeManager(&dmTwo);
+
+    auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << fmt::format("{} remote service calls ran for {:L} µs ({:L} ns per round trip)\n", name, runtime, static_cast<uint64_t>(runtime) * 1'000ull / ROUNDTRIP_COUNT);
+}
+
+// A thread outside of any manager broadcasting a blob of payloadSize bytes to BROADCAST_MANAGER_COUNT managers, copied per manager or shared
+void runBroadcastBenchmark(char *name, std::string_view modeName, bool shared, uint64_t payloadSize) {
+    CommunicationChannel channel{};
+    // only used to exclude from the broadcast, never started
+    auto senderQueue = std::make_unique<MultimapQueue>();
+    auto &senderDm = senderQueue->createManager();
+    channel.addManager(&senderDm);
+
+    std::array<std::unique_ptr<MultimapQueue>, BROADCAST_MANAGER_COUNT> queues{};
+    std::array<DependencyManager*, BROADCAST_MANAGER_COUNT> dms{};
+    std::array<std::thread, BROADCAST_MANAGER_COUNT> threads{};
+    for(uint64_t i = 0; i < BROADCAST_MANAGER_COUNT; i++) {
+        queues[i] = std::make_unique<MultimapQueue>();
+        dms[i] = &queues[i]->createManager();
+        channel.addManager(dms[i]);
+        dms[i]->createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        dms[i]->createServiceManager<BroadcastReceiverService>();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < BROADCAST_MANAGER_COUNT; i++) {
+        threads[i] = std::thread([&queues, i] {
+            queues[i]->start(CaptureSigInt);
+        });
+    }
+
+    std::vector<uint8_t> blob(payloadSize, 1);
+    for(uint64_t i = 0; i < BROADCAST_COUNT; i++) {
+        if(shared) {
+            channel.broadcastSharedPayload(senderDm, 0, std::make_shared<std::vector<uint8_t>>(blob));
+        } else {
+            channel.broadcastEvent<BlobEvent>(senderDm, uint64_t{0}, blob);
+        }
+    }
+
+    for(auto &thread : threads) {
+        thread.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    for(auto *dm : dms) {
+        channel.removeManager(dm);
+    }
+    channel.removeManager(&senderDm);
+
+    auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    std::cout << fmt::format("{} {} broadcast of {:L} bytes to {} managers ran for {:L} µs ({:L} broadcasts/s)\n", name, modeName, payloadSize, BROADCAST_MANAGER_COUNT, runtime,
+                             BROADCAST_COUNT * 1'000'000ull / static_cast<uint64_t>(std::max(runtime, decltype(runtime){1})));
+}
+
+// Run "ichor_channel_benchmark direct", "ichor_channel_benchmark channel", "ichor_channel_benchmark channel_batched", "ichor_channel_benchmark remote_call" and "ichor_channel_benchmark broadcast" separately to compare
+int main(int argc, char *argv[]) {
+    std::locale::global(std::locale("en_US.UTF-8"));
+    std::ios::sync_with_stdio(false);
+
+    std::string_view modeArg = argc > 1 ? argv[1] : "";
+
+    if(modeArg.empty() || modeArg == "direct") {
+        runThroughputBenchmark(argv[0], "direct", SendMode::DIRECT, 1);
+        runThroughputBenchmark(argv[0], "direct", SendMode::DIRECT, 4);
+        runLatencyBenchmark(argv[0], "direct", false);
+        runSelfLatencyBenchmark(argv[0], "direct", false);
+    }
+
+    if(modeArg.empty() || modeArg == "channel") {
+        runThroughputBenchmark(argv[0], "channel", SendMode::CHANNEL, 1);
+        runThroughputBenchmark(argv[0], "channel", SendMode::CHANNEL, 4);
+        runLatencyBenchmark(argv[0], "channel", true);
+        runSelfLatencyBenchmark(argv[0], "channel", true);
+    }
+
+    if(modeArg.empty() || modeArg == "channel_batched") {
+        runThroughputBenchmark(argv[0], "channel_batched", SendMode::CHANNEL_BATCHED, 1);
+        runThroughputBenchmark(argv[0], "channel_batched", SendMode::CHANNEL_BATCHED, 4);
+    }
+
+    if(modeArg.empty() || modeArg == "remote_call") {
+        runLatencyBenchmark(argv[0], "channel", true);
+        runRemoteCallBenchmark(argv[0]);
+    }
+
+    if(modeArg.empty() || modeArg == "broadcast") {
+        for(uint64_t payloadSize : {64ull, 4'096ull, 262'144ull}) {
+            runBroadcastBenchmark(argv[0], "copied", false, payloadSize);
+            runBroadcastBenchmark(argv[0], "shared", true, payloadSize);
+        }
+    }
+
+    return 0;
+}
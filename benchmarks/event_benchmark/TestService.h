@@ -10,6 +10,8 @@ constexpr uint32_t EVENT_COUNT = 500'000;
 #else
 constexpr uint32_t EVENT_COUNT = 5'000'000;
 #endif
+constexpr uint32_t WORKER_EVENT_COUNT = EVENT_COUNT / 50;
+constexpr uint32_t WORKER_SERVICE_COUNT = 8;
 
 using namespace Ichor;
 
@@ -31,8 +33,13 @@ public:
 
 private:
     StartBehaviour start() final {
+        uint32_t eventCount = EVENT_COUNT;
+        if(getProperties().contains("EventCount")) {
+            eventCount = Ichor::any_cast<uint32_t>(getProperties().operator[]("EventCount"));
+        }
+
         auto start = std::chrono::steady_clock::now();
-        for(uint32_t i = 0; i < EVENT_COUNT; i++) {
+        for(uint32_t i = 0; i < eventCount; i++) {
             getManager().pushEvent<UselessEvent>(getServiceId());
         }
         auto end = std::chrono::steady_clock::now();
@@ -56,4 +63,34 @@ private:
     friend DependencyRegister;
 
     ILogger *_logger{nullptr};
-};
\ No newline at end of file
+};
+
+// Does some work for every UselessEvent on the worker threads of the manager
+class WorkerTestService final : public Service<WorkerTestService> {
+public:
+    WorkerTestService() = default;
+    ~WorkerTestService() final = default;
+
+    void handleWorkerEvent(UselessEvent const &evt) {
+        // stands in for a handler doing actual work, about a µs
+        uint64_t hash = evt.id;
+        for(uint32_t i = 0; i < 1'000; i++) {
+            hash = (hash ^ (hash >> 31)) * 0x9E3779B97F4A7C15ull;
+        }
+        _result += hash;
+    }
+
+private:
+    StartBehaviour start() final {
+        _handler = getManager().registerWorkerEventHandler<UselessEvent>(this);
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _handler.reset();
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    EventHandlerRegistration _handler{};
+    uint64_t _result{};
+};
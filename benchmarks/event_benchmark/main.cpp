@@ -1,5 +1,8 @@
 #include "TestService.h"
 #include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/event_queues/PriorityBandQueue.h>
+#include <ichor/event_queues/InlineEventQueue.h>
+#include <ichor/event_queues/EpollQueue.h>
 #include <ichor/services/logging/LoggerAdmin.h>
 #include <ichor/services/logging/NullLogger.h>
 #include <ichor/services/metrics/MemoryUsageFunctions.h>
@@ -7,39 +10,98 @@
 #include <thread>
 #include <array>
 
-int main(int argc, char *argv[]) {
-    std::locale::global(std::locale("en_US.UTF-8"));
-    std::ios::sync_with_stdio(false);
-
+template <typename QueueT, typename... QueueArgs>
+void runBenchmark(char *name, std::string_view queueName, QueueArgs... queueArgs) {
     {
         auto start = std::chrono::steady_clock::now();
-        auto queue = std::make_unique<MultimapQueue>();
+        auto queue = std::make_unique<QueueT>(queueArgs...);
         auto &dm = queue->createManager();
-        dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
-        dm.createServiceManager<TestService>(Properties{{"LogLevel", Ichor::make_any<LogLevel>(LogLevel::LOG_WARN)}});
+        dm.template createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        dm.template createServiceManager<TestService>(Properties{{"LogLevel", Ichor::make_any<LogLevel>(LogLevel::LOG_WARN)}});
         queue->start(CaptureSigInt);
         auto end = std::chrono::steady_clock::now();
-        std::cout << fmt::format("{} single threaded ran for {:L} µs with {:L} peak memory usage\n",argv[0],  std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+        auto const &allocator = dm.getEventAllocator();
+        auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << fmt::format("{} {} single threaded ran for {:L} µs ({:L} events/s) with {:L} peak memory usage\n", name, queueName, runtime, EVENT_COUNT * 1'000'000ull / static_cast<uint64_t>(std::max(runtime, decltype(runtime){1})), getPeakRSS());
+        std::cout << fmt::format("{} {} single threaded allocated {:L} events with {:L} heap allocations ({:.4f} per event)\n", name, queueName, allocator.allocations(), allocator.heapAllocations(),
+                                 static_cast<double>(allocator.heapAllocations()) / static_cast<double>(std::max(allocator.allocations(), uint64_t{1})));
     }
 
     {
         auto start = std::chrono::steady_clock::now();
         std::array<std::thread, 8> threads{};
-        std::array<MultimapQueue, 8> queues{};
+        std::array<std::unique_ptr<QueueT>, 8> queues{};
         for (uint_fast32_t i = 0, j = 0; i < 8; i++, j += 2) {
+            queues[i] = std::make_unique<QueueT>(queueArgs...);
             threads[i] = std::thread([&queues, i] {
-                auto &dm = queues[i].createManager();
-                dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
-                dm.createServiceManager<TestService>(Properties{{"LogLevel", Ichor::make_any<LogLevel>(LogLevel::LOG_WARN)}});
-                queues[i].start(CaptureSigInt);
+                auto &dm = queues[i]->createManager();
+                dm.template createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+                dm.template createServiceManager<TestService>(Properties{{"LogLevel", Ichor::make_any<LogLevel>(LogLevel::LOG_WARN)}});
+                queues[i]->start(CaptureSigInt);
             });
         }
         for (uint_fast32_t i = 0; i < 8; i++) {
             threads[i].join();
         }
         auto end = std::chrono::steady_clock::now();
-        std::cout << fmt::format("{} multi threaded ran for {:L} µs with {:L} peak memory usage\n",
-                                 argv[0], std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+        auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << fmt::format("{} {} multi threaded ran for {:L} µs ({:L} events/s) with {:L} peak memory usage\n",
+                                 name, queueName, runtime, 8 * EVENT_COUNT * 1'000'000ull / static_cast<uint64_t>(std::max(runtime, decltype(runtime){1})), getPeakRSS());
+    }
+}
+
+// One manager, with handlers that do some work running on worker threads
+template <typename QueueT>
+void runWorkerBenchmark(char *name, std::string_view queueName) {
+    for(uint32_t workerCount : {0u, 1u, 2u, 4u, 8u}) {
+        auto start = std::chrono::steady_clock::now();
+        auto queue = std::make_unique<QueueT>();
+        auto &dm = queue->createManager();
+        dm.setWorkerThreadCount(workerCount);
+        dm.template createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        for(uint32_t i = 0; i < WORKER_SERVICE_COUNT; i++) {
+            dm.template createServiceManager<WorkerTestService>();
+        }
+        dm.template createServiceManager<TestService>(Properties{{"LogLevel", Ichor::make_any<LogLevel>(LogLevel::LOG_WARN)}, {"EventCount", Ichor::make_any<uint32_t>(WORKER_EVENT_COUNT)}});
+        queue->start(CaptureSigInt);
+        auto end = std::chrono::steady_clock::now();
+        auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        std::cout << fmt::format("{} {} {} worker threads ran for {:L} µs ({:L} handled events/s)\n", name, queueName, workerCount, runtime,
+                                 WORKER_SERVICE_COUNT * WORKER_EVENT_COUNT * 1'000'000ull / static_cast<uint64_t>(std::max(runtime, decltype(runtime){1})));
+    }
+}
+
+// Peak memory usage is measured per process, so run "ichor_event_benchmark multimap", "ichor_event_benchmark multimap_batched", "ichor_event_benchmark priority_band", "ichor_event_benchmark inline" and "ichor_event_benchmark workers" separately to compare memory usage.
+int main(int argc, char *argv[]) {
+    std::locale::global(std::locale("en_US.UTF-8"));
+    std::ios::sync_with_stdio(false);
+
+    std::string_view queueArg = argc > 1 ? argv[1] : "";
+
+    if(queueArg.empty() || queueArg == "multimap") {
+        runBenchmark<MultimapQueue>(argv[0], "multimap");
+    }
+
+    if(queueArg.empty() || queueArg == "multimap_batched") {
+        runBenchmark<MultimapQueue>(argv[0], "multimap_batched", uint64_t{256});
+    }
+
+    if(queueArg.empty() || queueArg == "priority_band") {
+        runBenchmark<PriorityBandQueue>(argv[0], "priority_band");
+    }
+
+    if(queueArg.empty() || queueArg == "inline") {
+        runBenchmark<InlineEventQueue>(argv[0], "inline");
+    }
+
+#ifdef __linux__
+    if(queueArg.empty() || queueArg == "epoll") {
+        runBenchmark<EpollQueue>(argv[0], "epoll");
+    }
+#endif
+
+    if(queueArg.empty() || queueArg == "workers") {
+        runWorkerBenchmark<MultimapQueue>(argv[0], "multimap");
     }
 
     return 0;
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/services/logging/Logger.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+using namespace Ichor;
+
+struct IProvidedService {
+protected:
+    ~IProvidedService() = default;
+};
+
+// Provides an interface nobody requested, coming online should not involve any other service
+class ProvidingService final : public IProvidedService, public Service<ProvidingService> {
+public:
+    ProvidingService() = default;
+    ~ProvidingService() final = default;
+
+private:
+    StartBehaviour start() final {
+        auto iteration = Ichor::any_cast<uint64_t>(getProperties().operator[]("Iteration"));
+        auto count = Ichor::any_cast<uint64_t>(getProperties().operator[]("Count"));
+        if(iteration == count - 1) {
+            getManager().pushEvent<QuitEvent>(getServiceId());
+        }
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+};
+
+// Requests a logger, the LoggerAdmin creates one for every instance
+class LoggingService final : public Service<LoggingService> {
+public:
+    LoggingService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        reg.registerDependency<ILogger>(this, true);
+    }
+    ~LoggingService() final = default;
+
+private:
+    StartBehaviour start() final {
+        auto iteration = Ichor::any_cast<uint64_t>(getProperties().operator[]("Iteration"));
+        auto count = Ichor::any_cast<uint64_t>(getProperties().operator[]("Count"));
+        if(iteration == count - 1) {
+            getManager().pushEvent<QuitEvent>(getServiceId());
+        }
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        return Ichor::StartBehaviour::SUCCEEDED;
+    }
+
+    void addDependencyInstance(ILogger *logger, IService *) {
+        _logger = logger;
+    }
+
+    void removeDependencyInstance(ILogger *logger, IService *) {
+        _logger = nullptr;
+    }
+
+    friend DependencyRegister;
+
+    ILogger *_logger{nullptr};
+};
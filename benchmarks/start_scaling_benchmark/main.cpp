@@ -0,0 +1,62 @@
+#include "TestService.h"
+#include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/services/logging/LoggerAdmin.h>
+#include <ichor/services/logging/NullLogger.h>
+#include <ichor/services/metrics/MemoryUsageFunctions.h>
+#include <iostream>
+#include <array>
+
+#ifdef __SANITIZE_ADDRESS__
+constexpr std::array<uint64_t, 3> SERVICES_COUNTS{100, 1'000, 10'000};
+#else
+constexpr std::array<uint64_t, 3> SERVICES_COUNTS{1'000, 10'000, 100'000};
+#endif
+
+// Shows how starting and stopping scales with the amount of services, ideally linear
+int main(int argc, char *argv[]) {
+    std::locale::global(std::locale("en_US.UTF-8"));
+    std::ios::sync_with_stdio(false);
+
+    for(auto count : SERVICES_COUNTS) {
+        auto start = std::chrono::steady_clock::now();
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        for (uint64_t i = 0; i < count; i++) {
+            dm.createServiceManager<ProvidingService, IProvidedService>(Properties{{"Iteration", Ichor::make_any<uint64_t>(i)}, {"Count", Ichor::make_any<uint64_t>(count)}});
+        }
+        queue->start(CaptureSigInt);
+        auto end = std::chrono::steady_clock::now();
+        std::cout << fmt::format("{} {:L} services without dependencies ran for {:L} µs with {:L} peak memory usage\n", argv[0], count, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+    }
+
+    for(auto count : SERVICES_COUNTS) {
+        auto start = std::chrono::steady_clock::now();
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        for (uint64_t i = 0; i < count; i++) {
+            dm.createServiceManager<LoggingService>(Properties{{"Iteration", Ichor::make_any<uint64_t>(i)}, {"Count", Ichor::make_any<uint64_t>(count)}, {"LogLevel", Ichor::make_any<LogLevel>(LogLevel::LOG_WARN)}});
+        }
+        queue->start(CaptureSigInt);
+        auto end = std::chrono::steady_clock::now();
+        std::cout << fmt::format("{} {:L} services with a logger each ran for {:L} µs with {:L} peak memory usage\n", argv[0], count, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+    }
+
+    for(auto count : SERVICES_COUNTS) {
+        auto start = std::chrono::steady_clock::now();
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        std::vector<Properties> properties{};
+        properties.reserve(count);
+        for (uint64_t i = 0; i < count; i++) {
+            properties.emplace_back(Properties{{"Iteration", Ichor::make_any<uint64_t>(i)}, {"Count", Ichor::make_any<uint64_t>(count)}, {"LogLevel", Ichor::make_any<LogLevel>(LogLevel::LOG_WARN)}});
+        }
+        dm.createServiceManagers<LoggingService>(std::move(properties));
+        queue->start(CaptureSigInt);
+        auto end = std::chrono::steady_clock::now();
+        std::cout << fmt::format("{} {:L} services with a logger each created in bulk ran for {:L} µs with {:L} peak memory usage\n", argv[0], count, std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), getPeakRSS());
+    }
+
+    return 0;
+}
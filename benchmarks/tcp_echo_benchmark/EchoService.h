@@ -0,0 +1,60 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/services/network/NetworkEvents.h>
+#include <ichor/services/network/IConnectionService.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+#ifdef __SANITIZE_ADDRESS__
+constexpr std::chrono::milliseconds RUN_TIME = std::chrono::milliseconds(500);
+#else
+constexpr std::chrono::milliseconds RUN_TIME = std::chrono::milliseconds(2'000);
+#endif
+
+using namespace Ichor;
+
+// Sends everything received back over the connection it came from
+class EchoService final : public Service<EchoService> {
+public:
+    EchoService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        reg.registerDependency<IConnectionService>(this, false);
+    }
+    ~EchoService() final = default;
+
+private:
+    StartBehaviour start() final {
+        _dataEventRegistration = getManager().registerEventHandler<NetworkDataEvent>(this);
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _dataEventRegistration.reset();
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    void addDependencyInstance(IConnectionService *connectionService, IService *isvc) {
+        _connections.emplace(isvc->getServiceId(), connectionService);
+    }
+
+    void removeDependencyInstance(IConnectionService *, IService *isvc) {
+        _connections.erase(isvc->getServiceId());
+    }
+
+    AsyncGenerator<void> handleEvent(NetworkDataEvent const &evt) {
+        auto connection = _connections.find(evt.originatingService);
+
+        if(connection != _connections.end()) {
+            auto const bytes = evt.getBytes();
+            connection->second->sendAsync(std::vector<uint8_t>{bytes.begin(), bytes.end()});
+        }
+
+        co_return;
+    }
+
+    friend DependencyRegister;
+    friend DependencyManager;
+
+    unordered_map<uint64_t, IConnectionService*> _connections{};
+    EventHandlerRegistration _dataEventRegistration{};
+};
@@ -0,0 +1,157 @@
+#include "EchoService.h"
+#include <ichor/event_queues/EpollQueue.h>
+#include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/services/logging/LoggerAdmin.h>
+#include <ichor/services/logging/NullLogger.h>
+#include <ichor/services/network/tcp/TcpHostService.h>
+#ifdef ICHOR_USE_LIBURING
+#include <ichor/event_queues/IoUringQueue.h>
+#include <ichor/services/network/io_uring/IoUringHostService.h>
+#endif
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::string_literals;
+
+constexpr uint64_t MESSAGE_SIZE = 64;
+
+// Blocking loopback client, sends a message and waits for its echo until stop is set
+// \return amount of round trips
+uint64_t runClient(uint16_t port, std::atomic<bool> const &stop) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+    // the host may not be listening yet
+    int fd = -1;
+    while(!stop.load(std::memory_order_relaxed)) {
+        fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if(::connect(fd, (sockaddr *)&address, sizeof(address)) == 0) {
+            break;
+        }
+        ::close(fd);
+        fd = -1;
+        std::this_thread::sleep_for(1ms);
+    }
+
+    if(fd == -1) {
+        return 0;
+    }
+
+    int setting = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+
+    std::array<uint8_t, MESSAGE_SIZE> buf{};
+    uint64_t roundTrips{};
+    while(!stop.load(std::memory_order_relaxed)) {
+        if(::send(fd, buf.data(), buf.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(buf.size())) {
+            break;
+        }
+
+        uint64_t received{};
+        while(received < MESSAGE_SIZE) {
+            auto const ret = ::recv(fd, buf.data() + received, MESSAGE_SIZE - received, 0);
+            if(ret <= 0) {
+                ::close(fd);
+                return roundTrips;
+            }
+            received += static_cast<uint64_t>(ret);
+        }
+
+        roundTrips++;
+    }
+
+    ::close(fd);
+    return roundTrips;
+}
+
+// \param managers amount of managers, each with their own thread and listening socket on the port
+template <typename QueueT, typename HostT>
+void runEchoBenchmark(char *name, std::string_view backend, uint16_t port, uint64_t connections, uint64_t managers = 1) {
+    std::vector<std::unique_ptr<QueueT>> queues{};
+    std::vector<DependencyManager*> dms{};
+    std::vector<std::thread> threads{};
+    std::atomic<bool> stop{};
+    std::vector<uint64_t> roundTrips(connections);
+
+    for(uint64_t i = 0; i < managers; i++) {
+        auto *queue = queues.emplace_back(std::make_unique<QueueT>()).get();
+        auto &dm = queue->createManager();
+        dms.push_back(&dm);
+        threads.emplace_back([queue, &dm, port, managers] {
+            dm.template createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.template createServiceManager<HostT, IHostService>(Properties{{"Address", Ichor::make_any<std::string>("127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(port)}, {"ReusePort", Ichor::make_any<bool>(managers > 1)}});
+            dm.template createServiceManager<EchoService>();
+            queue->start(CaptureSigInt);
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients{};
+    clients.reserve(connections);
+    for(uint64_t i = 0; i < connections; i++) {
+        clients.emplace_back([&roundTrips, &stop, port, i] {
+            roundTrips[i] = runClient(port, stop);
+        });
+    }
+
+    std::this_thread::sleep_for(RUN_TIME);
+    stop.store(true, std::memory_order_relaxed);
+    for(auto &client : clients) {
+        client.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    for(auto *dm : dms) {
+        dm->template pushEvent<QuitEvent>(0);
+    }
+    for(auto &t : threads) {
+        t.join();
+    }
+
+    auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    auto const total = std::accumulate(roundTrips.begin(), roundTrips.end(), uint64_t{});
+    std::cout << fmt::format("{} {} {:L} managers {:L} connections did {:L} round trips of {} bytes in {:L} µs ({:L} round trips/s)\n", name, backend, managers, connections, total, MESSAGE_SIZE, runtime,
+                             total * 1'000'000ull / static_cast<uint64_t>(std::max(runtime, decltype(runtime){1})));
+}
+
+// Run "ichor_tcp_echo_benchmark <tcp|io_uring>" to run a single backend
+int main(int argc, char *argv[]) {
+    std::locale::global(std::locale("en_US.UTF-8"));
+    std::ios::sync_with_stdio(false);
+
+    std::string_view backendArg{};
+    if(argc > 1) {
+        backendArg = argv[1];
+    }
+
+    if(backendArg.empty() || backendArg == "tcp") {
+#ifdef __linux__
+        runEchoBenchmark<EpollQueue, TcpHostService>(argv[0], "tcp", 8101, 1);
+        runEchoBenchmark<EpollQueue, TcpHostService>(argv[0], "tcp", 8104, 64);
+        runEchoBenchmark<EpollQueue, TcpHostService>(argv[0], "tcp", 8105, 64, std::max(std::thread::hardware_concurrency(), 2u));
+#else
+        // without file descriptor watches, the TCP services poll their sockets with a timer
+        runEchoBenchmark<MultimapQueue, TcpHostService>(argv[0], "tcp", 8101, 1);
+#endif
+    }
+
+#ifdef ICHOR_USE_LIBURING
+    if(backendArg.empty() || backendArg == "io_uring") {
+        runEchoBenchmark<IoUringQueue, IoUringHostService>(argv[0], "io_uring", 8102, 1);
+        runEchoBenchmark<IoUringQueue, IoUringHostService>(argv[0], "io_uring", 8103, 64);
+    }
+#endif
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/services/timer/TimerService.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+#include <atomic>
+#include <vector>
+
+#ifdef __SANITIZE_ADDRESS__
+constexpr std::chrono::milliseconds RUN_TIME = std::chrono::milliseconds(500);
+#else
+constexpr std::chrono::milliseconds RUN_TIME = std::chrono::milliseconds(2'000);
+#endif
+
+using namespace Ichor;
+
+// services are gone by the time the queue stops, so the results are kept outside of them
+inline std::atomic<uint64_t> timerFires{};
+inline std::atomic<uint64_t> timerLatenessNs{};
+
+// Starts TimerCount timers with intervals spread over 10 to 100 ms
+class TimersService final : public Service<TimersService> {
+public:
+    TimersService() = default;
+    ~TimersService() final = default;
+
+    StartBehaviour start() final {
+        auto const timerCount = Ichor::any_cast<uint64_t>(getProperties().operator[]("TimerCount"));
+        _timers.reserve(timerCount);
+        _expected.resize(timerCount);
+        auto const now = std::chrono::steady_clock::now();
+
+        for(uint64_t i = 0; i < timerCount; i++) {
+            auto *timer = getManager().createServiceManager<Timer, ITimer>();
+            auto const interval = std::chrono::milliseconds(10 + 10 * (i % 10));
+            _expected[i] = now + interval;
+            timer->setChronoInterval(interval);
+            // the timer copies the callback for every tick, the next expected time has to live outside of it
+            timer->setCallback(this, [this, i, interval](DependencyManager &) -> AsyncGenerator<void> {
+                auto const fired = std::chrono::steady_clock::now();
+                timerFires.fetch_add(1, std::memory_order_relaxed);
+                if(fired > _expected[i]) {
+                    timerLatenessNs.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(fired - _expected[i]).count()), std::memory_order_relaxed);
+                }
+                _expected[i] += interval;
+                co_return;
+            });
+            timer->startTimer();
+            _timers.push_back(timer);
+        }
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _timers.clear();
+        return StartBehaviour::SUCCEEDED;
+    }
+
+private:
+    std::vector<Timer*> _timers{};
+    std::vector<std::chrono::steady_clock::time_point> _expected{};
+};
@@ -0,0 +1,69 @@
+#include "TestService.h"
+#include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/services/logging/LoggerAdmin.h>
+#include <ichor/services/logging/NullLogger.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <ctime>
+
+// amount of threads of this process, 0 if unknown
+uint64_t threadCount() {
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line)) {
+        if(line.starts_with("Threads:")) {
+            return std::stoull(line.substr(8));
+        }
+    }
+#endif
+    return 0;
+}
+
+void runTimerBenchmark(char *name, uint64_t timerCount) {
+    auto queue = std::make_unique<MultimapQueue>();
+    auto &dm = queue->createManager();
+    timerFires.store(0, std::memory_order_relaxed);
+    timerLatenessNs.store(0, std::memory_order_relaxed);
+
+    auto const cpuStart = std::clock();
+    auto start = std::chrono::steady_clock::now();
+    std::thread t([&] {
+        dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+        dm.createServiceManager<TimersService>(Properties{{"TimerCount", Ichor::make_any<uint64_t>(timerCount)}});
+        queue->start(CaptureSigInt);
+    });
+
+    std::this_thread::sleep_for(RUN_TIME / 2);
+    auto const threads = threadCount();
+    std::this_thread::sleep_for(RUN_TIME / 2);
+    dm.pushEvent<QuitEvent>(0);
+
+    t.join();
+    auto end = std::chrono::steady_clock::now();
+    auto const cpuEnd = std::clock();
+
+    auto const runtime = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    auto const fires = timerFires.load(std::memory_order_relaxed);
+    std::cout << fmt::format("{} {:L} timers ran for {:L} µs with {} threads, {:L} fires, {:L} µs cpu time, {:L} µs average lateness\n", name, timerCount, runtime, threads, fires,
+                             (cpuEnd - cpuStart) * 1'000'000ull / CLOCKS_PER_SEC, timerLatenessNs.load(std::memory_order_relaxed) / 1'000 / std::max(fires, uint64_t{1}));
+}
+
+// Run "ichor_timer_benchmark <amount of timers>" to run a single amount
+int main(int argc, char *argv[]) {
+    std::locale::global(std::locale("en_US.UTF-8"));
+    std::ios::sync_with_stdio(false);
+
+    if(argc > 1) {
+        runTimerBenchmark(argv[0], std::stoull(argv[1]));
+        return 0;
+    }
+
+    for(uint64_t timerCount : {10ull, 1'000ull, 10'000ull}) {
+        runTimerBenchmark(argv[0], timerCount);
+    }
+
+    return 0;
+}
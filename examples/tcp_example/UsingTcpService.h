@@ -65,7 +65,8 @@ private:
     }
 
     AsyncGenerator<void> handleEvent(NetworkDataEvent const &evt) {
-        auto msg = _serializer->deserialize(std::vector<uint8_t>{evt.getData()});
+        auto const bytes = evt.getBytes();
+        auto msg = _serializer->deserialize(std::vector<uint8_t>{bytes.begin(), bytes.end()});
         ICHOR_LOG_INFO(_logger, "Received TestMsg id {} val {}", msg->id, msg->val);
         getManager().pushEvent<QuitEvent>(getServiceId());
 
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <optional>
 #include <functional>
+#include <ichor/stl/SlotMap.h>
 
 namespace Ichor {
     struct Event;
@@ -12,8 +13,10 @@ namespace Ichor {
     class [[nodiscard]] EventCallbackInfo final {
     public:
         uint64_t listeningServiceId;
+        SlotMapHandle listeningServiceHandle; // INVALID_HANDLE if the service was not known to the manager on registration
         std::optional<uint64_t> filterServiceId;
         std::function<AsyncGenerator<void>(Event const &)> callback;
+        std::function<void(Event const &)> workerCallback; // set instead of callback for handlers registered through registerWorkerEventHandler()
     };
 
     class [[nodiscard]] EventInterceptInfo final {
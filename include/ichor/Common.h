@@ -68,6 +68,8 @@ namespace Ichor {
     inline constexpr InterfacesList_t<Type...> InterfacesList{};
 
 
+    struct prehashed_string;
+
     struct string_hash {
         using is_transparent = void;  // Pred to use
         using key_equal = std::equal_to<>;  // Pred to use
@@ -79,8 +81,23 @@ namespace Ichor {
         size_t operator()(std::string_view txt) const   { return hash_type{}(txt); }
         size_t operator()(const std::string& txt) const { return hash_type{}(txt); }
         size_t operator()(const char* txt) const        { return hash_type{}(txt); }
+        size_t operator()(const prehashed_string& txt) const noexcept;
+    };
+
+    // Key hashed once, for looking up the same key in many maps using string_hash
+    struct prehashed_string final {
+        explicit prehashed_string(std::string_view _txt) : txt(_txt), hash(string_hash{}(_txt)) {}
+
+        friend bool operator==(prehashed_string const &lhs, std::string_view rhs) noexcept {
+            return lhs.txt == rhs;
+        }
+
+        std::string_view txt;
+        size_t hash;
     };
 
+    inline size_t string_hash::operator()(const prehashed_string& txt) const noexcept { return txt.hash; }
+
 
 #ifdef ICHOR_USE_ABSEIL
     template <
@@ -114,7 +131,7 @@ namespace Ichor {
     using unordered_set = std::unordered_set<T, Hash, Eq, Allocator>;
 #endif
 
-    using Properties = unordered_map<std::string, Ichor::any, string_hash>;
+    using Properties = unordered_map<std::string, Ichor::any, string_hash, string_hash::key_equal>;
     using IchorProperty = std::pair<std::string, Ichor::any>;
 
     inline constexpr bool PreventOthersHandling = false;
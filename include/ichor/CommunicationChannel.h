@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ichor/DependencyManager.h>
+#include <ichor/events/SharedPayloadEvent.h>
 #include <ichor/stl/RealtimeReadWriteMutex.h>
 
 #ifdef DEBUG_CHANNEL
@@ -22,9 +23,13 @@ namespace Ichor {
             _managers.erase(manager->getId());
         }
 
+        /// Push an EventT into all managers except the originating one. Every manager gets its own copy of the arguments, use broadcastSharedPayload() for large payloads.
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \param originatingManager manager that does not receive the event
+        /// \param args arguments for the EventT constructor, starting with the originating service id
         template <typename EventT, typename... Args>
         requires Derived<EventT, Event>
-        void broadcastEvent(DependencyManager &originatingManager, Args&&... args) {
+        void broadcastEvent(DependencyManager &originatingManager, Args const&... args) {
             std::shared_lock l(_mutex);
             for(auto &[key, manager] : _managers) {
                 if(manager->getId() == originatingManager.getId()) {
@@ -34,7 +39,8 @@ namespace Ichor {
 #ifdef DEBUG_CHANNEL
                 std::cout << "Inserting event " << typeName<EventT>() << " from manager " << originatingManager->getId() << " into manager " << manager->getId() << std::endl;
 #endif
-                manager->template pushEvent<EventT>(std::forward<Args>(args)...);
+                // not forwarded, the next manager would get moved-from arguments
+                manager->template pushMailboxEvent<EventT>(args...);
 #ifdef DEBUG_CHANNEL
                 std::cout << "Inserted event " << typeName<EventT>() << " from manager " << originatingManager->getId() << " into manager " << manager->getId() << std::endl;
 #endif
@@ -51,7 +57,72 @@ namespace Ichor {
                 throw std::runtime_error("Couldn't find manager");
             }
 
-            manager->second->pushEvent<EventT>(std::forward<Args>(args)...);
+            manager->second->template pushMailboxEvent<EventT>(std::forward<Args>(args)...);
+        }
+
+        /// Push a SharedPayloadEvent<PayloadT> referring to payload into all managers except the originating one.
+        /// The payload is shared instead of copied, so the cost per manager does not depend on its size. Handlers must not modify it, they may run concurrently on different managers.
+        /// \tparam PayloadT type of the payload, handlers register for SharedPayloadEvent<PayloadT>
+        /// \param originatingManager manager that does not receive the event
+        /// \param originatingServiceId service that is pushing the event
+        /// \param payload kept alive until the last manager is done with its event
+        template <typename PayloadT>
+        void broadcastSharedPayload(DependencyManager &originatingManager, uint64_t originatingServiceId, std::shared_ptr<PayloadT> payload) {
+            using EventT = SharedPayloadEvent<std::remove_const_t<PayloadT>>;
+            std::shared_ptr<PayloadT const> const sharedPayload = std::move(payload);
+
+            std::shared_lock l(_mutex);
+            for(auto &[key, manager] : _managers) {
+                if(manager->getId() == originatingManager.getId()) {
+                    continue;
+                }
+
+                manager->template pushMailboxEvent<EventT>(originatingServiceId, sharedPayload);
+            }
+        }
+
+        /// Broadcast one EventT per payload to all managers except the originating one, taking the lock once for the whole batch.
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \param originatingManager manager that does not receive the events
+        /// \param originatingServiceId service that is pushing the events
+        /// \param payloads every element is passed as the last argument of the EventT constructor
+        template <typename EventT, typename Range>
+        requires Derived<EventT, Event>
+        void broadcastEvents(DependencyManager &originatingManager, uint64_t originatingServiceId, Range const &payloads) {
+            std::shared_lock l(_mutex);
+            for(auto &[key, manager] : _managers) {
+                if(manager->getId() == originatingManager.getId()) {
+                    continue;
+                }
+
+                for(auto const &payload : payloads) {
+                    manager->template pushMailboxEvent<EventT>(originatingServiceId, payload);
+                }
+            }
+        }
+
+        /// Send one EventT per payload to a specific manager, taking the lock and finding the manager once for the whole batch.
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \param id manager to send to
+        /// \param originatingServiceId service that is pushing the events
+        /// \param payloads every element is passed as the last argument of the EventT constructor, moved if payloads is an rvalue
+        template <typename EventT, typename Range>
+        requires Derived<EventT, Event>
+        void sendEventsTo(uint64_t id, uint64_t originatingServiceId, Range &&payloads) {
+            std::shared_lock l(_mutex);
+            auto manager = _managers.find(id);
+
+            if(manager == end(_managers)) {
+                throw std::runtime_error("Couldn't find manager");
+            }
+
+            for(auto &payload : payloads) {
+                if constexpr (std::is_rvalue_reference_v<Range&&>) {
+                    manager->second->template pushMailboxEvent<EventT>(originatingServiceId, std::move(payload));
+                } else {
+                    manager->second->template pushMailboxEvent<EventT>(originatingServiceId, payload);
+                }
+            }
         }
     private:
         unordered_map<uint64_t, DependencyManager*> _managers{};
@@ -57,6 +57,11 @@ namespace Ichor {
         { impl.handleEvent(evt) } -> std::same_as<AsyncGenerator<void>>;
     };
 
+    template <class ImplT, class EventT>
+    concept ImplementsWorkerEventHandlers = requires(ImplT impl, EventT const &evt) {
+        { impl.handleWorkerEvent(evt) } -> std::same_as<void>;
+    };
+
     template <class ImplT, class EventT>
     concept ImplementsEventInterceptors = requires(ImplT impl, EventT const &evt, bool processed, uint32_t handlerAmount) {
         { impl.preInterceptEvent(evt) } -> std::same_as<bool>;
@@ -8,15 +8,21 @@
 #include <atomic>
 #include <mutex>
 #include <shared_mutex>
+#include <optional>
+#include <limits>
 #include <ichor/interfaces/IFrameworkLogger.h>
 #include <ichor/Service.h>
 #include <ichor/LifecycleManager.h>
 #include <ichor/events/InternalEvents.h>
+#include <ichor/events/EventTypeIndex.h>
 #include <ichor/coroutines//IGenerator.h>
 #include <ichor/Callbacks.h>
 #include <ichor/Filter.h>
 #include <ichor/DependencyRegistrations.h>
+#include <ichor/WorkerPool.h>
 #include <ichor/event_queues/IEventQueue.h>
+#include <ichor/stl/CopyOnWriteVector.h>
+#include <ichor/stl/SlotMap.h>
 
 using namespace std::chrono_literals;
 
@@ -31,6 +37,12 @@ namespace Ichor {
         std::function<void(Event const &)> trackFunc;
     };
 
+    struct ShutdownProgress final {
+        uint64_t servicesToStop{}; // services that were not stopped when the shutdown started, or that started during it
+        uint64_t servicesStopped{};
+        std::vector<uint64_t> blockingServices{}; // ids of services whose stop is pending, all services depending on them already stopped
+    };
+
     class DependencyManager final {
     private:
         explicit DependencyManager(IEventQueue *eventQueue) : _eventQueue(eventQueue) {
@@ -79,46 +91,24 @@ namespace Ichor {
 
                 logAddService<Impl, Interfaces...>(cmpMgr->serviceId());
 
-                for (auto &[key, mgr] : _services) {
-                    if (mgr->getServiceState() == ServiceState::ACTIVE) {
-                        auto const filterProp = mgr->getProperties().find("Filter");
-                        const Filter *filter = nullptr;
-                        if (filterProp != cend(mgr->getProperties())) {
-                            filter = Ichor::any_cast<Filter * const>(&filterProp->second);
-                        }
+                injectActiveDependencies(*cmpMgr);
 
-                        if (filter != nullptr && !filter->compareTo(*cmpMgr.get())) {
-                            continue;
-                        }
-
-                        cmpMgr->dependencyOnline(mgr.get());
-                    }
-                }
+                // before starting, so event handlers registered in start() can refer to the service by handle
+                Impl* impl = &cmpMgr->getService();
+                auto *mgr = insertService(std::move(cmpMgr));
 
-                auto started = cmpMgr->start();
+                auto started = mgr->start();
 
-                for (auto const &[key, registration] : cmpMgr->getDependencyRegistry()->_registrations) {
-                    auto const &props = std::get<std::optional<Properties>>(registration);
-                    pushPrioritisedEvent<DependencyRequestEvent>(cmpMgr->serviceId(), priority, std::get<Dependency>(registration), props.has_value() ? &props.value() : std::optional<Properties const *>{});
-                }
+                requestDependencies(*mgr, priority);
 
                 auto event_priority = std::min(INTERNAL_DEPENDENCY_EVENT_PRIORITY, priority);
                 if(started == StartBehaviour::FAILED_AND_RETRY) {
-                    pushPrioritisedEvent<StartServiceEvent>(cmpMgr->serviceId(), event_priority, cmpMgr->serviceId());
+                    pushPrioritisedEvent<StartServiceEvent>(mgr->serviceId(), event_priority, mgr->serviceId());
                 } else if(started == StartBehaviour::SUCCEEDED) {
-                    pushPrioritisedEvent<DependencyOnlineEvent>(cmpMgr->serviceId(), event_priority);
+                    serviceStarted(mgr->serviceId(), event_priority);
                 }
 
-                cmpMgr->getService().injectPriority(priority);
-
-                if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                    if (_services.contains(cmpMgr->serviceId())) {
-                        std::terminate();
-                    }
-                }
-
-                Impl* impl = &cmpMgr->getService();
-                _services.emplace(cmpMgr->serviceId(), std::move(cmpMgr));
+                impl->injectPriority(priority);
 
                 return impl;
             } else {
@@ -136,25 +126,47 @@ namespace Ichor {
 
                 logAddService<Impl, Interfaces...>(cmpMgr->serviceId());
 
-                auto started = cmpMgr->start();
+                // before starting, so event handlers registered in start() can refer to the service by handle
+                Impl* impl = &cmpMgr->getService();
+                auto *mgr = insertService(std::move(cmpMgr));
+
+                auto started = mgr->start();
                 auto event_priority = std::min(INTERNAL_DEPENDENCY_EVENT_PRIORITY, priority);
                 if(started == StartBehaviour::FAILED_AND_RETRY) {
-                    pushPrioritisedEvent<StartServiceEvent>(cmpMgr->serviceId(), event_priority, cmpMgr->serviceId());
+                    pushPrioritisedEvent<StartServiceEvent>(mgr->serviceId(), event_priority, mgr->serviceId());
                 } else if(started == StartBehaviour::SUCCEEDED) {
-                    pushPrioritisedEvent<DependencyOnlineEvent>(cmpMgr->serviceId(), event_priority);
+                    serviceStarted(mgr->serviceId(), event_priority);
                 }
 
-                if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
-                    if (_services.contains(cmpMgr->serviceId())) {
-                        std::terminate();
-                    }
-                }
+                return impl;
+            }
+        }
 
-                Impl* impl = &cmpMgr->getService();
-                _services.emplace(cmpMgr->serviceId(), std::move(cmpMgr));
+        /// Create many services of the same type at once, cheaper than calling createServiceManager() for each of them.
+        /// Instead of events per service, one event requests the dependencies of all created services and one event brings all started services online.
+        /// Services that can start because of that are started by a single event as well, and so on. Services created while handling those events, like the loggers created by a LoggerAdmin, join the next batch.
+        /// \tparam Impl type of service to create
+        /// \tparam Interfaces interfaces the services provide
+        /// \param properties properties of every service to create
+        /// \param priority see createServiceManager()
+        /// \return created services, in the order of properties
+        template<DerivedTemplated<Service> Impl, typename... Interfaces>
+#if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
+        requires ImplementsAll<Impl, Interfaces...>
+#endif
+        std::vector<Impl*> createServiceManagers(std::vector<Properties> &&properties, uint64_t priority = INTERNAL_EVENT_PRIORITY) {
+            std::vector<Impl*> services{};
+            services.reserve(properties.size());
 
-                return impl;
+            bool const ownsBatch = beginServiceBatch();
+            for(auto &props : properties) {
+                services.push_back(createServiceManager<Impl, Interfaces...>(std::move(props), priority));
+            }
+            if(ownsBatch) {
+                endServiceBatch();
             }
+
+            return services;
         }
 
         /// Push event into event loop with specified priority
@@ -163,34 +175,99 @@ namespace Ichor {
         /// \param originatingServiceId service that is pushing the event
         /// \param args arguments for EventT constructor
         /// \return event id (can be used in completion/error handlers)
+        /// If the event queue is full and configured to fail pushes, the event is dropped and counted in getDroppedEventCount(). Use tryPushPrioritisedEvent() to find out.
         template <typename EventT, typename... Args>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
         requires Derived<EventT, Event>
 #endif
         uint64_t pushPrioritisedEvent(uint64_t originatingServiceId, uint64_t priority, Args&&... args){
             uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
-            _eventQueue->pushEvent(priority, std::unique_ptr<Event>{new EventT(std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), std::forward<uint64_t>(priority), std::forward<Args>(args)...)});
+            if(insertEvent<EventT>(priority, std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), std::forward<uint64_t>(priority), std::forward<Args>(args)...) == PushResult::QUEUE_FULL) {
+                _droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+            }
 //            ICHOR_LOG_TRACE(_logger, "inserted event of type {} into manager {}", typeName<EventT>(), getId());
             return eventId;
         }
 
+        /// Push event into event loop with specified priority, reporting whether the event was inserted.
+        /// Only differs from pushPrioritisedEvent when a capacity is set on the event queue with QueueFullBehaviour::FAIL or an overflow policy that fails.
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \tparam Args auto-deducible arguments for EventT constructor
+        /// \param originatingServiceId service that is pushing the event
+        /// \param args arguments for EventT constructor
+        /// \return event id if the event was inserted, empty if the queue was full
+        template <typename EventT, typename... Args>
+#if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
+        requires Derived<EventT, Event>
+#endif
+        std::optional<uint64_t> tryPushPrioritisedEvent(uint64_t originatingServiceId, uint64_t priority, Args&&... args){
+            uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
+            if(insertEvent<EventT>(priority, std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), std::forward<uint64_t>(priority), std::forward<Args>(args)...) == PushResult::QUEUE_FULL) {
+                return {};
+            }
+            return eventId;
+        }
+
         /// Push event into event loop with the default priority
         /// \tparam EventT Type of event to push, has to derive from Event
         /// \tparam Args auto-deducible arguments for EventT constructor
         /// \param originatingServiceId service that is pushing the event
         /// \param args arguments for EventT constructor
         /// \return event id (can be used in completion/error handlers)
+        /// If the event queue is full and configured to fail pushes, the event is dropped and counted in getDroppedEventCount(). Use tryPushPrioritisedEvent() to find out.
         template <typename EventT, typename... Args>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
         requires Derived<EventT, Event>
 #endif
         uint64_t pushEvent(uint64_t originatingServiceId, Args&&... args){
             uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
-            _eventQueue->pushEvent(INTERNAL_EVENT_PRIORITY, std::unique_ptr<Event>{new EventT(std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), INTERNAL_EVENT_PRIORITY, std::forward<Args>(args)...)});
+            if(insertEvent<EventT>(INTERNAL_EVENT_PRIORITY, std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), INTERNAL_EVENT_PRIORITY, std::forward<Args>(args)...) == PushResult::QUEUE_FULL) {
+                _droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+            }
 //            ICHOR_LOG_TRACE(_logger, "inserted event of type {} into manager {}", typeName<EventT>(), getId());
             return eventId;
         }
 
+        /// Push event into event loop with specified priority, once deadline has passed. Thread-safe.
+        /// Delayed events are kept in the timer wheel of the event queue, events with deadlines in the same tick (see Detail::TimerWheel::TICK) are inserted as one batch.
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \tparam Args auto-deducible arguments for EventT constructor
+        /// \param originatingServiceId service that is pushing the event
+        /// \param priority
+        /// \param deadline the event is not inserted before this time
+        /// \param args arguments for EventT constructor
+        /// \return event id (can be used in completion/error handlers)
+        /// If the event queue is full and configured to fail pushes, the event is dropped and counted in getDroppedEventCount()
+        template <typename EventT, typename... Args>
+#if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
+        requires Derived<EventT, Event>
+#endif
+        uint64_t pushEventAt(uint64_t originatingServiceId, uint64_t priority, std::chrono::steady_clock::time_point deadline, Args&&... args){
+            uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
+            auto evt = _eventAllocator.create<EventT>(std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), std::forward<uint64_t>(priority), std::forward<Args>(args)...);
+            evt->typeIndex = eventTypeIndex<EventT>();
+            if(_eventQueue->pushDelayedEvent(deadline, priority, std::move(evt)) == PushResult::QUEUE_FULL) {
+                _droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            return eventId;
+        }
+
+        /// Push event into event loop with specified priority, once delay has passed. Thread-safe. See pushEventAt().
+        /// \tparam EventT Type of event to push, has to derive from Event
+        /// \tparam Args auto-deducible arguments for EventT constructor
+        /// \param originatingServiceId service that is pushing the event
+        /// \param priority
+        /// \param delay the event is not inserted before this much time has passed
+        /// \param args arguments for EventT constructor
+        /// \return event id (can be used in completion/error handlers)
+        template <typename EventT, typename... Args>
+#if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
+        requires Derived<EventT, Event>
+#endif
+        uint64_t pushEventAfter(uint64_t originatingServiceId, uint64_t priority, std::chrono::nanoseconds delay, Args&&... args){
+            return pushEventAt<EventT>(originatingServiceId, priority, std::chrono::steady_clock::now() + delay, std::forward<Args>(args)...);
+        }
+
         template <typename Interface, typename Impl>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
         requires DerivedTemplated<Impl, Service> && ImplementsTrackingHandlers<Impl, Interface>
@@ -214,7 +291,7 @@ namespace Ichor {
             }}};
             
             std::vector<DependencyRequestEvent> requests{};
-            for(auto const &[key, mgr] : _services) {
+            for(auto const &mgr : _services) {
                 auto const *depRegistry = mgr->getDependencyRegistry();
 //                ICHOR_LOG_ERROR(_logger, "register svcId {} dm {}", mgr->serviceId(), _id);
 
@@ -284,26 +361,44 @@ namespace Ichor {
         /// \param targetServiceId optional service id to filter registering for, if empty, receive all events of type EventT
         /// \return RAII handler, removes registration upon destruction
         EventHandlerRegistration registerEventHandler(Impl *impl, std::optional<uint64_t> targetServiceId = {}) {
-            auto existingHandlers = _eventCallbacks.find(EventT::TYPE);
-            if(existingHandlers == end(_eventCallbacks)) {
-                std::vector<EventCallbackInfo> v{};
-                v.template emplace_back<>(EventCallbackInfo{
-                        impl->getServiceId(),
-                        targetServiceId,
-                        std::function<AsyncGenerator<void>(Event const &)>{
-                            [impl](Event const &evt) { return impl->handleEvent(static_cast<EventT const &>(evt)); }
-                        }
-                });
-                _eventCallbacks.emplace(EventT::TYPE, std::move(v));
-            } else {
-                existingHandlers->second.emplace_back(EventCallbackInfo{
-                    impl->getServiceId(),
-                    targetServiceId,
-                    std::function<AsyncGenerator<void>(Event const &)>{
-                        [impl](Event const &evt) { return impl->handleEvent(static_cast<EventT const &>(evt)); }
-                    }
-                });
-            }
+            // if this happens while dispatching, the dispatcher keeps iterating over its snapshot of the handlers
+            auto const serviceHandle = _serviceHandles.find(impl->getServiceId());
+            handlersFor(_eventCallbacks, eventTypeIndex<EventT>()).emplace_back(EventCallbackInfo{
+                impl->getServiceId(),
+                serviceHandle == end(_serviceHandles) ? SlotMap<std::unique_ptr<ILifecycleManager>>::INVALID_HANDLE : serviceHandle->second,
+                targetServiceId,
+                std::function<AsyncGenerator<void>(Event const &)>{
+                    [impl](Event const &evt) { return impl->handleEvent(static_cast<EventT const &>(evt)); }
+                },
+                {}
+            });
+            return EventHandlerRegistration(this, CallbackKey{impl->getServiceId(), EventT::TYPE}, impl->getServicePriority());
+        }
+
+        template <typename EventT, typename Impl>
+#if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
+        requires Derived<EventT, Event> && ImplementsWorkerEventHandlers<Impl, EventT>
+#endif
+        [[nodiscard]]
+        /// Register an event handler that runs on the worker threads of this manager, see setWorkerThreadCount().
+        /// Worker handlers of one service never run concurrently with each other, nor with anything else the manager calls on that service. They run in the order the manager processed the events.
+        /// The handler cannot suspend and is only allowed to call the thread-safe functions of the manager, like pushEvent(). Other services it calls have to be thread-safe.
+        /// \tparam EventT type of event (has to derive from Event)
+        /// \tparam Impl type of class registering handler (auto-deducible)
+        /// \param impl class that is registering handler
+        /// \param targetServiceId optional service id to filter registering for, if empty, receive all events of type EventT
+        /// \return RAII handler, removes registration upon destruction
+        EventHandlerRegistration registerWorkerEventHandler(Impl *impl, std::optional<uint64_t> targetServiceId = {}) {
+            auto const serviceHandle = _serviceHandles.find(impl->getServiceId());
+            handlersFor(_eventCallbacks, eventTypeIndex<EventT>()).emplace_back(EventCallbackInfo{
+                impl->getServiceId(),
+                serviceHandle == end(_serviceHandles) ? SlotMap<std::unique_ptr<ILifecycleManager>>::INVALID_HANDLE : serviceHandle->second,
+                targetServiceId,
+                {},
+                std::function<void(Event const &)>{
+                    [impl](Event const &evt) { impl->handleWorkerEvent(static_cast<EventT const &>(evt)); }
+                }
+            });
             return EventHandlerRegistration(this, CallbackKey{impl->getServiceId(), EventT::TYPE}, impl->getServicePriority());
         }
 
@@ -320,21 +415,14 @@ namespace Ichor {
         /// \return RAII handler, removes registration upon destruction
         EventInterceptorRegistration registerEventInterceptor(Impl *impl) {
             uint64_t targetEventId = 0;
+            uint32_t targetEventIndex = 0;
             if constexpr (!std::is_same_v<EventT, Event>) {
                 targetEventId = EventT::TYPE;
+                targetEventIndex = eventTypeIndex<EventT>();
             }
-            auto existingHandlers = _eventInterceptors.find(targetEventId);
-            if(existingHandlers == end(_eventInterceptors)) {
-                std::vector<EventInterceptInfo> v{};
-                v.template emplace_back<>(EventInterceptInfo{impl->getServiceId(), targetEventId,
-                                   std::function<bool(Event const &)>{[impl](Event const &evt){ return impl->preInterceptEvent(static_cast<EventT const &>(evt)); }},
-                                   std::function<void(Event const &, bool)>{[impl](Event const &evt, bool processed){ impl->postInterceptEvent(static_cast<EventT const &>(evt), processed); }}});
-                _eventInterceptors.emplace(targetEventId, std::move(v));
-            } else {
-                existingHandlers->second.template emplace_back<>(EventInterceptInfo{impl->getServiceId(), targetEventId,
-                                                      std::function<bool(Event const &)>{[impl](Event const &evt){ return impl->preInterceptEvent(static_cast<EventT const &>(evt)); }},
-                                                      std::function<void(Event const &, bool)>{[impl](Event const &evt, bool processed){ impl->postInterceptEvent(static_cast<EventT const &>(evt), processed); }}});
-            }
+            handlersFor(_eventInterceptors, targetEventIndex).emplace_back(EventInterceptInfo{impl->getServiceId(), targetEventId,
+                               std::function<bool(Event const &)>{[impl](Event const &evt){ return impl->preInterceptEvent(static_cast<EventT const &>(evt)); }},
+                               std::function<void(Event const &, bool)>{[impl](Event const &evt, bool processed){ impl->postInterceptEvent(static_cast<EventT const &>(evt), processed); }}});
             // I think there's a bug in GCC 10.1, where if I don't make this a unique_ptr, the EventHandlerRegistration destructor immediately gets called for some reason.
             // Even if the result is stored in a variable at the caller site.
             return EventInterceptorRegistration(this, CallbackKey{impl->getServiceId(), targetEventId}, impl->getServicePriority());
@@ -358,6 +446,16 @@ namespace Ichor {
             return _logger;
         }
 
+        [[nodiscard]] IEventQueue& getEventQueue() const noexcept {
+            return *_eventQueue;
+        }
+
+        /// Get the pool used for events pushed from the thread running this manager
+        /// \return allocator, mainly useful for its statistics
+        [[nodiscard]] EventAllocator const & getEventAllocator() const noexcept {
+            return _eventAllocator;
+        }
+
         [[nodiscard]] bool isRunning() const noexcept {
             return _started;
         };
@@ -370,7 +468,7 @@ namespace Ichor {
         [[nodiscard]] std::vector<Interface*> getStartedServices() noexcept {
             std::vector<Interface*> ret{};
             ret.reserve(_services.size());
-            for(auto &[key, svc] : _services) {
+            for(auto &svc : _services) {
                 if(svc->getServiceState() != ServiceState::ACTIVE) {
                     continue;
                 }
@@ -382,6 +480,27 @@ namespace Ichor {
             return ret;
         }
 
+        /// Quit the event loop once timeout passed since the first QuitEvent, even if not all services stopped. Event queues check this at least every 500 ms.
+        /// If the event loop quits before all services stopped, the blocking services are logged and passed to onIncompleteShutdown.
+        /// Not thread-safe, set before starting the queue.
+        /// \param timeout 0 waits until all services stopped
+        /// \param onIncompleteShutdown called on the thread running the event loop, before the remaining services are stopped forcibly
+        void setShutdownTimeout(std::chrono::milliseconds timeout, std::function<void(ShutdownProgress const &)> onIncompleteShutdown = {});
+
+        /// Only call from the thread running the event loop
+        /// \return progress of the shutdown started by the first QuitEvent, all zero if no QuitEvent was processed
+        [[nodiscard]] ShutdownProgress getShutdownProgress() const;
+
+        /// Run the handlers registered through registerWorkerEventHandler() on a pool of threads, with every service as a strand.
+        /// Everything else, like lifecycle functions, coroutines, interceptors and regular event handlers, keeps running on the thread of the manager.
+        /// Only that thread touches the services and handler tables of the manager, the workers only get the event and a snapshot of the handlers.
+        /// Before the manager calls into a service, it waits for the worker handlers of that service. Before processing any event other than a user event, it waits for all worker handlers.
+        /// Code the manager does not call into itself does not wait: a coroutine resumed by AsyncManualResetEvent::set() or AsyncAutoResetEvent::set() runs inside whoever called set(),
+        /// and callbacks of queue watches like EpollQueue::addFd() run in between events. Those may run concurrently with worker handlers of their service.
+        /// Not thread-safe, set before starting the queue.
+        /// \param count 0 runs worker handlers on the thread of the manager
+        void setWorkerThreadCount(uint32_t count);
+
         // Mainly useful for tests
         void runForOrQueueEmpty(std::chrono::milliseconds ms = 100ms) const noexcept;
 
@@ -389,7 +508,81 @@ namespace Ichor {
 
         [[nodiscard]] uint64_t getNextEventId() noexcept;
 
+        /// Thread-safe
+        /// \return amount of events dropped by pushes other than tryPushPrioritisedEvent() because the event queue was full, see IEventQueue::setCapacity()
+        [[nodiscard]] uint64_t getDroppedEventCount() const noexcept;
+
     private:
+        // Store the event inline if the queue supports it and the event fits, otherwise allocate it
+        template <typename EventT, typename... Args>
+        PushResult insertEvent(uint64_t priority, Args&&... args) {
+            if constexpr (EventStackUniquePtr::fitsInline<EventT>) {
+                if(_eventQueue->storesEventsInline()) {
+                    auto evt = EventStackUniquePtr::create<EventT>(std::forward<Args>(args)...);
+                    evt.get()->typeIndex = eventTypeIndex<EventT>();
+                    return _eventQueue->pushInlineEvent(priority, std::move(evt));
+                }
+            }
+
+            auto evt = _eventAllocator.create<EventT>(std::forward<Args>(args)...);
+            evt->typeIndex = eventTypeIndex<EventT>();
+            return _eventQueue->pushEvent(priority, std::move(evt));
+        }
+
+        // Push an event sent by another manager into the mailbox of the queue, thread-safe. Used by the CommunicationChannel.
+        // Events the event loop of this manager sends to itself skip the mailbox, only other threads gain from staying out of the lock.
+        template <typename EventT, typename... Args>
+        PushResult pushMailboxEvent(uint64_t originatingServiceId, Args&&... args) {
+            uint64_t eventId = _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
+            PushResult result;
+            if(Detail::_local_dm == this) {
+                result = insertEvent<EventT>(INTERNAL_EVENT_PRIORITY, std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), INTERNAL_EVENT_PRIORITY, std::forward<Args>(args)...);
+            } else {
+                auto evt = _eventAllocator.create<EventT>(std::forward<uint64_t>(eventId), std::forward<uint64_t>(originatingServiceId), INTERNAL_EVENT_PRIORITY, std::forward<Args>(args)...);
+                evt->typeIndex = eventTypeIndex<EventT>();
+                result = _eventQueue->pushMailboxEvent(INTERNAL_EVENT_PRIORITY, std::move(evt));
+            }
+            if(result == PushResult::QUEUE_FULL) {
+                _droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            return result;
+        }
+
+        template <typename LifecycleManagerT>
+        LifecycleManagerT* insertService(std::unique_ptr<LifecycleManagerT> &&mgr) {
+            if constexpr (DO_INTERNAL_DEBUG || DO_HARDENING) {
+                if (_serviceHandles.contains(mgr->serviceId())) {
+                    std::terminate();
+                }
+            }
+
+            auto *ret = mgr.get();
+            auto const handle = _services.insert(std::move(mgr));
+            _serviceHandles.emplace(ret->serviceId(), handle);
+            indexInterfaces(*ret, handle);
+            return ret;
+        }
+
+        // nullptr if serviceId is not, or no longer, known
+        [[nodiscard]] ILifecycleManager* findService(uint64_t serviceId) const noexcept {
+            auto handle = _serviceHandles.find(serviceId);
+            if(handle == end(_serviceHandles)) {
+                return nullptr;
+            }
+
+            auto const *mgr = _services.find(handle->second);
+            return mgr == nullptr ? nullptr : mgr->get();
+        }
+
+        // grows handlers if typeIndex is not yet present
+        template <typename InfoT>
+        [[nodiscard]] static CopyOnWriteVector<InfoT>& handlersFor(std::vector<CopyOnWriteVector<InfoT>> &handlers, uint32_t typeIndex) {
+            if(handlers.size() <= typeIndex) {
+                handlers.resize(typeIndex + 1);
+            }
+            return handlers[typeIndex];
+        }
+
         template <typename EventT>
 #if (!defined(WIN32) && !defined(_WIN32) && !defined(__WIN32)) || defined(__CYGWIN__)
         requires Derived<EventT, Event>
@@ -399,8 +592,8 @@ namespace Ichor {
                 return;
             }
 
-            auto service = _services.find(evt.originatingService);
-            if(service == end(_services) || service->second->getServiceState() != ServiceState::ACTIVE) {
+            auto const *service = findService(evt.originatingService);
+            if(service == nullptr || service->getServiceState() != ServiceState::ACTIVE) {
                 return;
             }
 
@@ -437,25 +630,90 @@ namespace Ichor {
             }
         }
 
+        // add/remove mgr to/from _servicesProvidingInterface or _servicesProvidingToService and _servicesRequestingInterface
+        void indexInterfaces(ILifecycleManager const &mgr, SlotMapHandle handle);
+        void unindexInterfaces(ILifecycleManager const &mgr, SlotMapHandle handle);
+        // call dependencyOnline() on requestingMgr for every active service that provides an interface it requested
+        void injectActiveDependencies(ILifecycleManager &requestingMgr);
+        // start collecting the events for created and started services in _serviceBatch
+        // \return false if a batch was already being collected, only whoever started it should end it
+        bool beginServiceBatch();
+        // push the batch events for everything collected since beginServiceBatch()
+        void endServiceBatch();
+        // push a DependencyRequestEvent for every dependency mgr registered, or add it to the batch
+        void requestDependencies(ILifecycleManager const &mgr, uint64_t priority);
+        // push a DependencyOnlineEvent, or add the service to the batch
+        void serviceStarted(uint64_t serviceId, uint64_t priority);
+        // push a StartServiceEvent, or add the service to the batch
+        void startDependent(uint64_t originatingServiceId, uint64_t serviceId);
+        // inject manager into the services that requested it, starting those that have all their dependencies now
+        void handleServiceOnline(ILifecycleManager &manager);
+        void handleDependencyRequest(DependencyRequestEvent const &evt);
+        // keep _scopedEvents and _scopedEventsPerService in sync, erasing the last scoped event of a service pushes its waiting StopServiceEvents
+        void addScopedEvent(uint64_t promiseId, std::shared_ptr<Event> const &evt);
+        void eraseScopedEvent(uint64_t promiseId);
+        // track all services not stopped yet and push a StopServiceEvent for those no running service depends on, quits the event loop if there are none
+        void stopRemainingServices();
+        // release the services in _servicesToStop that would never reach 0 dependees to stop
+        void breakDependencyCycles();
+        // track progress of the shutdown, pushes the StopServiceEvents of the services that only waited on this one
+        void serviceStoppedDuringShutdown(uint64_t serviceId);
+        // thread-safe, used by the event queues to quit regardless of services still running
+        [[nodiscard]] bool shutdownTimedOut() const noexcept;
         void handleEventCompletion(Event const &evt);
-        [[nodiscard]] uint64_t broadcastEvent(std::shared_ptr<Event> &evt);
+        // handlers registered through registerWorkerEventHandler() are collected in _workerHandlers if there is a worker pool
+        [[nodiscard]] uint64_t broadcastEvent(Event const &evt);
+        // post the handlers collected in _workerHandlers to the strands of their services
+        void dispatchToWorkers(std::shared_ptr<Event> &&evt);
+        // wait for the worker handlers of the service, if any, before calling into it from this thread
+        void waitForWorkers(uint64_t serviceId) noexcept;
         void setCommunicationChannel(CommunicationChannel *channel);
         void start();
-        void processEvent(std::unique_ptr<Event> &&evt);
+        void processEvent(std::unique_ptr<Event, EventDeleter> &&evt);
         void stop();
 
-        unordered_map<uint64_t, std::unique_ptr<ILifecycleManager>> _services{}; // key = service id
+        EventAllocator _eventAllocator{this}; // declared first, events in the members below may still refer to it
+        SlotMap<std::unique_ptr<ILifecycleManager>> _services{};
+        unordered_map<uint64_t, SlotMapHandle> _serviceHandles{}; // key = service id
+        unordered_map<uint64_t, CopyOnWriteVector<SlotMapHandle>> _servicesProvidingInterface{}; // key = interface name hash, excludes services in _servicesProvidingToService
+        unordered_map<uint64_t, CopyOnWriteVector<SlotMapHandle>> _servicesProvidingToService{}; // key = id of the only service the filter of these services matches
+        unordered_map<uint64_t, CopyOnWriteVector<SlotMapHandle>> _servicesRequestingInterface{}; // key = interface name hash
         unordered_map<uint64_t, std::vector<DependencyTrackerInfo>> _dependencyRequestTrackers{}; // key = interface name hash
         unordered_map<uint64_t, std::vector<DependencyTrackerInfo>> _dependencyUndoRequestTrackers{}; // key = interface name hash
         unordered_map<CallbackKey, std::function<void(Event const &)>> _completionCallbacks{}; // key = listening service id + event type
         unordered_map<CallbackKey, std::function<void(Event const &)>> _errorCallbacks{}; // key = listening service id + event type
-        unordered_map<uint64_t, std::vector<EventCallbackInfo>> _eventCallbacks{}; // key = event id
-        unordered_map<uint64_t, std::vector<EventInterceptInfo>> _eventInterceptors{}; // key = event id
+        std::vector<CopyOnWriteVector<EventCallbackInfo>> _eventCallbacks{}; // index = eventTypeIndex
+        std::vector<CopyOnWriteVector<EventInterceptInfo>> _eventInterceptors{}; // index = eventTypeIndex, 0 = interceptors for all events
         unordered_map<uint64_t, std::unique_ptr<IGenerator>> _scopedGenerators{}; // key = promise id
         unordered_map<uint64_t, std::shared_ptr<Event>> _scopedEvents{}; // key = promise id
+        unordered_map<uint64_t, uint64_t> _scopedEventsPerService{}; // key = originating service id of the scoped event, value = amount of entries in _scopedEvents
+        unordered_map<uint64_t, std::vector<uint64_t>> _stopsWaitingForCoroutines{}; // key = service id, value = originating services of the StopServiceEvents waiting for its scoped events to finish
+        std::vector<uint64_t> _suspendedPromiseIds{}; // promises that suspended while processing the current event, these share ownership of it in _scopedEvents
+        std::vector<EventCallbackInfo const *> _workerHandlers{}; // worker handlers for the current event, pointing into _workerHandlersSnapshot
+        CopyOnWriteVector<EventCallbackInfo>::Snapshot _workerHandlersSnapshot{};
+        std::unique_ptr<Detail::WorkerPool> _workerPool{}; // only present while running with worker threads
+        uint32_t _workerThreadCount{};
+        struct ServiceBatch final {
+            std::vector<uint64_t> requestingServices{};
+            std::vector<uint64_t> startedServices{};
+            std::vector<std::pair<uint64_t, uint64_t>> servicesToStart{}; // first = originating service, second = service to start
+            uint64_t requestPriority{std::numeric_limits<uint64_t>::max()};
+            uint64_t dependencyPriority{INTERNAL_DEPENDENCY_EVENT_PRIORITY};
+        };
+        std::optional<ServiceBatch> _serviceBatch{}; // only present while creating services in bulk or handling a batch event
+        unordered_map<uint64_t, uint64_t> _servicesToStop{}; // key = service id, value = amount of its dependees still to stop during shutdown, its StopServiceEvent is pushed at 0
+        unordered_map<uint64_t, std::vector<uint64_t>> _servicesWaitingForStop{}; // key = service id, value = services in _servicesToStop it depends on, waiting for it to stop
+        bool _shuttingDown{};
+        uint64_t _shutdownOriginatingService{};
+        uint64_t _servicesStoppedDuringShutdown{};
+        uint64_t _servicesToStopDuringShutdown{};
+        std::chrono::milliseconds _shutdownTimeout{};
+        std::function<void(ShutdownProgress const &)> _onIncompleteShutdown{};
+        std::atomic<std::chrono::steady_clock::time_point> _shutdownDeadline{std::chrono::steady_clock::time_point::max()};
         IEventQueue *_eventQueue;
         IFrameworkLogger *_logger{nullptr};
         std::atomic<uint64_t> _eventIdCounter{0};
+        std::atomic<uint64_t> _droppedEventCount{0};
         std::atomic<bool> _started{false};
         CommunicationChannel *_communicationChannel{nullptr};
         uint64_t _id{_managerIdCounter++};
@@ -1,17 +1,24 @@
 #pragma once
 
 #include <ichor/Common.h>
+#include <optional>
 #include <string>
+#include <type_traits>
 
 namespace Ichor {
 
     template <typename T>
     class PropertiesFilterEntry final {
     public:
-        PropertiesFilterEntry(std::string _key, T _val) : key(std::move(_key)), val(std::move(_val)) {}
+        PropertiesFilterEntry(std::string _key, T _val) : key(std::move(_key)), val(std::move(_val)), _resolvedKey(key) {}
+
+        // the resolved key has to refer to the key of the copy
+        PropertiesFilterEntry(const PropertiesFilterEntry &o) : key(o.key), val(o.val), _resolvedKey(key) {}
+        PropertiesFilterEntry& operator=(const PropertiesFilterEntry&) = delete;
 
         [[nodiscard]] bool matches(ILifecycleManager const &manager) const {
-            auto const propVal = manager.getProperties().find(key);
+            // the key is hashed when the filter is built, matching only probes the properties of the candidate
+            auto const propVal = manager.getProperties().find(_resolvedKey);
 
             if(propVal == cend(manager.getProperties())) {
                 return false;
@@ -21,11 +28,14 @@ namespace Ichor {
                 return false;
             }
 
-            return Ichor::any_cast<T&>(propVal->second) == val;
+            return Ichor::any_cast<T const &>(propVal->second) == val;
         }
 
         const std::string key;
         const T val;
+
+    private:
+        prehashed_string _resolvedKey; // refers to key
     };
 
     class ServiceIdFilterEntry final {
@@ -43,13 +53,20 @@ namespace Ichor {
     public:
         virtual ~ITemplatedFilter() = default;
         [[nodiscard]] virtual bool compareTo(ILifecycleManager const &manager) const = 0;
+        /// Lets the DependencyManager find the only candidate directly instead of comparing every service
+        /// \return id of the only service that can match, if the filter contains a ServiceIdFilterEntry
+        [[nodiscard]] virtual std::optional<uint64_t> requiredServiceId() const noexcept = 0;
     };
 
     // workaround std::any not supporting polymorphism
     template <typename... T>
     class TemplatedFilter final : public ITemplatedFilter {
     public:
-        TemplatedFilter(T&&... _entries) noexcept : entries(std::forward<T>(_entries)...) {}
+        TemplatedFilter(T&&... _entries) noexcept : entries(std::forward<T>(_entries)...) {
+            std::apply([this](auto const &...x){
+                (setRequiredServiceId(x), ...);
+            }, entries);
+        }
         ~TemplatedFilter() noexcept final = default;
 
         TemplatedFilter(const TemplatedFilter&) = default;
@@ -65,7 +82,21 @@ namespace Ichor {
             return matches;
         }
 
+        [[nodiscard]] std::optional<uint64_t> requiredServiceId() const noexcept final {
+            return _requiredServiceId;
+        }
+
         std::tuple<T...> entries;
+
+    private:
+        template <typename EntryT>
+        void setRequiredServiceId(EntryT const &entry) noexcept {
+            if constexpr (std::is_same_v<EntryT, ServiceIdFilterEntry>) {
+                _requiredServiceId = entry.id;
+            }
+        }
+
+        std::optional<uint64_t> _requiredServiceId{};
     };
 
     class Filter final {
@@ -83,6 +114,10 @@ namespace Ichor {
             return _templatedFilter->compareTo(manager);
         }
 
+        [[nodiscard]] std::optional<uint64_t> requiredServiceId() const noexcept {
+            return _templatedFilter->requiredServiceId();
+        }
+
         std::shared_ptr<ITemplatedFilter> _templatedFilter;
     };
 }
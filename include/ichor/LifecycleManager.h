@@ -10,8 +10,14 @@
 #include <ichor/DependencyRegister.h>
 
 namespace Ichor {
+    class ITemplatedFilter;
+
     namespace Detail {
         extern unordered_set<uint64_t> emptyDependencies;
+
+        /// \param properties
+        /// \return filter stored in the "Filter" property, nullptr if there is none
+        [[nodiscard]] std::shared_ptr<ITemplatedFilter const> findFilter(Properties const &properties);
     }
 
     class ILifecycleManager {
@@ -39,6 +45,9 @@ namespace Ichor {
         [[nodiscard]] virtual const std::vector<Dependency>& getInterfaces() const noexcept = 0;
         [[nodiscard]] virtual Properties const & getProperties() const noexcept = 0;
         [[nodiscard]] virtual DependencyRegister const * getDependencyRegistry() const noexcept = 0;
+        /// Looked up once on creation, changing the "Filter" property afterwards has no effect
+        /// \return filter restricting which services can depend on this one, nullptr if any service can
+        [[nodiscard]] virtual ITemplatedFilter const * getFilter() const noexcept = 0;
         virtual void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(void*, IService*)>&) = 0;
         virtual void removeSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(void*, IService*)>&) = 0;
     };
@@ -49,7 +58,7 @@ namespace Ichor {
 #endif
     class DependencyLifecycleManager final : public ILifecycleManager {
     public:
-        explicit DependencyLifecycleManager(std::vector<Dependency> interfaces, Properties&& properties, DependencyManager *mng) : _implementationName(typeName<ServiceType>()), _interfaces(std::move(interfaces)), _registry(mng), _dependencies(), _service(_registry, std::forward<Properties>(properties), mng) {
+        explicit DependencyLifecycleManager(std::vector<Dependency> interfaces, Properties&& properties, DependencyManager *mng) : _implementationName(typeName<ServiceType>()), _interfaces(std::move(interfaces)), _registry(mng), _dependencies(), _service(_registry, std::forward<Properties>(properties), mng), _filter(Detail::findFilter(_service._properties)) {
             for(auto const &reg : _registry._registrations) {
                 _dependencies.addDependency(std::get<0>(reg.second));
             }
@@ -242,12 +251,17 @@ namespace Ichor {
             return &_registry;
         }
 
+        [[nodiscard]] ITemplatedFilter const * getFilter() const noexcept final {
+            return _filter.get();
+        }
+
     private:
         const std::string_view _implementationName;
         std::vector<Dependency> _interfaces;
         DependencyRegister _registry;
         DependencyInfo _dependencies;
         ServiceType _service;
+        std::shared_ptr<ITemplatedFilter const> _filter;
         unordered_set<uint64_t> _serviceIdsOfInjectedDependencies; // Services that this service depends on.
         unordered_set<uint64_t> _serviceIdsOfDependees; // services that depend on this service
     };
@@ -259,12 +273,13 @@ namespace Ichor {
     class LifecycleManager final : public ILifecycleManager {
     public:
         template <typename U = ServiceType> requires RequestsProperties<U>
-        explicit LifecycleManager(std::vector<Dependency> interfaces, Properties&& properties, DependencyManager *mng) : _implementationName(typeName<ServiceType>()), _interfaces(std::move(interfaces)), _service(std::forward<Properties>(properties), mng) {
+        explicit LifecycleManager(std::vector<Dependency> interfaces, Properties&& properties, DependencyManager *mng) : _implementationName(typeName<ServiceType>()), _interfaces(std::move(interfaces)), _service(std::forward<Properties>(properties), mng), _filter(Detail::findFilter(_service._properties)) {
         }
 
         template <typename U = ServiceType> requires (!RequestsProperties<U>)
         explicit LifecycleManager(std::vector<Dependency> interfaces, Properties&& properties, DependencyManager *mng) : _implementationName(typeName<ServiceType>()), _interfaces(std::move(interfaces)), _service() {
             _service.setProperties(std::forward<Properties>(properties));
+            _filter = Detail::findFilter(_service._properties);
         }
 
         ~LifecycleManager() final = default;
@@ -352,6 +367,10 @@ namespace Ichor {
             return nullptr;
         }
 
+        [[nodiscard]] ITemplatedFilter const * getFilter() const noexcept final {
+            return _filter.get();
+        }
+
         void insertSelfInto(uint64_t keyOfInterfaceToInject, uint64_t serviceIdOfOther, std::function<void(void*, IService*)> &fn) final {
             if constexpr (sizeof...(IFaces) > 0) {
                 insertSelfInto2<sizeof...(IFaces), IFaces...>(keyOfInterfaceToInject, fn);
@@ -383,6 +402,7 @@ namespace Ichor {
         const std::string_view _implementationName;
         std::vector<Dependency> _interfaces;
         ServiceType _service;
+        std::shared_ptr<ITemplatedFilter const> _filter;
         unordered_set<uint64_t> _serviceIdsOfDependees; // services that depend on this service
     };
 }
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <ichor/CommunicationChannel.h>
+#include <ichor/coroutines/AsyncGenerator.h>
+#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <ichor/events/RunFunctionEvent.h>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace Ichor {
+    /// Result of RemoteService::call(), empty (or false for functions returning void) if the owning manager had no started service implementing the interface or dropped the call.
+    /// Functions returning a reference yield a copy of what it refers to.
+    template <typename ReturnT>
+    using RemoteCallResult = std::conditional_t<std::is_void_v<ReturnT>, bool, std::optional<std::remove_cvref_t<ReturnT>>>;
+
+    namespace Detail {
+        template <typename ResultT>
+        struct RemoteCallState final {
+            ResultT result{};
+            std::exception_ptr exception{};
+            AsyncManualResetEvent event{};
+        };
+
+        // Resumes the caller exactly once: after the call ran, or when the owning manager destroys the call without running it, e.g. because it quit first.
+        template <typename ResultT>
+        class RemoteCallReply final {
+        public:
+            RemoteCallReply(std::shared_ptr<RemoteCallState<ResultT>> state, CommunicationChannel *channel, uint64_t callingManagerId) noexcept : _state(std::move(state)), _channel(channel), _callingManagerId(callingManagerId) {}
+
+            RemoteCallReply(const RemoteCallReply&) = delete;
+            RemoteCallReply(RemoteCallReply&&) = delete;
+            RemoteCallReply& operator=(const RemoteCallReply&) = delete;
+            RemoteCallReply& operator=(RemoteCallReply&&) = delete;
+
+            ~RemoteCallReply() {
+                send();
+            }
+
+            void send() noexcept {
+                if(_sent) {
+                    return;
+                }
+                _sent = true;
+
+                // Service id 0 to resume the caller even if its service is stopping, otherwise the coroutine never completes.
+                try {
+                    _channel->template sendEventTo<RunFunctionEvent>(_callingManagerId, 0, [state = std::move(_state)](DependencyManager &) -> AsyncGenerator<void> {
+                        state->event.set();
+                        co_return;
+                    });
+                } catch(...) {
+                    // the calling manager left the channel, there is no one left to resume
+                }
+            }
+
+        private:
+            std::shared_ptr<RemoteCallState<ResultT>> _state;
+            CommunicationChannel *_channel;
+            uint64_t _callingManagerId;
+            bool _sent{};
+        };
+    }
+
+    /// Handle to a service implementing Interface that is registered to another manager.
+    /// Calls run on the thread of the owning manager, the awaiting coroutine resumes on the thread of the calling manager.
+    /// Both managers have to be registered to the same CommunicationChannel, which has to outlive them.
+    template <typename Interface>
+    class RemoteService final {
+    public:
+        /// \param callingManager manager running the coroutines that await the calls
+        /// \param owningManagerId manager the service implementing Interface is registered to
+        RemoteService(DependencyManager &callingManager, uint64_t owningManagerId) noexcept : _callingManager(&callingManager), _owningManagerId(owningManagerId) {}
+
+        /// Call fn with the first started service implementing Interface in the owning manager.
+        /// Usage: auto result = *co_await remoteService.call([](Interface &svc) { return svc.something(); }).begin();
+        /// \param fn called as fn(Interface&) on the thread of the owning manager. Copy what the result refers to, the service may be gone by the time the caller resumes.
+        /// \throws what fn threw, rethrown on the thread of the calling manager
+        /// \return generator yielding the RemoteCallResult of fn
+        template <typename FuncT>
+        requires std::invocable<FuncT&, Interface&>
+        AsyncGenerator<RemoteCallResult<std::invoke_result_t<FuncT&, Interface&>>> call(FuncT fn) {
+            using ReturnT = std::invoke_result_t<FuncT&, Interface&>;
+            using ResultT = RemoteCallResult<ReturnT>;
+
+            auto *channel = _callingManager->getCommunicationChannel();
+            if(channel == nullptr) {
+                throw std::runtime_error("Calling manager is not registered to a communication channel");
+            }
+
+            // shared with the owning manager, so neither side refers to the frame or the manager of the other
+            auto state = std::make_shared<Detail::RemoteCallState<ResultT>>();
+            auto reply = std::make_shared<Detail::RemoteCallReply<ResultT>>(state, channel, _callingManager->getId());
+
+            channel->template sendEventTo<RunFunctionEvent>(_owningManagerId, 0, [state, reply = std::move(reply), fn = std::move(fn)](DependencyManager &dm) mutable -> AsyncGenerator<void> {
+                try {
+                    auto services = dm.template getStartedServices<Interface>();
+                    if(!services.empty()) {
+                        if constexpr (std::is_void_v<ReturnT>) {
+                            fn(*services.front());
+                            state->result = true;
+                        } else {
+                            state->result.emplace(fn(*services.front()));
+                        }
+                    }
+                } catch(...) {
+                    state->exception = std::current_exception();
+                }
+
+                reply->send();
+                co_return;
+            });
+
+            co_await state->event;
+
+            if(state->exception) {
+                std::rethrow_exception(state->exception);
+            }
+
+            co_return std::move(state->result);
+        }
+
+        [[nodiscard]] uint64_t getOwningManagerId() const noexcept {
+            return _owningManagerId;
+        }
+
+    private:
+        DependencyManager *_callingManager;
+        uint64_t _owningManagerId;
+    };
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <ichor/Common.h>
+#include <ichor/Callbacks.h>
+#include <ichor/stl/CopyOnWriteVector.h>
+#include <ichor/stl/RealtimeMutex.h>
+#include <ichor/stl/ConditionVariable.h>
+
+namespace Ichor {
+    struct Event;
+    class DependencyManager;
+}
+
+namespace Ichor::Detail {
+    // Manager whose worker pool runs on this thread, nullptr on all other threads
+    thread_local extern DependencyManager *_local_worker_dm;
+
+    // An event and the handlers it is dispatched to, shared by all worker tasks for that event.
+    // The snapshot keeps the handlers alive, even if they are unregistered while the tasks are queued.
+    struct WorkerDispatch final {
+        std::shared_ptr<Event> event;
+        CopyOnWriteVector<EventCallbackInfo>::Snapshot callbacks;
+    };
+
+    struct WorkerTask final {
+        std::shared_ptr<WorkerDispatch> dispatch;
+        EventCallbackInfo const *callbackInfo;
+    };
+
+    // Tasks of one service. A strand is queued at one worker at most, so its tasks run in order and never concurrently.
+    struct Strand final {
+        RealtimeMutex mutex{};
+        std::vector<WorkerTask> tasks{}; // guarded by mutex
+        bool scheduled{}; // guarded by mutex, true while queued at or run by a worker
+        std::atomic<uint64_t> pending{}; // posted and not yet finished tasks
+    };
+
+    // Threads running the worker event handlers of one manager.
+    // Every worker has its own deque of strands with tasks and steals from the back of the other deques when its own is empty.
+    // Posting, waiting and removing services is only done by the thread running the manager.
+    class WorkerPool final {
+    public:
+        // limit on posted and not yet finished tasks, posting more waits for the workers to catch up
+        static constexpr uint64_t MAX_PENDING_TASKS = 65'536;
+
+        WorkerPool(DependencyManager *dm, uint32_t threadCount);
+        // waits for all tasks to finish
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        WorkerPool& operator=(WorkerPool&&) = delete;
+
+        void post(uint64_t serviceId, WorkerTask &&task);
+        // wait until no task of the service is queued or running
+        void waitForService(uint64_t serviceId) noexcept;
+        // wait until no task is queued or running
+        void waitForAll() noexcept;
+        // forget the strand of a removed service, waits until no worker refers to it
+        void removeService(uint64_t serviceId) noexcept;
+        [[nodiscard]] bool idle() const noexcept;
+
+    private:
+        struct Worker final {
+            RealtimeMutex mutex{};
+            std::deque<Strand*> strands{}; // guarded by mutex
+            std::thread thread{};
+        };
+
+        void run(uint32_t index);
+        [[nodiscard]] Strand* take(uint32_t index) noexcept;
+        // run the tasks posted so far, requeues the strand at the worker if more were posted meanwhile
+        void runStrand(Strand &strand, uint32_t index, std::vector<WorkerTask> &tasks);
+        void wakeWorker();
+
+        DependencyManager *_dm;
+        std::vector<std::unique_ptr<Worker>> _workers{};
+        unordered_map<uint64_t, std::unique_ptr<Strand>> _strands{}; // key = service id
+        uint32_t _nextWorker{};
+        alignas(64) std::atomic<uint64_t> _pending{};
+        alignas(64) std::atomic<uint64_t> _queuedStrands{};
+        alignas(64) std::atomic<uint32_t> _sleepingWorkers{};
+        std::atomic<bool> _quit{};
+        RealtimeMutex _wakeupMutex{};
+        ConditionVariable _wakeup{};
+    };
+}
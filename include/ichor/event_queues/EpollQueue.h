@@ -0,0 +1,84 @@
+#pragma once
+
+#ifdef __linux__
+
+#include <ichor/stl/RealtimeMutex.h>
+#include <ichor/event_queues/IEventQueue.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#ifdef ICHOR_USE_ABSEIL
+#include <absl/container/btree_map.h>
+#else
+#include <map>
+#endif
+
+namespace Ichor {
+    class DependencyManager;
+
+    /// Event queue that waits in epoll instead of on a condition variable, so the thread running the event loop can also watch file descriptors (see addFd()).
+    /// Events are ordered by priority and in FIFO order within a priority, like the MultimapQueue.
+    /// Producers on other threads wake a sleeping event loop through an eventfd.
+    class EpollQueue final : public IEventQueue {
+    public:
+        /// \param maxEventsBetweenPolls maximum amount of events processed before checking the file descriptors again
+        explicit EpollQueue(uint64_t maxEventsBetweenPolls = 64);
+        ~EpollQueue() final;
+
+        PushResult pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+
+        uint64_t addFd(int fd, FdInterest interest, std::function<void(FdReadiness)> onReady) final;
+        void modifyFd(uint64_t id, FdInterest interest) final;
+        void removeFd(uint64_t id) final;
+        [[nodiscard]] bool supportsFds() const noexcept final {
+            return true;
+        }
+
+        [[nodiscard]] bool empty() const noexcept final;
+        [[nodiscard]] uint64_t size() const noexcept final;
+
+        void start(bool captureSigInt) final;
+        [[nodiscard]] bool shouldQuit() final;
+        void quit() final;
+
+    private:
+        struct FdWatch final {
+            int fd;
+            bool removed; // set by removeFd() while poll() may still hold on to the watch
+            std::function<void(FdReadiness)> onReady;
+        };
+
+        // wait for ready file descriptors at most timeout long and call their watches
+        void poll(std::chrono::nanoseconds timeout);
+        // assume _eventQueueMutex is locked
+        void moveMailboxAndTimerEvents();
+        void shouldAddQuitEvent();
+        void wakeSleepingConsumer();
+
+#ifdef ICHOR_USE_ABSEIL
+        absl::btree_multimap<uint64_t, std::unique_ptr<Event, EventDeleter>> _eventQueue{};
+#else
+        std::multimap<uint64_t, std::unique_ptr<Event, EventDeleter>> _eventQueue{};
+#endif
+        uint64_t _maxEventsBetweenPolls;
+        mutable RealtimeMutex _eventQueueMutex{};
+        int _epollFd{-1};
+        int _eventFd{-1};
+        // only accessed by the thread running the event loop
+        unordered_map<uint64_t, std::shared_ptr<FdWatch>> _watches{};
+        uint64_t _nextWatchId{1};
+        std::vector<std::shared_ptr<FdWatch>> _readyWatches{};
+        std::vector<FdReadiness> _readiness{};
+        std::atomic<bool> _consumerSleeping{false};
+        std::atomic<bool> _wakeupPending{false};
+        std::atomic<bool> _quit{false};
+        bool _quitEventSent{false};
+        std::chrono::steady_clock::time_point _whenQuitEventWasSent{};
+    };
+}
+
+#endif
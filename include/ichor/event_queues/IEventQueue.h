@@ -2,31 +2,239 @@
 
 #include <cstdint>
 #include <memory>
-#include <ichor/events/Event.h>
+#include <functional>
+#include <ichor/Common.h>
+#include <ichor/events/EventAllocator.h>
+#include <ichor/stl/EventStackUniquePtr.h>
+#include <ichor/stl/MpscQueue.h>
+#include <ichor/event_queues/TimerWheel.h>
+#include <atomic>
+#include <chrono>
+#include <optional>
 
 namespace Ichor {
     class DependencyManager;
+#ifdef ICHOR_USE_LIBURING
+    class IoUringQueue;
+#endif
+
+    namespace Detail {
+        struct EventQueueLimiter;
+    }
+
+    enum class QueueFullBehaviour {
+        BLOCK, // wait until the event loop made room. Never blocks the thread running the event loop, those pushes are inserted regardless.
+        FAIL, // do not insert the event, pushEvent returns PushResult::QUEUE_FULL. Pushes by the thread running the event loop are inserted regardless.
+        INSERT // ignore the limit for this event
+    };
+
+    enum class PushResult {
+        QUEUED,
+        QUEUE_FULL
+    };
+
+    enum class FdInterest : uint32_t {
+        READ = 1,
+        WRITE = 2,
+        READ_WRITE = READ | WRITE
+    };
+
+    struct FdReadiness final {
+        bool readable{};
+        bool writable{};
+        bool hangup{}; // the peer closed the connection or an error occurred, reads return 0 or fail
+    };
+
+    struct EventQueueCapacity final {
+        // maximum amount of queued events per priority. Priorities not present are unbounded.
+        unordered_map<uint64_t, uint64_t> maxEventsPerPriority{};
+        QueueFullBehaviour whenFull{QueueFullBehaviour::BLOCK};
+        // optional user-supplied overflow policy, decides per event what to do when its priority is full. Takes precedence over whenFull.
+        // Called on the pushing thread.
+        std::function<QueueFullBehaviour(Event const &)> overflowPolicy{};
+        // a QueueHighWaterMarkEvent is pushed once the total amount of queued events reaches this amount. 0 disables water mark events.
+        uint64_t highWaterMark{};
+        // a QueueLowWaterMarkEvent is pushed once the total amount of queued events drops to this amount after reaching the high water mark.
+        uint64_t lowWaterMark{};
+    };
 
     class IEventQueue {
     public:
+        IEventQueue() noexcept;
         virtual ~IEventQueue();
 
-        virtual void pushEvent(uint64_t priority, std::unique_ptr<Event> &&event) = 0;
+        /// Insert event into queue, thread-safe
+        /// \param priority lower is processed earlier
+        /// \param event
+        /// \return PushResult::QUEUE_FULL if a capacity is set and the limit for this priority is reached, depending on the QueueFullBehaviour
+        virtual PushResult pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) = 0;
+        /// Insert event stored inline into queue, thread-safe. Only supported by queues that report storesEventsInline().
+        /// \param priority lower is processed earlier
+        /// \param event
+        /// \return PushResult::QUEUE_FULL if a capacity is set and the limit for this priority is reached, depending on the QueueFullBehaviour
+        virtual PushResult pushInlineEvent(uint64_t priority, EventStackUniquePtr &&event);
+        /// Insert event sent by another manager, thread-safe. Queues with a mailbox put it there without taking a lock, the thread running the event loop moves mailbox events into the queue in batches.
+        /// If the event loop is sleeping and the mailbox is empty, they insert it like pushEvent() does, as waking up the event loop takes the lock anyway.
+        /// Queues without a mailbox insert it like pushEvent() does.
+        /// \param priority lower is processed earlier
+        /// \param event
+        /// \return PushResult::QUEUE_FULL if a capacity is set and the limit for this priority is reached, depending on the QueueFullBehaviour
+        virtual PushResult pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event);
+        /// Insert event into queue once deadline has passed, thread-safe. Events with deadlines in the same TimerWheel::TICK are inserted together.
+        /// Capacity is reserved when pushing, a delayed event counts as queued while it waits for its deadline.
+        /// \param deadline
+        /// \param priority lower is processed earlier
+        /// \param event
+        /// \return PushResult::QUEUE_FULL if a capacity is set and the limit for this priority is reached, depending on the QueueFullBehaviour
+        virtual PushResult pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event);
+
+        /// Watch a file descriptor for readiness. Only supported by queues that report supportsFds(). Only call from the thread running the event loop.
+        /// Watches are level-triggered: onReady keeps getting called as long as the fd is ready for the interest, so drain it or change the interest.
+        /// \param fd non-blocking file descriptor, not owned by the queue. Remove the watch before closing it.
+        /// \param interest
+        /// \param onReady called on the thread running the event loop, in between events
+        /// \return id of the watch, used to modify or remove it
+        virtual uint64_t addFd(int fd, FdInterest interest, std::function<void(FdReadiness)> onReady);
+        /// Only call from the thread running the event loop
+        /// \param id watch returned by addFd()
+        /// \param interest
+        virtual void modifyFd(uint64_t id, FdInterest interest);
+        /// Only call from the thread running the event loop. onReady is not called anymore after this returns, it may be called from within onReady itself.
+        /// \param id watch returned by addFd()
+        virtual void removeFd(uint64_t id);
 
         [[nodiscard]] virtual bool empty() const = 0;
         [[nodiscard]] virtual uint64_t size() const = 0;
         virtual void start(bool captureSigInt) = 0;
         DependencyManager& createManager();
 
+        /// Limit the amount of queued events. Not thread-safe, set before pushing events and before starting the queue, throws otherwise.
+        /// Events of the framework itself, like QuitEvents, water mark events and the events starting services and continuing coroutines, are never limited nor counted.
+        /// Neither are events pushed by the thread running the event loop or by its worker threads.
+        /// \param capacity
+        void setCapacity(EventQueueCapacity capacity);
+        /// \return true if the high water mark has been reached and the low water mark has not been reached since
+        [[nodiscard]] bool isAboveHighWaterMark() const noexcept;
+        /// \return true if events that fit in an EventStackUniquePtr should be pushed as such, instead of being allocated
+        [[nodiscard]] bool storesEventsInline() const noexcept {
+            return _storesEventsInline;
+        }
+        /// \return true if the queue can watch file descriptors with addFd()
+        [[nodiscard]] virtual bool supportsFds() const noexcept {
+            return false;
+        }
+#ifdef ICHOR_USE_LIBURING
+        /// Ichor is built without RTTI, so services use this instead of a dynamic_cast to submit io_uring operations
+        /// \return this queue if it is an IoUringQueue, nullptr otherwise
+        [[nodiscard]] virtual IoUringQueue* getIoUringQueue() noexcept {
+            return nullptr;
+        }
+#endif
+
     protected:
         friend class DependencyManager;
+        explicit IEventQueue(bool storesEventsInline) noexcept;
         [[nodiscard]] virtual bool shouldQuit() = 0;
         virtual void quit() = 0;
         void startDm();
-        void processEvent(std::unique_ptr<Event> &&evt);
+        void processEvent(std::unique_ptr<Event, EventDeleter> &&evt);
         void stopDm();
+        /// Thread-safe
+        /// \return true if the timeout set with DependencyManager::setShutdownTimeout() passed since the first QuitEvent
+        [[nodiscard]] bool shutdownTimedOut() const noexcept;
+
+        /// Implementations have to call this before inserting an event. May block the calling thread.
+        /// \param event
+        /// \return false if the event should not be inserted
+        [[nodiscard]] bool reserveCapacity(Event const &event);
+        /// Implementations have to call this for every event that got reserved, once it has been taken out of the queue and before processing it.
+        /// \param event
+        void releaseCapacity(Event const &event);
+
+        /// For queues implementing pushMailboxEvent() with the mailbox. Reserves capacity and adds the event to the mailbox, lock-free unless the producer has to wait for capacity.
+        /// The implementation still has to wake up the event loop if it waits for events.
+        /// \param priority
+        /// \param event
+        /// \return PushResult::QUEUE_FULL if a capacity is set and the limit for this priority is reached, depending on the QueueFullBehaviour
+        [[nodiscard]] PushResult pushToMailbox(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event);
+        /// Thread-safe, sequentially consistent so that a consumer about to sleep either sees the event or the producer sees the consumer sleeping
+        /// \return amount of events in the mailbox, including those whose producer did not finish pushing yet
+        [[nodiscard]] uint64_t mailboxSize() const noexcept {
+            return _mailboxSize.load(std::memory_order_seq_cst);
+        }
+        /// Only call from the thread running the event loop. Takes the events out of the mailbox in the order they were pushed.
+        /// \param insert called as insert(priority, event) for every event
+        /// \return amount of events taken out
+        template <typename InsertT>
+        uint64_t drainMailbox(InsertT &&insert) {
+            MailboxEvent mailboxEvent{};
+            uint64_t count{};
+            while(_mailbox.pop(mailboxEvent)) {
+                _mailboxSize.fetch_sub(1, std::memory_order_acq_rel);
+                insert(mailboxEvent.priority, std::move(mailboxEvent.event));
+                count++;
+            }
+            return count;
+        }
+
+        /// For queues implementing pushDelayedEvent(). Reserves capacity and adds the event to the timer mailbox, lock-free unless the producer has to wait for capacity.
+        /// The implementation still has to wake up the event loop if it waits for events, so that it picks up the new deadline.
+        /// \param deadline
+        /// \param priority
+        /// \param event
+        /// \return PushResult::QUEUE_FULL if a capacity is set and the limit for this priority is reached, depending on the QueueFullBehaviour
+        [[nodiscard]] PushResult pushToTimerMailbox(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event);
+        /// Thread-safe, sequentially consistent for the same reason as mailboxSize()
+        /// \return amount of delayed events pushed but not yet moved into the timer wheel
+        [[nodiscard]] uint64_t timerMailboxSize() const noexcept {
+            return _timerMailboxSize.load(std::memory_order_seq_cst);
+        }
+        /// Only call from the thread running the event loop. Moves the timer mailbox into the timer wheel and takes out all delayed events whose deadline has passed, as one batch.
+        /// \param insert called as insert(priority, event) for every expired event
+        /// \return amount of events taken out
+        template <typename InsertT>
+        uint64_t expireTimers(InsertT &&insert) {
+            TimerMailboxEvent timerEvent{};
+            while(_timerMailbox.pop(timerEvent)) {
+                _timerMailboxSize.fetch_sub(1, std::memory_order_acq_rel);
+                _timerWheel.insert(timerEvent.deadline, timerEvent.priority, std::move(timerEvent.event));
+            }
+
+            if(_timerWheel.empty()) {
+                return 0;
+            }
+
+            return _timerWheel.advance(std::chrono::steady_clock::now(), insert);
+        }
+        /// Only call from the thread running the event loop
+        /// \param maxWait
+        /// \return how long the event loop may sleep before expireTimers() has work to do, at most maxWait
+        [[nodiscard]] std::chrono::nanoseconds timeUntilNextTimer(std::chrono::nanoseconds maxWait) const noexcept;
+        /// Drops the events left in the mailboxes and timer wheel, then destroys the manager and its services. Done by the destructor of IEventQueue.
+        /// Implementations whose members have to outlive the services can call this earlier, after dropping the events they queued themselves, as those may use the allocator of the manager.
+        void destroyDm() noexcept;
 
         std::unique_ptr<DependencyManager> _dm;
+        std::unique_ptr<Detail::EventQueueLimiter> _limiter;
+        const bool _storesEventsInline{};
+
+    private:
+        struct MailboxEvent final {
+            uint64_t priority{};
+            std::unique_ptr<Event, EventDeleter> event{};
+        };
+
+        struct TimerMailboxEvent final {
+            std::chrono::steady_clock::time_point deadline{};
+            uint64_t priority{};
+            std::unique_ptr<Event, EventDeleter> event{};
+        };
+
+        MpscQueue<MailboxEvent> _mailbox{};
+        std::atomic<uint64_t> _mailboxSize{};
+        MpscQueue<TimerMailboxEvent> _timerMailbox{};
+        std::atomic<uint64_t> _timerMailboxSize{};
+        Detail::TimerWheel _timerWheel{};
     };
 
     inline constexpr bool DoNotCaptureSigInt = false;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <ichor/stl/RealtimeMutex.h>
+#include <ichor/stl/ConditionVariable.h>
+#include <ichor/stl/EventStackUniquePtr.h>
+#include <ichor/event_queues/IEventQueue.h>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <limits>
+
+namespace Ichor {
+    class DependencyManager;
+
+    /// Event queue that stores events inline in contiguous slots instead of allocating them.
+    /// Slots are allocated in chunks that never move, so events are processed straight from their slot and stay there while a handler is suspended.
+    /// Events that do not fit in a slot (see EventStackUniquePtr::fitsInline) are allocated as usual.
+    /// Events are ordered by priority and in FIFO order within a priority, like the MultimapQueue.
+    class InlineEventQueue final : public IEventQueue, public IEventStorage {
+    public:
+        /// \param slotsPerChunk amount of slots allocated at once when all slots are in use
+        explicit InlineEventQueue(uint32_t slotsPerChunk = 1024);
+        ~InlineEventQueue() final;
+
+        PushResult pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushInlineEvent(uint64_t priority, EventStackUniquePtr &&event) final;
+        PushResult pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+
+        [[nodiscard]] bool empty() const noexcept final;
+        [[nodiscard]] uint64_t size() const noexcept final;
+
+        void start(bool captureSigInt) final;
+        [[nodiscard]] bool shouldQuit() final;
+        void quit() final;
+
+    private:
+        static constexpr uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+
+        struct QueuedEvent final {
+            uint64_t priority;
+            uint64_t sequence; // keeps events with the same priority in FIFO order
+            uint32_t slot; // NO_SLOT if the event is stored in heapEvent
+            std::unique_ptr<Event, EventDeleter> heapEvent;
+        };
+
+        // assume _eventQueueMutex is locked
+        void insert(QueuedEvent &&event);
+        [[nodiscard]] uint32_t acquireSlot();
+        [[nodiscard]] EventStackUniquePtr& slotAt(uint32_t slot) noexcept;
+        void release(Event *evt, uint32_t slot) noexcept final;
+        // assume _eventQueueMutex is locked, returns the amount of events moved into the queue
+        uint64_t moveMailboxEvents();
+        // assume _eventQueueMutex is locked, returns the amount of events moved into the queue
+        uint64_t moveExpiredTimers();
+        void wakeSleepingConsumer();
+        void shouldAddQuitEvent();
+
+        uint32_t _slotsPerChunk;
+        std::vector<std::unique_ptr<EventStackUniquePtr[]>> _chunks{};
+        std::vector<uint32_t> _freeSlots{};
+        std::vector<QueuedEvent> _eventQueue{}; // binary heap, lowest priority/sequence on top
+        uint64_t _sequence{};
+        mutable RealtimeMutex _eventQueueMutex{};
+        ConditionVariable _wakeup{};
+        std::atomic<bool> _consumerSleeping{false};
+        std::atomic<bool> _quit{false};
+        bool _quitEventSent{false};
+        std::chrono::steady_clock::time_point _whenQuitEventWasSent{};
+    };
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#ifdef ICHOR_USE_LIBURING
+
+#include <ichor/DependencyManager.h>
+#include <ichor/stl/RealtimeMutex.h>
+#include <ichor/stl/SlotMap.h>
+#include <ichor/event_queues/IEventQueue.h>
+#include <liburing.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+#include <sys/socket.h>
+
+#ifdef ICHOR_USE_ABSEIL
+#include <absl/container/btree_map.h>
+#else
+#include <map>
+#endif
+
+namespace Ichor {
+    /// Event queue whose event loop owns an io_uring, so services can do their I/O on the thread of the manager without a syscall per operation.
+    /// Events are ordered by priority and in FIFO order within a priority, like the MultimapQueue.
+    /// Operations prepared in between events are submitted together, once per loop iteration, and their completions are handled in between events.
+    /// Producers on other threads wake a sleeping event loop through an eventfd.
+    /// Requires Linux 6.0 or newer for multishot receives.
+    class IoUringQueue final : public IEventQueue {
+    public:
+        /// \param entries size of the submission queue, a full submission queue is submitted early
+        /// \param maxEventsBetweenCompletions maximum amount of events processed before submitting and handling completions again
+        /// \param recvBufferCount amount of buffers shared by all multishot receives, has to be a power of 2
+        /// \param recvBufferSize size of each buffer shared by all multishot receives
+        explicit IoUringQueue(uint32_t entries = 256, uint64_t maxEventsBetweenCompletions = 64, uint32_t recvBufferCount = 256, uint32_t recvBufferSize = 4096);
+        ~IoUringQueue() final;
+
+        PushResult pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+
+        [[nodiscard]] bool empty() const noexcept final;
+        [[nodiscard]] uint64_t size() const noexcept final;
+
+        void start(bool captureSigInt) final;
+        [[nodiscard]] bool shouldQuit() final;
+        void quit() final;
+
+        [[nodiscard]] IoUringQueue* getIoUringQueue() noexcept final {
+            return this;
+        }
+
+        // All functions below may only be called from the thread running the event loop.
+        // Buffers passed to them have to stay valid until the operation completed.
+
+        /// Prepare an operation with one of the io_uring_prep_* functions of liburing and get called once it completed.
+        /// \param prepare called as prepare(io_uring_sqe&), should not throw nor set the user data of the sqe
+        /// \param onComplete called with the res and flags of the completion, on the thread running the event loop. Owns whatever the operation needs to stay alive.
+        /// \return id of the operation, used to cancel it
+        template <typename PrepareT>
+        requires std::invocable<PrepareT&, io_uring_sqe&>
+        uint64_t submit(PrepareT &&prepare, std::function<void(int32_t, uint32_t)> onComplete) {
+            if(!onComplete) {
+                throw std::runtime_error("No callback set.");
+            }
+
+            auto &sqe = getSqe();
+            prepare(sqe);
+            auto const id = _operations.insert(Operation{std::move(onComplete), -1, OperationType::SINGLE, false});
+            io_uring_sqe_set_data64(&sqe, id);
+            return id;
+        }
+
+        /// Usage: auto res = *co_await queue.recv(fd, buf).begin();
+        /// \return generator yielding the amount of bytes received, 0 if the peer closed the connection or -errno
+        AsyncGenerator<int32_t> recv(int fd, std::span<uint8_t> buf, int flags = 0);
+        /// \return generator yielding the amount of bytes sent, which may be less than the size of buf, or -errno
+        AsyncGenerator<int32_t> send(int fd, std::span<uint8_t const> buf, int flags = MSG_NOSIGNAL);
+        /// \return generator yielding the accepted socket or -errno
+        AsyncGenerator<int32_t> accept(int fd, sockaddr *addr = nullptr, socklen_t *addrLen = nullptr, int flags = SOCK_CLOEXEC);
+        /// \return generator yielding 0 when connected or -errno
+        AsyncGenerator<int32_t> connect(int fd, sockaddr const *addr, socklen_t addrLen);
+        /// \return generator yielding -ETIME once the duration passed
+        AsyncGenerator<int32_t> timeout(std::chrono::nanoseconds duration);
+
+        /// Accept connections until cancelled or an error occurs.
+        /// \param fd listening socket
+        /// \param onAccept called with every accepted socket, or once with -errno after which accepting stopped
+        /// \return id of the operation, used to cancel it
+        uint64_t multishotAccept(int fd, std::function<void(int32_t)> onAccept);
+        /// Receive into buffers owned by this queue until cancelled, the peer closed the connection or an error occurs.
+        /// \param fd connected socket
+        /// \param onRecv called with the amount of bytes and the data for every receive. Called once with 0 if the peer closed the connection or -errno, after which receiving stopped. The data is only valid during the call.
+        /// \return id of the operation, used to cancel it
+        uint64_t multishotRecv(int fd, std::function<void(int32_t, std::span<uint8_t const>)> onRecv);
+        /// The callback of the operation is not called anymore after this returns, but keeps owning its captures until the kernel finished the operation.
+        /// May be called from within the callback itself.
+        /// \param id operation returned by submit(), multishotAccept() or multishotRecv()
+        void cancel(uint64_t id);
+
+    private:
+        enum class OperationType : uint8_t {
+            SINGLE,
+            MULTISHOT_ACCEPT,
+            MULTISHOT_RECV
+        };
+
+        struct Operation final {
+            std::function<void(int32_t, uint32_t)> onComplete;
+            int fd;
+            OperationType type;
+            bool cancelled; // waiting for the kernel to finish the operation
+        };
+
+        // flushes the submission queue if it is full
+        [[nodiscard]] io_uring_sqe& getSqe();
+        void armEventFd();
+        void armMultishot(uint64_t id, int fd, OperationType type);
+        void setupRecvBuffers();
+        void returnRecvBuffer(uint32_t cqeFlags) noexcept;
+        // submit everything prepared and wait at most timeout for completions, then handle them
+        void submitAndComplete(std::chrono::nanoseconds timeout);
+        void complete(io_uring_cqe const &cqe);
+        // cancel every operation still running and wait until the kernel finished them, as their buffers are about to be destroyed
+        void cancelAllOperations() noexcept;
+        // assume _eventQueueMutex is locked
+        void moveMailboxAndTimerEvents();
+        void shouldAddQuitEvent();
+        void wakeSleepingConsumer();
+
+#ifdef ICHOR_USE_ABSEIL
+        absl::btree_multimap<uint64_t, std::unique_ptr<Event, EventDeleter>> _eventQueue{};
+#else
+        std::multimap<uint64_t, std::unique_ptr<Event, EventDeleter>> _eventQueue{};
+#endif
+        uint64_t _maxEventsBetweenCompletions;
+        mutable RealtimeMutex _eventQueueMutex{};
+        io_uring _ring{};
+        bool _ringInitialized{};
+        int _eventFd{-1};
+        uint64_t _eventFdValue{}; // read into by the kernel
+        // only accessed by the thread running the event loop
+        SlotMap<Operation> _operations{};
+        uint32_t _recvBufferCount;
+        uint32_t _recvBufferSize;
+        io_uring_buf_ring *_recvBufferRing{};
+        std::vector<uint8_t> _recvBuffers{};
+        std::atomic<bool> _consumerSleeping{false};
+        std::atomic<bool> _wakeupPending{false};
+        std::atomic<bool> _quit{false};
+        bool _quitEventSent{false};
+        std::chrono::steady_clock::time_point _whenQuitEventWasSent{};
+    };
+}
+
+#endif
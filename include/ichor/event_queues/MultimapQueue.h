@@ -4,6 +4,8 @@
 #include <ichor/stl/ConditionVariableAny.h>
 #include <ichor/event_queues/IEventQueue.h>
 #include <atomic>
+#include <vector>
+#include <limits>
 
 #ifdef ICHOR_USE_ABSEIL
 #include <absl/container/btree_map.h>
@@ -16,9 +18,14 @@ namespace Ichor {
 
     class MultimapQueue final : public IEventQueue {
     public:
+        /// \param maxBatchSize maximum amount of events taken out of the queue per lock acquisition. 1 disables batching.
+        /// \param batchOnlyHighestPriority stop the batch at the first event with a different priority than the first event
+        explicit MultimapQueue(uint64_t maxBatchSize = 1, bool batchOnlyHighestPriority = false);
         ~MultimapQueue() final;
 
-        void pushEvent(uint64_t priority, std::unique_ptr<Event> &&event) final;
+        PushResult pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
 
         [[nodiscard]] bool empty() const noexcept final;
         [[nodiscard]] uint64_t size() const noexcept final;
@@ -29,14 +36,28 @@ namespace Ichor {
 
     private:
         void shouldAddQuitEvent();
+        void processBatch();
+        // assume _eventQueueMutex is locked, returns the amount of events moved into the queue
+        uint64_t moveMailboxEvents();
+        // assume _eventQueueMutex is locked, returns the amount of events moved into the queue
+        uint64_t moveExpiredTimers();
+        void wakeSleepingConsumer();
 
 #ifdef ICHOR_USE_ABSEIL
-        absl::btree_multimap<uint64_t, std::unique_ptr<Event>> _eventQueue{};
+        absl::btree_multimap<uint64_t, std::unique_ptr<Event, EventDeleter>> _eventQueue{};
 #else
-        std::multimap<uint64_t, std::unique_ptr<Event>> _eventQueue{};
+        std::multimap<uint64_t, std::unique_ptr<Event, EventDeleter>> _eventQueue{};
 #endif
+        // only accessed by the consumer
+        std::vector<decltype(_eventQueue)::node_type> _batch{};
+        std::atomic<uint64_t> _batchRemaining{0};
+        // lowest priority pushed since the current batch was taken, only written with _eventQueueMutex locked
+        std::atomic<uint64_t> _lowestPushedPriority{std::numeric_limits<uint64_t>::max()};
+        uint64_t _maxBatchSize;
+        bool _batchOnlyHighestPriority;
         mutable Ichor::RealtimeReadWriteMutex _eventQueueMutex{};
         ConditionVariableAny<RealtimeReadWriteMutex> _wakeup{};
+        std::atomic<bool> _consumerSleeping{false};
         std::atomic<bool> _quit{false};
         bool _quitEventSent{false};
         std::chrono::steady_clock::time_point _whenQuitEventWasSent{};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ichor/stl/MpscQueue.h>
+#include <ichor/stl/RealtimeMutex.h>
+#include <ichor/stl/ConditionVariable.h>
+#include <ichor/event_queues/IEventQueue.h>
+#include <atomic>
+#include <vector>
+#include <limits>
+#include <chrono>
+
+namespace Ichor {
+    class DependencyManager;
+
+    // Upper bounds (inclusive) of the default priority bands. Every priority used internally by Ichor gets a band of its own,
+    // so that e.g. the DependencyOfflineEvent at INTERNAL_DEPENDENCY_EVENT_PRIORITY - 1 is still handled before StopServiceEvents.
+    inline const std::vector<uint64_t> DefaultPriorityBands{
+        INTERNAL_DEPENDENCY_EVENT_PRIORITY - 2,
+        INTERNAL_DEPENDENCY_EVENT_PRIORITY - 1,
+        INTERNAL_DEPENDENCY_EVENT_PRIORITY,
+        INTERNAL_EVENT_PRIORITY - 1,
+        INTERNAL_EVENT_PRIORITY,
+        INTERNAL_EVENT_PRIORITY + 1,
+        std::numeric_limits<uint64_t>::max()
+    };
+
+    /// Event queue with a fixed set of priority bands, each backed by a lock-free multi-producer single-consumer FIFO.
+    /// Pushing and popping events never takes a lock, only an idle consumer sleeps on a condition variable.
+    /// Events are processed from the band with the lowest priority value first and in FIFO order within a band.
+    /// Different priority values that map to the same band are therefore not re-ordered amongst each other.
+    class PriorityBandQueue final : public IEventQueue {
+    public:
+        /// \param bandUpperBounds sorted list of inclusive upper bounds of the priority bands. The last bound is always extended to the maximum priority.
+        explicit PriorityBandQueue(std::vector<uint64_t> bandUpperBounds = DefaultPriorityBands);
+        ~PriorityBandQueue() final;
+
+        PushResult pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+
+        [[nodiscard]] bool empty() const noexcept final;
+        [[nodiscard]] uint64_t size() const noexcept final;
+
+        void start(bool captureSigInt) final;
+        [[nodiscard]] bool shouldQuit() final;
+        void quit() final;
+
+    private:
+        [[nodiscard]] uint64_t bandFor(uint64_t priority) const noexcept;
+        [[nodiscard]] bool popEvent(std::unique_ptr<Event, EventDeleter> &event);
+        void shouldAddQuitEvent();
+        void wakeConsumer();
+        // only called by the consumer, returns the amount of events moved into the bands
+        uint64_t moveExpiredTimers();
+
+        std::vector<uint64_t> _bandUpperBounds;
+        std::unique_ptr<MpscQueue<std::unique_ptr<Event, EventDeleter>>[]> _bands;
+        alignas(64) std::atomic<uint64_t> _size{0};
+        alignas(64) std::atomic<bool> _consumerSleeping{false};
+        RealtimeMutex _wakeupMutex{};
+        ConditionVariable _wakeup{};
+        std::atomic<bool> _quit{false};
+        bool _quitEventSent{false};
+        std::chrono::steady_clock::time_point _whenQuitEventWasSent{};
+    };
+}
\ No newline at end of file
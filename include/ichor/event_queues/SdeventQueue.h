@@ -8,6 +8,7 @@
 #include <ichor/event_queues/IEventQueue.h>
 #include <systemd/sd-event.h>
 #include <atomic>
+#include <chrono>
 #include <thread>
 
 namespace Ichor {
@@ -16,7 +17,8 @@ namespace Ichor {
         SdeventQueue();
         ~SdeventQueue() final;
 
-        void pushEvent(uint64_t priority, std::unique_ptr<Event> &&event) final;
+        PushResult pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
+        PushResult pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) final;
 
         [[nodiscard]] bool empty() const final;
         [[nodiscard]] uint64_t size() const final;
@@ -31,6 +33,11 @@ namespace Ichor {
     private:
         void registerEventFd();
         void registerTimer();
+        void registerTimerWheel();
+        // insert an event of which the capacity has already been reserved
+        void insertEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event);
+        // only called from the thread running the loop. Inserts expired delayed events and arms _timerWheelSource for the next deadline.
+        void expireTimersAndRearm();
 
         mutable Ichor::RealtimeReadWriteMutex _eventQueueMutex{};
         sd_event* _eventQueue{};
@@ -40,6 +47,7 @@ namespace Ichor {
         std::thread::id _threadId{};
         sd_event_source *_eventfdSource{nullptr};
         sd_event_source *_timerSource{nullptr};
+        sd_event_source *_timerWheelSource{nullptr};
     };
 }
 
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <ichor/events/EventAllocator.h>
+
+// Hierarchical timing wheel, as described by Varghese and Lauck. Only used by the thread running the event loop.
+// Time is divided in ticks of TICK. Level 0 has a slot per tick for the next SLOTS ticks, every next level has slots that are SLOTS times as wide.
+// Once the wheel reaches the start of a slot on a higher level, its timers cascade down to the lower levels, so inserting and expiring a timer is O(1).
+// Deadlines are rounded up to the next tick, timers that end up in the same tick expire together.
+namespace Ichor::Detail {
+    class TimerWheel final {
+    public:
+        static constexpr std::chrono::nanoseconds TICK = std::chrono::milliseconds(1);
+        static constexpr uint64_t SLOT_BITS = 6;
+        static constexpr uint64_t SLOTS = 1 << SLOT_BITS;
+        static constexpr uint64_t LEVELS = 4;
+
+        explicit TimerWheel(std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now()) noexcept : _origin(origin) {}
+
+        TimerWheel(const TimerWheel&) = delete;
+        TimerWheel(TimerWheel&&) = delete;
+        TimerWheel& operator=(const TimerWheel&) = delete;
+        TimerWheel& operator=(TimerWheel&&) = delete;
+
+        /// \param deadline the event expires on the first advance() at or after deadline
+        /// \param priority
+        /// \param event
+        void insert(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event);
+
+        /// Expire all timers with a deadline up to now, in order of deadline tick and in insertion order within a tick
+        /// \param now
+        /// \param expire called as expire(priority, event) for every expired timer
+        /// \return amount of expired timers
+        template <typename ExpireT>
+        uint64_t advance(std::chrono::steady_clock::time_point now, ExpireT &&expire) {
+            uint64_t count{};
+
+            if(!_overdue.empty()) {
+                count += expireEntries(_overdue, expire);
+            }
+
+            uint64_t const nowTick = tickAt(now);
+            while(_currentTick < nowTick) {
+                // skip the ticks without anything to cascade or expire
+                auto const nextTick = nextWorkTick();
+                if(!nextTick || *nextTick > nowTick) {
+                    _currentTick = nowTick;
+                    break;
+                }
+
+                _currentTick = *nextTick;
+                cascade();
+                auto &slot = _slots[0][_currentTick & (SLOTS - 1)];
+                if(!slot.empty()) {
+                    count += expireEntries(slot, expire);
+                }
+            }
+
+            return count;
+        }
+
+        /// \return the earliest time at which advance() has work to do, either expiring or cascading timers. Empty if there are no timers.
+        [[nodiscard]] std::optional<std::chrono::steady_clock::time_point> nextDeadline() const noexcept;
+
+        /// Remove all timers without expiring them
+        void clear() noexcept;
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        [[nodiscard]] uint64_t size() const noexcept {
+            return _size;
+        }
+
+    private:
+        struct Entry final {
+            uint64_t tick;
+            uint64_t priority;
+            std::unique_ptr<Event, EventDeleter> event;
+        };
+
+        // first tick starting at or after tp
+        [[nodiscard]] uint64_t deadlineTick(std::chrono::steady_clock::time_point tp) const noexcept;
+        // tick containing tp
+        [[nodiscard]] uint64_t tickAt(std::chrono::steady_clock::time_point tp) const noexcept;
+        // first tick after _currentTick at which a slot expires or cascades
+        [[nodiscard]] std::optional<uint64_t> nextWorkTick() const noexcept;
+        // put the entry in the slot matching its distance to _currentTick, entry.tick has to be >= _currentTick
+        void place(Entry &&entry);
+        // move the timers of every higher level slot that starts at _currentTick down
+        void cascade();
+
+        template <typename ExpireT>
+        uint64_t expireEntries(std::vector<Entry> &entries, ExpireT &expire) {
+            // the callback never touches the wheel, but swapping keeps the capacity of both vectors around
+            std::swap(entries, _expiring);
+            auto const count = static_cast<uint64_t>(_expiring.size());
+            _size -= count;
+            for(auto &entry : _expiring) {
+                expire(entry.priority, std::move(entry.event));
+            }
+            _expiring.clear();
+            return count;
+        }
+
+        std::chrono::steady_clock::time_point _origin;
+        uint64_t _currentTick{}; // all slots up to and including this tick have been expired
+        uint64_t _size{};
+        std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> _slots{};
+        std::vector<Entry> _overdue{}; // inserted with a deadline in a tick that has already been expired
+        std::vector<Entry> _expiring{};
+    };
+}
@@ -15,5 +15,6 @@ namespace Ichor {
         const uint64_t id;
         const uint64_t originatingService;
         const uint64_t priority;
+        uint32_t typeIndex{}; // see eventTypeIndex(), set by the DependencyManager. 0 if the event was created elsewhere, in which case it is looked up on dispatch.
     };
 }
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <ichor/events/Event.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Per DependencyManager pool for events, with slabs per size class.
+// Only the thread running the DependencyManager allocates from the pool, other threads (and events too large for any size class) use the heap.
+// Pooled events may be freed on any thread: the owning thread puts them back directly, other threads push them onto a lock-free list the owner reclaims in bulk.
+namespace Ichor {
+    class DependencyManager;
+
+    namespace Detail {
+        thread_local extern DependencyManager *_local_dm;
+    }
+
+    // Implemented by everything that provides memory for events other than the heap, so that EventDeleter can give the memory back.
+    class IEventStorage {
+    public:
+        virtual ~IEventStorage() = default;
+
+        /// Destroy the event and reuse its memory, thread-safe
+        /// \param evt
+        /// \param index storage specific location of the event
+        virtual void release(Event *evt, uint32_t index) noexcept = 0;
+    };
+
+    struct EventDeleter final {
+        EventDeleter() noexcept = default;
+        EventDeleter(IEventStorage *_storage, uint32_t _index) noexcept : storage(_storage), index(_index) {}
+        // allows std::unique_ptr<DerivedEvent> to convert into std::unique_ptr<Event, EventDeleter>
+        template <typename T>
+        EventDeleter(std::default_delete<T> const &) noexcept {}
+
+        void operator()(Event *evt) const noexcept {
+            if(storage == nullptr) {
+                delete evt;
+                return;
+            }
+
+            storage->release(evt, index);
+        }
+
+        IEventStorage *storage{}; // nullptr for events on the heap
+        uint32_t index{};
+    };
+
+    class EventAllocator final : public IEventStorage {
+    public:
+        static constexpr std::array<uint32_t, 3> SIZE_CLASSES{64, 128, 256};
+        static constexpr uint32_t EVENTS_PER_SLAB = 256;
+
+        explicit EventAllocator(DependencyManager const *owner) noexcept : _owner(owner) {}
+
+        ~EventAllocator() final = default;
+
+        EventAllocator(const EventAllocator&) = delete;
+        EventAllocator(EventAllocator&&) = delete;
+        EventAllocator& operator=(const EventAllocator&) = delete;
+        EventAllocator& operator=(EventAllocator&&) = delete;
+
+        template <typename EventT, typename... Args>
+        requires std::is_base_of_v<Event, EventT>
+        [[nodiscard]] std::unique_ptr<Event, EventDeleter> create(Args&&... args) {
+            constexpr uint32_t sizeClass = sizeClassFor(sizeof(EventT), alignof(EventT));
+            _allocations.fetch_add(1, std::memory_order_relaxed);
+
+            if constexpr (sizeClass < SIZE_CLASSES.size()) {
+                if(Detail::_local_dm == _owner) {
+                    void *mem = allocate(sizeClass);
+                    try {
+                        return std::unique_ptr<Event, EventDeleter>{new (mem) EventT(std::forward<Args>(args)...), EventDeleter{this, sizeClass}};
+                    } catch(...) {
+                        deallocate(mem, sizeClass);
+                        throw;
+                    }
+                }
+            }
+
+            _heapAllocations.fetch_add(1, std::memory_order_relaxed);
+            return std::unique_ptr<Event, EventDeleter>{new EventT(std::forward<Args>(args)...)};
+        }
+
+        void release(Event *evt, uint32_t sizeClass) noexcept final {
+            evt->~Event();
+            deallocate(evt, sizeClass);
+        }
+
+        /// Return memory of a pooled event to its size class, thread-safe
+        /// \param mem
+        /// \param sizeClass
+        void deallocate(void *mem, uint32_t sizeClass) noexcept {
+            auto *node = new (mem) FreeNode{};
+            auto &freeList = _freeLists[sizeClass];
+
+            if(Detail::_local_dm == _owner) {
+                node->next = freeList.local;
+                freeList.local = node;
+                return;
+            }
+
+            node->next = freeList.remote.load(std::memory_order_relaxed);
+            while(!freeList.remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+
+        /// \return total amount of events created through this allocator
+        [[nodiscard]] uint64_t allocations() const noexcept {
+            return _allocations.load(std::memory_order_relaxed);
+        }
+
+        /// \return amount of heap allocations done for events: slabs plus events that could not be pooled
+        [[nodiscard]] uint64_t heapAllocations() const noexcept {
+            return _heapAllocations.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct FreeNode final {
+            FreeNode *next;
+        };
+
+        struct FreeList final {
+            FreeNode *local{}; // owner thread only
+            std::atomic<FreeNode*> remote{}; // pushed by other threads, taken as a whole by the owner thread
+            std::vector<std::unique_ptr<std::byte[]>> slabs{}; // owner thread only
+        };
+
+        [[nodiscard]] static constexpr uint32_t sizeClassFor(std::size_t size, std::size_t alignment) noexcept {
+            if(alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return SIZE_CLASSES.size();
+            }
+
+            uint32_t sizeClass = 0;
+            while(sizeClass < SIZE_CLASSES.size() && SIZE_CLASSES[sizeClass] < size) {
+                sizeClass++;
+            }
+            return sizeClass;
+        }
+
+        // owner thread only
+        [[nodiscard]] void* allocate(uint32_t sizeClass) {
+            auto &freeList = _freeLists[sizeClass];
+
+            if(freeList.local == nullptr) {
+                freeList.local = freeList.remote.exchange(nullptr, std::memory_order_acquire);
+            }
+
+            if(freeList.local == nullptr) {
+                auto const size = SIZE_CLASSES[sizeClass];
+                auto &slab = freeList.slabs.emplace_back(new std::byte[static_cast<std::size_t>(size) * EVENTS_PER_SLAB]);
+                _heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+                for(uint32_t i = EVENTS_PER_SLAB; i > 0; i--) {
+                    freeList.local = new (slab.get() + static_cast<std::size_t>(size) * (i - 1)) FreeNode{freeList.local};
+                }
+            }
+
+            FreeNode *node = freeList.local;
+            freeList.local = node->next;
+            return node;
+        }
+
+        DependencyManager const *_owner;
+        std::array<FreeList, SIZE_CLASSES.size()> _freeLists{};
+        std::atomic<uint64_t> _allocations{};
+        std::atomic<uint64_t> _heapAllocations{};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+// Dense indices for event types, so data per event type can be stored in flat arrays instead of maps keyed on Event::type.
+// Indices are handed out in order of first use, starting at 1. 0 is never handed out and means "no specific event type".
+namespace Ichor {
+    namespace Detail {
+        /// Thread-safe. Registering the same type multiple times, e.g. from different shared libraries, returns the same index.
+        /// \param type Event::type
+        /// \return dense index for type
+        [[nodiscard]] uint32_t registerEventType(uint64_t type);
+
+        /// Thread-safe
+        /// \param type Event::type
+        /// \return dense index for type or 0 if type is not registered
+        [[nodiscard]] uint32_t findEventTypeIndex(uint64_t type) noexcept;
+    }
+
+    /// Registers EventT on first use, subsequent calls only check a local static
+    /// \tparam EventT type of event (has to derive from Event)
+    /// \return dense index for EventT
+    template <typename EventT>
+    [[nodiscard]] uint32_t eventTypeIndex() {
+        static const uint32_t index = Detail::registerEventType(EventT::TYPE);
+        return index;
+    }
+}
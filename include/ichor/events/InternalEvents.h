@@ -5,6 +5,8 @@
 #include <ichor/Dependency.h>
 #include <ichor/Callbacks.h>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace Ichor {
     struct DependencyOnlineEvent final : public Event {
@@ -73,6 +75,34 @@ namespace Ichor {
         static constexpr std::string_view NAME = typeName<StartServiceEvent>();
     };
 
+    // The batch events below are pushed instead of one event per service when services are created in bulk, see DependencyManager::createServiceManagers()
+    struct DependencyOnlineBatchEvent final : public Event {
+        DependencyOnlineBatchEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::vector<uint64_t> _serviceIds) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), serviceIds(std::move(_serviceIds)) {}
+        ~DependencyOnlineBatchEvent() final = default;
+
+        const std::vector<uint64_t> serviceIds;
+        static constexpr uint64_t TYPE = typeNameHash<DependencyOnlineBatchEvent>();
+        static constexpr std::string_view NAME = typeName<DependencyOnlineBatchEvent>();
+    };
+
+    struct DependencyRequestBatchEvent final : public Event {
+        DependencyRequestBatchEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::vector<uint64_t> _serviceIds) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), serviceIds(std::move(_serviceIds)) {}
+        ~DependencyRequestBatchEvent() final = default;
+
+        const std::vector<uint64_t> serviceIds; // services whose registered dependencies are requested
+        static constexpr uint64_t TYPE = typeNameHash<DependencyRequestBatchEvent>();
+        static constexpr std::string_view NAME = typeName<DependencyRequestBatchEvent>();
+    };
+
+    struct StartServiceBatchEvent final : public Event {
+        StartServiceBatchEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::vector<std::pair<uint64_t, uint64_t>> _services) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), services(std::move(_services)) {}
+        ~StartServiceBatchEvent() final = default;
+
+        const std::vector<std::pair<uint64_t, uint64_t>> services; // first = originating service of the separate StartServiceEvent, second = service to start
+        static constexpr uint64_t TYPE = typeNameHash<StartServiceBatchEvent>();
+        static constexpr std::string_view NAME = typeName<StartServiceBatchEvent>();
+    };
+
     struct RemoveServiceEvent final : public Event {
         RemoveServiceEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _serviceId, bool _dependenciesStopped = false) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), serviceId(_serviceId), dependenciesStopped(_dependenciesStopped) {}
         ~RemoveServiceEvent() final = default;
@@ -146,4 +176,22 @@ namespace Ichor {
         static constexpr uint64_t TYPE = typeNameHash<RecoverableErrorEvent>();
         static constexpr std::string_view NAME = typeName<RecoverableErrorEvent>();
     };
+
+    struct QueueHighWaterMarkEvent final : public Event {
+        QueueHighWaterMarkEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _queuedEvents) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), queuedEvents(_queuedEvents) {}
+        ~QueueHighWaterMarkEvent() final = default;
+
+        const uint64_t queuedEvents;
+        static constexpr uint64_t TYPE = typeNameHash<QueueHighWaterMarkEvent>();
+        static constexpr std::string_view NAME = typeName<QueueHighWaterMarkEvent>();
+    };
+
+    struct QueueLowWaterMarkEvent final : public Event {
+        QueueLowWaterMarkEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _queuedEvents) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), queuedEvents(_queuedEvents) {}
+        ~QueueLowWaterMarkEvent() final = default;
+
+        const uint64_t queuedEvents;
+        static constexpr uint64_t TYPE = typeNameHash<QueueLowWaterMarkEvent>();
+        static constexpr std::string_view NAME = typeName<QueueLowWaterMarkEvent>();
+    };
 }
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <ichor/events/Event.h>
+#include <ichor/ConstevalHash.h>
+#include <memory>
+
+namespace Ichor {
+    /// Refers to an immutable payload shared by all managers the event was sent to, see CommunicationChannel::broadcastSharedPayload()
+    template <typename PayloadT>
+    struct SharedPayloadEvent final : public Event {
+        SharedPayloadEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::shared_ptr<PayloadT const> _payload) noexcept : Event(TYPE, NAME, _id, _originatingService, _priority), payload(std::move(_payload)) {}
+        ~SharedPayloadEvent() final = default;
+
+        std::shared_ptr<PayloadT const> payload;
+        static constexpr uint64_t TYPE = typeNameHash<SharedPayloadEvent<PayloadT>>();
+        static constexpr std::string_view NAME = typeName<SharedPayloadEvent<PayloadT>>();
+    };
+}
@@ -1,34 +1,69 @@
 #pragma once
 
 #include <ichor/events/Event.h>
+#include <ichor/stl/BufferPool.h>
+#include <mutex>
+#include <span>
+#include <vector>
 
 namespace Ichor {
     struct NetworkDataEvent final : public Event {
         explicit NetworkDataEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, std::vector<uint8_t>&& data) noexcept :
                 Event(TYPE, NAME, _id, _originatingService, _priority), _data(std::forward<std::vector<uint8_t>>(data)), _movedFrom(false) {}
+        explicit NetworkDataEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, BufferSlice data) noexcept :
+                Event(TYPE, NAME, _id, _originatingService, _priority), _slice(std::move(data)), _movedFrom(false) {}
         ~NetworkDataEvent() final = default;
 
         static constexpr uint64_t TYPE = typeNameHash<NetworkDataEvent>();
         static constexpr std::string_view NAME = typeName<NetworkDataEvent>();
 
-        std::vector<uint8_t>& getData() const {
+        /// Does not copy, valid for as long as the event is
+        /// \return the received bytes
+        [[nodiscard]] std::span<uint8_t const> getBytes() const {
             if(_movedFrom) {
                 throw std::runtime_error("already moved from");
             }
 
-            return _data;
+            if(!_slice.empty()) {
+                return _slice.span();
+            }
+
+            return {_data.data(), _data.size()};
         }
 
-        std::vector<uint8_t> moveData() {
+        /// Keeping (a copy of) the slice keeps the pooled buffer it views alive, without copying the bytes.
+        /// \return the received bytes if they were received into a pooled buffer, an empty slice otherwise
+        [[nodiscard]] BufferSlice const& getSlice() const noexcept {
+            return _slice;
+        }
+
+        /// Events received into a pooled buffer should be consumed through getBytes() or getSlice().
+        /// For those, the first call copies the bytes into a vector kept by the event, the slice stays untouched for other handlers.
+        std::vector<uint8_t>& getData() const {
             if(_movedFrom) {
                 throw std::runtime_error("already moved from");
             }
 
+            if(!_slice.empty()) {
+                // worker handlers of different services may ask at the same time
+                std::call_once(_copyOnce, [this]() {
+                    _data.assign(_slice.begin(), _slice.end());
+                });
+            }
+
+            return _data;
+        }
+
+        /// Events received into a pooled buffer should be consumed through getBytes() or getSlice(), this copies the bytes out of the buffer.
+        std::vector<uint8_t> moveData() {
+            auto &data = getData();
             _movedFrom = true;
-            return std::move(_data);
+            return std::move(data);
         }
     private:
-        mutable std::vector<uint8_t> _data;
+        mutable std::vector<uint8_t> _data{};
+        BufferSlice _slice{};
+        mutable std::once_flag _copyOnce{};
         mutable bool _movedFrom;
     };
 
@@ -43,4 +78,15 @@ namespace Ichor {
         mutable std::vector<uint8_t> data;
         uint64_t msgId;
     };
+
+    struct SentMessageEvent final : public Event {
+        explicit SentMessageEvent(uint64_t _id, uint64_t _originatingService, uint64_t _priority, uint64_t _msgId) noexcept :
+        Event(TYPE, NAME, _id, _originatingService, _priority), msgId(_msgId) {}
+        ~SentMessageEvent() final = default;
+
+        static constexpr uint64_t TYPE = typeNameHash<SentMessageEvent>();
+        static constexpr std::string_view NAME = typeName<SentMessageEvent>();
+
+        uint64_t msgId;
+    };
 }
\ No newline at end of file
@@ -22,6 +22,8 @@ namespace Ichor {
         };
     }
 
+    /// Set the "ReusePort" property to let multiple HttpHostServices, each in their own DependencyManager with their own HttpContextService, listen on the same address and port.
+    /// The kernel then spreads incoming connections over them (SO_REUSEPORT).
     class HttpHostService final : public IHttpService, public Service<HttpHostService> {
     public:
         HttpHostService(DependencyRegister &reg, Properties props, DependencyManager *mng);
@@ -58,6 +60,7 @@ namespace Ichor {
         std::atomic<bool> _cleanedupStream{};
         std::atomic<int64_t> _finishedListenAndRead{};
         std::atomic<bool> _tcpNoDelay{};
+        bool _reusePort{};
         uint64_t _streamIdCounter{};
         ILogger *_logger{nullptr};
         IHttpContextService *_httpContextService{nullptr};
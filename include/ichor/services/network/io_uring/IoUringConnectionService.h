@@ -0,0 +1,67 @@
+#pragma once
+
+#ifdef ICHOR_USE_LIBURING
+
+#include <ichor/services/network/IConnectionService.h>
+#include <ichor/services/logging/Logger.h>
+#include <ichor/stl/BufferPool.h>
+#include <deque>
+#include <span>
+
+namespace Ichor {
+    class IoUringQueue;
+
+    /// TCP connection that does its I/O through the IoUringQueue running its manager, see TcpConnectionService for the properties
+    /// The kernel receives into the queue's provided buffers, which have to be given back right away, so received data is copied into a buffer from the "BufferPool" property or from its own pool
+    class IoUringConnectionService final : public IConnectionService, public Service<IoUringConnectionService> {
+    public:
+        IoUringConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng);
+        ~IoUringConnectionService() final = default;
+
+        uint64_t sendAsync(std::vector<uint8_t>&& msg) final;
+        void setPriority(uint64_t priority) final;
+        uint64_t getPriority() final;
+
+    private:
+        StartBehaviour start() final;
+        StartBehaviour stop() final;
+
+        void addDependencyInstance(ILogger *logger, IService *isvc);
+        void removeDependencyInstance(ILogger *logger, IService *isvc);
+
+        // stop receiving while the event queue is above its high water mark
+        AsyncGenerator<void> handleEvent(QueueHighWaterMarkEvent const &evt);
+        AsyncGenerator<void> handleEvent(QueueLowWaterMarkEvent const &evt);
+
+        void startReceiving();
+        // sends one message at a time, so that they arrive in order
+        void sendNext();
+        void sendRemainder(std::vector<uint8_t> &&msg, uint64_t msgId, uint64_t sent);
+        // push a FailedSendMessageEvent for the message in flight and every message left in the outbox
+        void failOutbox();
+
+        friend DependencyRegister;
+        friend DependencyManager;
+
+        int _socket;
+        int _attempts;
+        uint64_t _priority;
+        uint64_t _msgIdCounter;
+        uint64_t _recvOperation{};
+        uint64_t _sendOperation{}; // 0 if no send is in flight
+        uint64_t _sendingMsgId{};
+        std::span<uint8_t const> _sendingMsg{}; // owned by the send operation in flight
+        bool _quit;
+        bool _paused{};
+        IoUringQueue *_queue{nullptr};
+        ILogger *_logger{nullptr};
+        std::deque<std::pair<uint64_t, std::vector<uint8_t>>> _outbox{};
+        std::shared_ptr<BufferPool> _bufferPool{};
+        PooledBuffer _recvBuffer{};
+        uint64_t _recvEnd{}; // bytes of _recvBuffer copied into
+        EventHandlerRegistration _highWaterMarkHandlerRegistration{};
+        EventHandlerRegistration _lowWaterMarkHandlerRegistration{};
+    };
+}
+
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#ifdef ICHOR_USE_LIBURING
+
+#include <ichor/services/network/IHostService.h>
+#include <ichor/services/logging/Logger.h>
+#include <ichor/services/network/io_uring/IoUringConnectionService.h>
+
+namespace Ichor {
+    class IoUringQueue;
+
+    /// TCP host that accepts connections through the IoUringQueue running its manager and creates an IoUringConnectionService for each of them, see TcpHostService for the properties
+    class IoUringHostService final : public IHostService, public Service<IoUringHostService> {
+    public:
+        IoUringHostService(DependencyRegister &reg, Properties props, DependencyManager *mng);
+        ~IoUringHostService() final = default;
+
+        void setPriority(uint64_t priority) final;
+        uint64_t getPriority() final;
+
+    private:
+        StartBehaviour start() final;
+        StartBehaviour stop() final;
+
+        void addDependencyInstance(ILogger *logger, IService *isvc);
+        void removeDependencyInstance(ILogger *logger, IService *isvc);
+
+        friend DependencyRegister;
+        friend DependencyManager;
+
+        int _socket;
+        uint64_t _priority;
+        uint64_t _acceptOperation{};
+        bool _quit;
+        IoUringQueue *_queue{nullptr};
+        ILogger *_logger{nullptr};
+        std::vector<IoUringConnectionService*> _connections;
+        std::shared_ptr<BufferPool> _bufferPool{};
+    };
+}
+
+#endif
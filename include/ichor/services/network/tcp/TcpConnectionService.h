@@ -5,8 +5,18 @@
 #include <ichor/services/network/IConnectionService.h>
 #include <ichor/services/logging/Logger.h>
 #include <ichor/services/timer/TimerService.h>
+#include <ichor/stl/BufferPool.h>
+#include <deque>
 
 namespace Ichor {
+    /// Reads from the socket when it becomes readable if the event queue supports watching file descriptors (see IEventQueue::supportsFds()), polls it with a timer otherwise.
+    /// Data is received straight into buffers from a BufferPool and handed to NetworkDataEvent handlers as slices of those buffers.
+    /// Messages that don't fit in the socket's send buffer wait in an outbox until it is writable again, the outbox is written with as few sendmsg() calls as possible.
+    /// Properties:
+    /// - "BatchSends" (bool): send messages from a separate event instead of immediately, so that everything sent in between goes out together
+    /// - "ReportSentMessages" (bool): push a SentMessageEvent once a message has been completely handed to the kernel
+    /// - "CoalesceReads" (bool): push one NetworkDataEvent for everything read while draining the socket instead of one per read
+    /// - "BufferPool" (std::shared_ptr<BufferPool>): pool to receive into, to share it between connections. A small pool per connection is created otherwise.
     class TcpConnectionService final : public IConnectionService, public Service<TcpConnectionService> {
     public:
         TcpConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng);
@@ -23,15 +33,54 @@ namespace Ichor {
         void addDependencyInstance(ILogger *logger, IService *isvc);
         void removeDependencyInstance(ILogger *logger, IService *isvc);
 
+        // stop reading from the socket while the event queue is above its high water mark
+        AsyncGenerator<void> handleEvent(QueueHighWaterMarkEvent const &evt);
+        AsyncGenerator<void> handleEvent(QueueLowWaterMarkEvent const &evt);
+
+        // add, change or remove the watch on the socket depending on whether it should be read from or written to
+        void updateWatch();
+        // read until the socket would block
+        // \return false if the connection closed or failed and shouldn't be read from anymore
+        bool drainSocket();
+        // push a NetworkDataEvent for the bytes received since the last one
+        void pushReceived();
+        // write the outbox until it is empty or the socket would block
+        void flushOutbox();
+        // push a FailedSendMessageEvent for every message left in the outbox
+        void failOutbox();
+
+        struct OutboxMessage final {
+            uint64_t id;
+            std::vector<uint8_t> data;
+            uint64_t sent; // amount of bytes of data already written
+        };
+
         friend DependencyRegister;
+        friend DependencyManager;
 
         int _socket;
         int _attempts;
         uint64_t _priority;
         uint64_t _msgIdCounter;
         bool _quit;
+        bool _paused{};
+        bool _readClosed{};
+        bool _waitingForWritable{};
+        bool _batchSends{};
+        bool _reportSentMessages{};
+        bool _coalesceReads{};
         ILogger *_logger{nullptr};
+        uint64_t _fdWatch{};
+        FdInterest _watchInterest{FdInterest::READ};
+        std::deque<OutboxMessage> _outbox{};
+        std::shared_ptr<bool> _scheduledFlush{}; // only set while a flush event is pending, its flag is cleared when the service stops
+        std::shared_ptr<BufferPool> _bufferPool{};
+        PooledBuffer _recvBuffer{};
+        uint64_t _recvPushed{}; // bytes of _recvBuffer already pushed as events
+        uint64_t _recvEnd{}; // bytes of _recvBuffer received into
         Timer* _timerManager{nullptr};
+        EventHandlerRegistration _highWaterMarkHandlerRegistration{};
+        EventHandlerRegistration _lowWaterMarkHandlerRegistration{};
     };
 }
 
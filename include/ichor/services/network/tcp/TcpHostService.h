@@ -17,6 +17,11 @@ namespace Ichor {
         static constexpr std::string_view NAME = Ichor::typeName<NewSocketEvent>();
     };
 
+    /// Accepts connections when the listening socket becomes readable if the event queue supports watching file descriptors (see IEventQueue::supportsFds()), polls it with a timer otherwise
+    /// "BatchSends", "ReportSentMessages" and "CoalesceReads" are passed on to the TcpConnectionService of every accepted connection.
+    /// Accepted connections receive into one BufferPool, given as the "BufferPool" property or created by the host.
+    /// Set the "ReusePort" property to let a TcpHostService in each of multiple DependencyManagers listen on the same address and port.
+    /// The kernel then spreads incoming connections over them (SO_REUSEPORT) and each connection is handled by the manager that accepted it.
     class TcpHostService final : public IHostService, public Service<TcpHostService> {
     public:
         TcpHostService(DependencyRegister &reg, Properties props, DependencyManager *mng);
@@ -34,6 +39,20 @@ namespace Ichor {
 
         AsyncGenerator<void> handleEvent(NewSocketEvent const &evt);
 
+        enum class AcceptResult {
+            WOULD_BLOCK,
+            BACK_OFF, // e.g. out of file descriptors, the socket stays readable until that changes
+            FAILED // shouldn't be retried
+        };
+
+        // accept until the socket would block
+        AcceptResult acceptConnections();
+        void watchSocket();
+        // stop accepting for ACCEPT_BACKOFF, instead of spinning on a socket that stays readable
+        void backOff();
+
+        static constexpr auto ACCEPT_BACKOFF = std::chrono::milliseconds(100);
+
         friend DependencyRegister;
         friend DependencyManager;
 
@@ -41,9 +60,12 @@ namespace Ichor {
         int _bindFd;
         uint64_t _priority;
         bool _quit;
+        uint64_t _fdWatch{};
         ILogger *_logger{nullptr};
         Timer* _timerManager{nullptr};
+        Timer* _backoffTimer{nullptr};
         std::vector<TcpConnectionService*> _connections;
+        std::shared_ptr<BufferPool> _bufferPool{};
         EventHandlerRegistration _newSocketEventHandlerRegistration{};
     };
 }
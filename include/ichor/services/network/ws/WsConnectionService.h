@@ -3,6 +3,7 @@
 #ifdef ICHOR_USE_BOOST_BEAST
 
 #include <ichor/stl/RealtimeMutex.h>
+#include <ichor/stl/BufferPool.h>
 #include <ichor/services/network/IConnectionService.h>
 #include <ichor/services/network/IHostService.h>
 #include <ichor/services/network/http/HttpContextService.h>
@@ -22,6 +23,7 @@ using tcp = boost::asio::ip::tcp;       // from <boost/asio/ip/tcp.hpp>
 namespace Ichor {
     class WsHostService;
 
+    /// Received text messages are copied into buffers from a BufferPool, pass a std::shared_ptr<BufferPool> as the "BufferPool" property to share one between connections
     class WsConnectionService final : public IConnectionService, public Service<WsConnectionService> {
     public:
         WsConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng);
@@ -61,6 +63,7 @@ namespace Ichor {
         std::atomic<bool> _quit{};
         ILogger *_logger{nullptr};
         IHttpContextService *_httpContextService{nullptr};
+        std::shared_ptr<BufferPool> _bufferPool{};
         RealtimeMutex _mutex{};
     };
 }
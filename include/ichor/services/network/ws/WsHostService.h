@@ -48,6 +48,7 @@ namespace Ichor {
         ILogger *_logger{nullptr};
         IHttpContextService *_httpContextService{nullptr};
         std::vector<WsConnectionService*> _connections{};
+        std::shared_ptr<BufferPool> _bufferPool{BufferPool::create()}; // shared by all accepted connections
         EventHandlerRegistration _eventRegistration{};
     };
 }
@@ -1,13 +1,16 @@
 #pragma once
 
 #include <ichor/Service.h>
-#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <ichor/services/timer/ITimer.h>
 #include <ichor/events/RunFunctionEvent.h>
 
 namespace Ichor {
 
-    // Rather shoddy implementation, setting the interval does not reset the insertEventLoop function and the sleep_for is sketchy at best.
+    // Every tick is a delayed event in the timer wheel of the event queue, so timers don't need threads of their own and timers with nearby deadlines fire together.
+    // A tick pushes the callback as a RunFunctionEvent and schedules the next tick. Setting the interval takes effect from the next tick on.
     class Timer final : public ITimer, public Service<Timer> {
     public:
         Timer() noexcept = default;
@@ -30,10 +33,12 @@ namespace Ichor {
         StartBehaviour start() final;
         StartBehaviour stop() final;
 
-        void insertEventLoop(bool fireImmediately);
+        void scheduleTick(uint64_t generation);
 
         std::atomic<uint64_t> _intervalNanosec{1'000'000'000};
-        std::unique_ptr<std::thread> _eventInsertionThread{};
+        std::chrono::steady_clock::time_point _nextTick{};
+        // incremented on every start and stop, ticks of an older generation do nothing. Shared with pending ticks, which may outlive the timer.
+        std::shared_ptr<std::atomic<uint64_t>> _generation{std::make_shared<std::atomic<uint64_t>>(0)};
         decltype(RunFunctionEvent::fun) _fn{};
         std::atomic<bool> _quit{true};
         std::atomic<uint64_t> _priority{INTERNAL_EVENT_PRIORITY};
@@ -0,0 +1,300 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <span>
+#include <vector>
+#include <ichor/stl/RealtimeMutex.h>
+
+// Pool of fixed size byte buffers, meant for receiving network data without allocating per read.
+// A PooledBuffer is the writable handle a producer receives into, a BufferSlice is a read-only view on part of a buffer.
+// Both keep the buffer alive through an intrusive reference count. Once the last handle is gone, the buffer goes back to the pool it came from.
+// Handles are not thread-safe themselves, but copies of a handle may be released on any thread, acquiring from the pool is thread-safe as well.
+namespace Ichor {
+    class BufferPool;
+
+    namespace Detail {
+        struct BufferHeader final {
+            std::atomic<uint32_t> refs;
+            uint32_t capacity;
+            // only set while the buffer is in use, keeps the pool alive for as long as any of its buffers is
+            std::shared_ptr<BufferPool> pool;
+
+            [[nodiscard]] uint8_t* bytes() noexcept {
+                return reinterpret_cast<uint8_t*>(this + 1);
+            }
+        };
+        // buffers come from plain ::operator new, so that replacements of it see them as well
+        static_assert(alignof(BufferHeader) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        inline void retainBuffer(BufferHeader *buf) noexcept {
+            if(buf != nullptr) {
+                buf->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        inline void releaseBuffer(BufferHeader *buf) noexcept;
+    }
+
+    class BufferSlice final {
+    public:
+        BufferSlice() noexcept = default;
+
+        BufferSlice(const BufferSlice &o) noexcept : _buf(o._buf), _offset(o._offset), _size(o._size) {
+            Detail::retainBuffer(_buf);
+        }
+
+        BufferSlice(BufferSlice &&o) noexcept : _buf(o._buf), _offset(o._offset), _size(o._size) {
+            o._buf = nullptr;
+            o._offset = 0;
+            o._size = 0;
+        }
+
+        BufferSlice& operator=(const BufferSlice &o) noexcept {
+            if(this != &o) {
+                Detail::retainBuffer(o._buf);
+                reset();
+                _buf = o._buf;
+                _offset = o._offset;
+                _size = o._size;
+            }
+            return *this;
+        }
+
+        BufferSlice& operator=(BufferSlice &&o) noexcept {
+            if(this != &o) {
+                reset();
+                _buf = o._buf;
+                _offset = o._offset;
+                _size = o._size;
+                o._buf = nullptr;
+                o._offset = 0;
+                o._size = 0;
+            }
+            return *this;
+        }
+
+        ~BufferSlice() {
+            reset();
+        }
+
+        /// Drops this reference to the underlying buffer, the slice is empty afterwards
+        void reset() noexcept {
+            Detail::releaseBuffer(_buf);
+            _buf = nullptr;
+            _offset = 0;
+            _size = 0;
+        }
+
+        [[nodiscard]] uint8_t const* data() const noexcept {
+            return _buf == nullptr ? nullptr : _buf->bytes() + _offset;
+        }
+
+        [[nodiscard]] uint64_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        [[nodiscard]] std::span<uint8_t const> span() const noexcept {
+            return {data(), _size};
+        }
+
+        [[nodiscard]] uint8_t const* begin() const noexcept {
+            return data();
+        }
+
+        [[nodiscard]] uint8_t const* end() const noexcept {
+            return data() + _size;
+        }
+
+        /// \param offset relative to the start of this slice
+        /// \param size
+        /// \return slice of this slice sharing the same buffer, clamped to the bytes this slice views
+        [[nodiscard]] BufferSlice subSlice(uint64_t offset, uint64_t size) const noexcept {
+            if(offset >= _size) {
+                return {};
+            }
+            if(size > _size - offset) {
+                size = _size - offset;
+            }
+            Detail::retainBuffer(_buf);
+            return BufferSlice{_buf, _offset + static_cast<uint32_t>(offset), static_cast<uint32_t>(size)};
+        }
+
+    private:
+        friend class PooledBuffer;
+
+        // takes over a reference
+        BufferSlice(Detail::BufferHeader *buf, uint32_t offset, uint32_t size) noexcept : _buf(buf), _offset(offset), _size(size) {}
+
+        Detail::BufferHeader *_buf{};
+        uint32_t _offset{};
+        uint32_t _size{};
+    };
+
+    class PooledBuffer final {
+    public:
+        PooledBuffer() noexcept = default;
+
+        PooledBuffer(const PooledBuffer &) = delete;
+        PooledBuffer& operator=(const PooledBuffer &) = delete;
+
+        PooledBuffer(PooledBuffer &&o) noexcept : _buf(o._buf) {
+            o._buf = nullptr;
+        }
+
+        PooledBuffer& operator=(PooledBuffer &&o) noexcept {
+            if(this != &o) {
+                reset();
+                _buf = o._buf;
+                o._buf = nullptr;
+            }
+            return *this;
+        }
+
+        ~PooledBuffer() {
+            reset();
+        }
+
+        /// Drops the writable handle. Slices handed out before stay valid.
+        void reset() noexcept {
+            Detail::releaseBuffer(_buf);
+            _buf = nullptr;
+        }
+
+        [[nodiscard]] explicit operator bool() const noexcept {
+            return _buf != nullptr;
+        }
+
+        [[nodiscard]] uint8_t* data() noexcept {
+            return _buf == nullptr ? nullptr : _buf->bytes();
+        }
+
+        [[nodiscard]] uint64_t capacity() const noexcept {
+            return _buf == nullptr ? 0 : _buf->capacity;
+        }
+
+        /// Do not write to the viewed bytes while the slice is alive, handlers may be reading them on another thread
+        /// \param offset
+        /// \param size
+        /// \return slice sharing ownership of this buffer
+        [[nodiscard]] BufferSlice slice(uint64_t offset, uint64_t size) const noexcept {
+            if(_buf == nullptr || offset >= _buf->capacity) {
+                return {};
+            }
+            if(size > _buf->capacity - offset) {
+                size = _buf->capacity - offset;
+            }
+            Detail::retainBuffer(_buf);
+            return BufferSlice{_buf, static_cast<uint32_t>(offset), static_cast<uint32_t>(size)};
+        }
+
+    private:
+        friend class BufferPool;
+
+        // takes over a reference
+        explicit PooledBuffer(Detail::BufferHeader *buf) noexcept : _buf(buf) {}
+
+        Detail::BufferHeader *_buf{};
+    };
+
+    class BufferPool final : public std::enable_shared_from_this<BufferPool> {
+    public:
+        /// \param bufferSize capacity of every buffer
+        /// \param maxFreeBuffers amount of returned buffers kept for reuse, buffers returned beyond that are freed
+        [[nodiscard]] static std::shared_ptr<BufferPool> create(uint32_t bufferSize = 16 * 1024, uint32_t maxFreeBuffers = 64) {
+            return std::shared_ptr<BufferPool>(new BufferPool(bufferSize, maxFreeBuffers));
+        }
+
+        BufferPool(const BufferPool&) = delete;
+        BufferPool(BufferPool&&) = delete;
+        BufferPool& operator=(const BufferPool&) = delete;
+        BufferPool& operator=(BufferPool&&) = delete;
+
+        ~BufferPool() {
+            for(auto *buf : _freeBuffers) {
+                freeBuffer(buf);
+            }
+        }
+
+        /// Thread-safe. Only allocates when no returned buffer is available.
+        /// \return buffer of bufferSize() bytes
+        [[nodiscard]] PooledBuffer acquire() {
+            Detail::BufferHeader *buf{};
+            {
+                std::lock_guard const l(_mutex);
+                if(!_freeBuffers.empty()) {
+                    buf = _freeBuffers.back();
+                    _freeBuffers.pop_back();
+                }
+            }
+
+            if(buf == nullptr) {
+                void *mem = ::operator new(sizeof(Detail::BufferHeader) + _bufferSize);
+                buf = new (mem) Detail::BufferHeader{{0}, _bufferSize, nullptr};
+                _allocatedBuffers.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            buf->refs.store(1, std::memory_order_relaxed);
+            buf->pool = shared_from_this();
+            return PooledBuffer{buf};
+        }
+
+        [[nodiscard]] uint32_t bufferSize() const noexcept {
+            return _bufferSize;
+        }
+
+        /// \return amount of buffers allocated over the lifetime of this pool
+        [[nodiscard]] uint64_t allocatedBuffers() const noexcept {
+            return _allocatedBuffers.load(std::memory_order_relaxed);
+        }
+
+    private:
+        friend void Detail::releaseBuffer(Detail::BufferHeader *buf) noexcept;
+
+        BufferPool(uint32_t bufferSize, uint32_t maxFreeBuffers) : _bufferSize(bufferSize), _maxFreeBuffers(maxFreeBuffers) {
+            _freeBuffers.reserve(maxFreeBuffers);
+        }
+
+        void giveBack(Detail::BufferHeader *buf) noexcept {
+            {
+                std::lock_guard const l(_mutex);
+                if(_freeBuffers.size() < _maxFreeBuffers) {
+                    _freeBuffers.push_back(buf);
+                    return;
+                }
+            }
+            freeBuffer(buf);
+        }
+
+        static void freeBuffer(Detail::BufferHeader *buf) noexcept {
+            buf->~BufferHeader();
+            ::operator delete(buf);
+        }
+
+        uint32_t const _bufferSize;
+        uint32_t const _maxFreeBuffers;
+        std::atomic<uint64_t> _allocatedBuffers{};
+        RealtimeMutex _mutex{};
+        std::vector<Detail::BufferHeader*> _freeBuffers{};
+    };
+
+    namespace Detail {
+        inline void releaseBuffer(BufferHeader *buf) noexcept {
+            if(buf == nullptr || buf->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+
+            // the pool may only be kept alive by this buffer, so move it out before handing the buffer back
+            auto pool = std::move(buf->pool);
+            pool->giveBack(buf);
+        }
+    }
+}
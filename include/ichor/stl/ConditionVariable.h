@@ -19,6 +19,11 @@ namespace Ichor {
             pthread_cond_destroy(&_cond);
         }
 
+        void notify_one() noexcept
+        {
+            pthread_cond_signal(&_cond);
+        }
+
         void notify_all() noexcept
         {
             pthread_cond_broadcast(&_cond);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+// Vector handing out cheap read-only snapshots, meant for lists that are iterated far more often than they are modified.
+// Modifying the vector while a snapshot is alive copies the elements first, so whoever iterates the snapshot is not affected.
+// Without live snapshots, modifications happen in place. Not thread-safe.
+namespace Ichor {
+    template <typename T>
+    class CopyOnWriteVector final {
+    public:
+        using Snapshot = std::shared_ptr<const std::vector<T>>;
+
+        CopyOnWriteVector() : _elements(std::make_shared<std::vector<T>>()) {}
+
+        /// Does not copy any elements
+        /// \return elements at the moment of this call, unaffected by later modifications
+        [[nodiscard]] Snapshot snapshot() const noexcept {
+            return _elements;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _elements->empty();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return _elements->size();
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            return writableElements().emplace_back(std::forward<Args>(args)...);
+        }
+
+        /// \param pred
+        /// \return amount of erased elements
+        template <typename Pred>
+        std::size_t erase_if(Pred pred) {
+            if(std::none_of(_elements->cbegin(), _elements->cend(), pred)) {
+                return 0;
+            }
+
+            return std::erase_if(writableElements(), pred);
+        }
+
+    private:
+        [[nodiscard]] std::vector<T>& writableElements() {
+            if(_elements.use_count() > 1) {
+                _elements = std::make_shared<std::vector<T>>(*_elements);
+            }
+
+            return *_elements;
+        }
+
+        std::shared_ptr<std::vector<T>> _elements;
+    };
+}
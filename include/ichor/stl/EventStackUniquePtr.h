@@ -1,18 +1,34 @@
 #pragma once
 
-
+#include <ichor/events/Event.h>
+#include <ichor/Concepts.h>
+#include <array>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+// Owning pointer-like type that stores an event inline in a fixed size buffer, instead of on the heap.
+// Moving relocates the event with its move constructor, so only events that can be moved without throwing fit.
+// Use EventStackUniquePtr::fitsInline<T> to check whether T can be stored.
 namespace Ichor {
     class [[nodiscard]] EventStackUniquePtr final {
     public:
-        EventStackUniquePtr() = default;
+        static constexpr std::size_t INLINE_SIZE = 128;
+
+        template<typename T>
+        static constexpr bool fitsInline = sizeof(T) <= INLINE_SIZE && alignof(T) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<T>;
+
+        EventStackUniquePtr() noexcept = default;
 
         template<typename T, typename... Args>
         requires Derived<T, Event>
         static EventStackUniquePtr create(Args &&... args) {
-            static_assert(sizeof(T) <= 128, "size not big enough to hold T");
+            static_assert(fitsInline<T>, "T does not fit inline, check with fitsInline<T> first");
             static_assert(T::TYPE != 0, "type of T cannot be 0");
             EventStackUniquePtr ptr;
             new(ptr._buffer.data()) T(std::forward<Args>(args)...);
+            ptr._relocate = &relocate<T>;
             ptr._type = T::TYPE;
             return ptr;
         }
@@ -20,61 +36,82 @@ namespace Ichor {
         EventStackUniquePtr(const EventStackUniquePtr &) = delete;
 
         EventStackUniquePtr(EventStackUniquePtr &&other) noexcept {
-            if (!_empty) {
-                reinterpret_cast<Event *>(_buffer.data())->~Event();
-            }
-            _buffer = other._buffer;
-            other._empty = true;
-            _empty = false;
-            _type = other._type;
+            takeFrom(other);
         }
 
-
         EventStackUniquePtr &operator=(const EventStackUniquePtr &) = delete;
 
         EventStackUniquePtr &operator=(EventStackUniquePtr &&other) noexcept {
-            if (!_empty) {
-                reinterpret_cast<Event *>(_buffer.data())->~Event();
+            if(this != &other) {
+                reset();
+                takeFrom(other);
             }
-            _buffer = other._buffer;
-            other._empty = true;
-            _empty = false;
-            _type = other._type;
             return *this;
         }
 
         ~EventStackUniquePtr() {
-            if (!_empty) {
-                reinterpret_cast<Event *>(_buffer.data())->~Event();
+            reset();
+        }
+
+        void reset() noexcept {
+            if(_relocate != nullptr) {
+                std::launder(reinterpret_cast<Event *>(_buffer.data()))->~Event();
+                _relocate = nullptr;
+                _type = 0;
             }
         }
 
         template<typename T>
         requires Derived<T, Event>
         [[nodiscard]] T *getT() {
-            if (_empty) {
+            if (empty()) {
                 throw std::runtime_error("empty");
             }
 
-            return reinterpret_cast<T *>(_buffer.data());
+            return std::launder(reinterpret_cast<T *>(_buffer.data()));
         }
 
         [[nodiscard]] Event *get() {
-            if (_empty) {
+            if (empty()) {
                 throw std::runtime_error("empty");
             }
 
-            return reinterpret_cast<Event *>(_buffer.data());
+            return std::launder(reinterpret_cast<Event *>(_buffer.data()));
         }
 
         [[nodiscard]] uint64_t getType() const noexcept {
             return _type;
         }
 
+        [[nodiscard]] bool empty() const noexcept {
+            return _relocate == nullptr;
+        }
+
     private:
+        using RelocateFn = void (*)(std::byte *from, std::byte *to) noexcept;
+
+        // move constructs the event in from into to and destroys the original
+        template<typename T>
+        static void relocate(std::byte *from, std::byte *to) noexcept {
+            T *original = std::launder(reinterpret_cast<T *>(from));
+            new(to) T(std::move(*original));
+            original->~T();
+        }
+
+        void takeFrom(EventStackUniquePtr &other) noexcept {
+            if(other._relocate == nullptr) {
+                return;
+            }
+
+            other._relocate(other._buffer.data(), _buffer.data());
+            _relocate = other._relocate;
+            _type = other._type;
+            other._relocate = nullptr;
+            other._type = 0;
+        }
 
-        std::array<uint8_t, 128> _buffer;
+        alignas(std::max_align_t) std::array<std::byte, INLINE_SIZE> _buffer;
+        RelocateFn _relocate{nullptr}; // nullptr when empty
         uint64_t _type{0};
-        bool _empty{true};
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Unbounded lock-free multi-producer single-consumer FIFO, based on Dmitry Vyukov's non-intrusive MPSC node based queue.
+// pop() may only be called from a single thread at a time.
+// Popped nodes are kept in a bounded lock-free ring (Vyukov's bounded MPMC queue, with the consumer as its only producer) for pushes to reuse,
+// so that a queue whose consumer keeps up does not allocate. Only pushes that find the ring empty allocate a node, nodes that don't fit in the ring are freed.
+// Note that a push is only visible to the consumer once the producer finished linking its node. A producer that got preempted between
+// the exchange and the store makes pop() temporarily return false, even though later pushes are already linked behind it.
+namespace Ichor {
+    template <typename T>
+    class MpscQueue final {
+    public:
+        // has to be a power of two
+        static constexpr uint64_t CACHED_NODES = 1024;
+
+        MpscQueue() : _head(&_stub), _tail(&_stub), _cache(std::make_unique<Cell[]>(CACHED_NODES)) {
+            for(uint64_t i = 0; i < CACHED_NODES; i++) {
+                _cache[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        ~MpscQueue() {
+            T discard{};
+            while(pop(discard)) {
+            }
+
+            if(_tail != &_stub) {
+                delete _tail;
+            }
+
+            while(Node *node = takeCachedNode()) {
+                delete node;
+            }
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue(MpscQueue&&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+        MpscQueue& operator=(MpscQueue&&) = delete;
+
+        /// Thread-safe, may be called by any amount of producers. Lock-free, allocates only if no popped node is available for reuse.
+        void push(T &&value) {
+            Node *node = takeCachedNode();
+            if(node == nullptr) {
+                node = new Node{};
+                _allocatedNodes.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                node->next.store(nullptr, std::memory_order_relaxed);
+            }
+            node->value = std::move(value);
+            Node *prev = _head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        /// Consumer only
+        /// \param out value is moved into out if the queue is not empty
+        /// \return true if a value was popped
+        [[nodiscard]] bool pop(T &out) {
+            Node *tail = _tail;
+            Node *next = tail->next.load(std::memory_order_acquire);
+
+            if(next == nullptr) {
+                return false;
+            }
+
+            out = std::move(next->value);
+            _tail = next;
+
+            if(tail != &_stub && !cacheNode(tail)) {
+                delete tail;
+            }
+
+            return true;
+        }
+
+        /// Consumer only
+        [[nodiscard]] bool empty() const noexcept {
+            return _tail->next.load(std::memory_order_acquire) == nullptr;
+        }
+
+        /// Thread-safe
+        /// \return amount of nodes allocated since construction, stays constant while popped nodes are reused
+        [[nodiscard]] uint64_t allocatedNodes() const noexcept {
+            return _allocatedNodes.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Node final {
+            std::atomic<Node*> next{nullptr};
+            T value{};
+        };
+
+        struct Cell final {
+            std::atomic<uint64_t> sequence{};
+            Node *node{};
+        };
+
+        // consumer only, the value of node has been moved out already
+        [[nodiscard]] bool cacheNode(Node *node) noexcept {
+            auto &cell = _cache[_cacheEnqueuePos & (CACHED_NODES - 1)];
+            // either the ring is full, or a producer claimed this cell but did not finish taking its node out yet
+            if(cell.sequence.load(std::memory_order_acquire) != _cacheEnqueuePos) {
+                return false;
+            }
+
+            cell.node = node;
+            cell.sequence.store(_cacheEnqueuePos + 1, std::memory_order_release);
+            _cacheEnqueuePos++;
+            return true;
+        }
+
+        [[nodiscard]] Node* takeCachedNode() noexcept {
+            uint64_t pos = _cacheDequeuePos.load(std::memory_order_relaxed);
+            Cell *cell;
+            while(true) {
+                cell = &_cache[pos & (CACHED_NODES - 1)];
+                auto const diff = static_cast<int64_t>(cell->sequence.load(std::memory_order_acquire) - (pos + 1));
+
+                if(diff == 0) {
+                    if(_cacheDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if(diff < 0) {
+                    return nullptr;
+                } else {
+                    pos = _cacheDequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+
+            Node *node = cell->node;
+            cell->sequence.store(pos + CACHED_NODES, std::memory_order_release);
+            return node;
+        }
+
+        Node _stub{};
+        alignas(64) std::atomic<Node*> _head;
+        alignas(64) Node* _tail;
+        uint64_t _cacheEnqueuePos{};
+        std::unique_ptr<Cell[]> _cache;
+        alignas(64) std::atomic<uint64_t> _cacheDequeuePos{};
+        std::atomic<uint64_t> _allocatedNodes{};
+    };
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+// Container that stores its values contiguously and hands out handles for O(1) lookup.
+// A handle encodes a slot and the generation of that slot. Erasing a value bumps the generation of its slot, so stale handles are detected instead of finding whatever value reused the slot.
+// Erasing moves the last value into the gap, so iteration order is not stable and erasing invalidates iterators and references. Not thread-safe.
+namespace Ichor {
+    using SlotMapHandle = uint64_t;
+
+    template <typename T>
+    class SlotMap final {
+    public:
+        /// Never returned by insert()
+        static constexpr SlotMapHandle INVALID_HANDLE = 0;
+
+        /// \param value
+        /// \return handle to the inserted value
+        SlotMapHandle insert(T &&value) {
+            uint32_t slot;
+            if(_freeSlots.empty()) {
+                if(_slots.size() == std::numeric_limits<uint32_t>::max()) {
+                    throw std::runtime_error("SlotMap is full");
+                }
+                slot = static_cast<uint32_t>(_slots.size());
+                _slots.push_back(Slot{0, 1});
+            } else {
+                slot = _freeSlots.back();
+                _freeSlots.pop_back();
+            }
+
+            _values.push_back(std::move(value));
+            _slotOfValue.push_back(slot);
+            _slots[slot].valueIndex = static_cast<uint32_t>(_values.size() - 1);
+            return makeHandle(slot, _slots[slot].generation);
+        }
+
+        /// \param handle
+        /// \return value or nullptr if handle is stale or invalid
+        [[nodiscard]] T* find(SlotMapHandle handle) noexcept {
+            auto const slot = slotOf(handle);
+            if(slot >= _slots.size() || _slots[slot].generation != generationOf(handle)) {
+                return nullptr;
+            }
+            return &_values[_slots[slot].valueIndex];
+        }
+
+        [[nodiscard]] T const* find(SlotMapHandle handle) const noexcept {
+            return const_cast<SlotMap*>(this)->find(handle);
+        }
+
+        /// \param handle
+        /// \return true if a value was erased, false if handle is stale or invalid
+        bool erase(SlotMapHandle handle) {
+            auto const slot = slotOf(handle);
+            if(slot >= _slots.size() || _slots[slot].generation != generationOf(handle)) {
+                return false;
+            }
+
+            auto const valueIndex = _slots[slot].valueIndex;
+            auto const lastIndex = static_cast<uint32_t>(_values.size() - 1);
+            if(valueIndex != lastIndex) {
+                _values[valueIndex] = std::move(_values[lastIndex]);
+                _slotOfValue[valueIndex] = _slotOfValue[lastIndex];
+                _slots[_slotOfValue[valueIndex]].valueIndex = valueIndex;
+            }
+            _values.pop_back();
+            _slotOfValue.pop_back();
+
+            // skip 0 on wrap around, so INVALID_HANDLE is never handed out
+            if(++_slots[slot].generation == 0) {
+                _slots[slot].generation = 1;
+            }
+            _freeSlots.push_back(slot);
+            return true;
+        }
+
+        void clear() {
+            for(uint32_t valueIndex = 0; valueIndex < _values.size(); valueIndex++) {
+                auto &generation = _slots[_slotOfValue[valueIndex]].generation;
+                if(++generation == 0) {
+                    generation = 1;
+                }
+                _freeSlots.push_back(_slotOfValue[valueIndex]);
+            }
+            _values.clear();
+            _slotOfValue.clear();
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return _values.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _values.empty();
+        }
+
+        [[nodiscard]] auto begin() noexcept {
+            return _values.begin();
+        }
+
+        [[nodiscard]] auto end() noexcept {
+            return _values.end();
+        }
+
+        [[nodiscard]] auto begin() const noexcept {
+            return _values.cbegin();
+        }
+
+        [[nodiscard]] auto end() const noexcept {
+            return _values.cend();
+        }
+
+    private:
+        struct Slot final {
+            uint32_t valueIndex;
+            uint32_t generation; // never 0
+        };
+
+        [[nodiscard]] static constexpr SlotMapHandle makeHandle(uint32_t slot, uint32_t generation) noexcept {
+            return (static_cast<uint64_t>(generation) << 32) | slot;
+        }
+
+        [[nodiscard]] static constexpr uint32_t slotOf(SlotMapHandle handle) noexcept {
+            return static_cast<uint32_t>(handle);
+        }
+
+        [[nodiscard]] static constexpr uint32_t generationOf(SlotMapHandle handle) noexcept {
+            return static_cast<uint32_t>(handle >> 32);
+        }
+
+        std::vector<T> _values{};
+        std::vector<uint32_t> _slotOfValue{}; // index = value index
+        std::vector<Slot> _slots{};
+        std::vector<uint32_t> _freeSlots{};
+    };
+}
@@ -2,6 +2,8 @@
 #include <ichor/CommunicationChannel.h>
 #include <ichor/stl/Any.h>
 #include <ichor/events/RunFunctionEvent.h>
+#include <tuple>
+#include <type_traits>
 
 #ifdef ICHOR_USE_SYSTEM_MIMALLOC
 #include <mimalloc-new-delete.h>
@@ -25,6 +27,36 @@ Ichor::unordered_set<uint64_t> Ichor::Detail::emptyDependencies{};
 
 thread_local Ichor::DependencyManager *Ichor::Detail::_local_dm = nullptr;
 
+namespace {
+    // Events processEvent() handles itself instead of broadcasting them. It calls into services while handling these, so they have to wait for all worker handlers.
+    // The cases of its switch are labelled with managerEventType(), which does not compile for events missing here.
+    // ContinuableEvent is left out on purpose, it only calls into a service if it resumes a coroutine and waits for the workers itself.
+    using ManagerEvents = std::tuple<Ichor::DependencyOnlineEvent, Ichor::DependencyOnlineBatchEvent, Ichor::DependencyOfflineEvent, Ichor::DependencyRequestEvent,
+                                     Ichor::DependencyRequestBatchEvent, Ichor::DependencyUndoRequestEvent, Ichor::QuitEvent, Ichor::StopServiceEvent, Ichor::RemoveServiceEvent,
+                                     Ichor::StartServiceEvent, Ichor::StartServiceBatchEvent, Ichor::DoWorkEvent, Ichor::RemoveCompletionCallbacksEvent, Ichor::RemoveEventHandlerEvent,
+                                     Ichor::RemoveEventInterceptorEvent, Ichor::RemoveTrackerEvent, Ichor::RunFunctionEvent>;
+
+    template <typename EventT, typename... EventTs>
+    consteval bool containsEvent(std::tuple<EventTs...> const *) {
+        return (std::is_same_v<EventT, EventTs> || ...);
+    }
+
+    template <typename EventT>
+    consteval uint64_t managerEventType() {
+        static_assert(containsEvent<EventT>(static_cast<ManagerEvents const *>(nullptr)), "Add the event to ManagerEvents, so that the manager waits for the worker handlers before handling it");
+        return EventT::TYPE;
+    }
+
+    template <typename... EventTs>
+    [[nodiscard]] bool isHandledByManager(uint64_t type, std::tuple<EventTs...> const *) noexcept {
+        return ((type == EventTs::TYPE) || ...);
+    }
+
+    [[nodiscard]] bool isHandledByManager(uint64_t type) noexcept {
+        return isHandledByManager(type, static_cast<ManagerEvents const *>(nullptr));
+    }
+}
+
 
 
 void Ichor::DependencyManager::start() {
@@ -50,34 +82,54 @@ void Ichor::DependencyManager::start() {
 #ifdef __linux__
     pthread_setname_np(pthread_self(), fmt::format("DepMan #{}", _id).c_str());
 #endif
+
+    if(_workerThreadCount > 0) {
+        _workerPool = std::make_unique<Detail::WorkerPool>(this, _workerThreadCount);
+    }
 }
 
 
-void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt) {
+void Ichor::DependencyManager::processEvent(std::unique_ptr<Event, EventDeleter> &&uniqueEvt) {
 //      ICHOR_LOG_ERROR(_logger, "evt id {} type {} has {}-{} prio", evt->id, evt->name, evtNode.key(), evt->priority);
 
-    std::shared_ptr<Event> evt{std::move(uniqueEvt)};
+    // ownership stays with uniqueEvt unless a handler suspends, see the end of this function
+    Event *evt = uniqueEvt.get();
     bool allowProcessing = true;
     uint64_t handlerAmount = 1; // for the non-default case below, the DepMan handles the event
-    auto interceptorsForAllEvents = _eventInterceptors.find(0);
-    auto interceptorsForEvent = _eventInterceptors.find(evt->type);
-    std::vector<EventInterceptInfo> allEventInterceptorsCopy{};
-    std::vector<EventInterceptInfo> eventInterceptorsCopy{};
-
-    if (interceptorsForAllEvents != end(_eventInterceptors)) {
-        // Make copy because the vector can be modified in the preIntercept() call.
-        allEventInterceptorsCopy = interceptorsForAllEvents->second;
-        for (EventInterceptInfo const &info : allEventInterceptorsCopy) {
+    // Snapshots because the interceptors can be modified in the preIntercept() call. Only modifications during dispatch copy the interceptors.
+    CopyOnWriteVector<EventInterceptInfo>::Snapshot allEventInterceptors{};
+    CopyOnWriteVector<EventInterceptInfo>::Snapshot eventInterceptors{};
+
+    // the manager calls into services while handling its own events, those can't run concurrently with worker handlers
+    if(_workerPool != nullptr && isHandledByManager(evt->type)) {
+        _workerPool->waitForAll();
+    }
+
+    if(evt->typeIndex == 0) {
+        // not created by a manager, if the type is not registered there are no handlers or interceptors for it either
+        evt->typeIndex = Detail::findEventTypeIndex(evt->type);
+    }
+
+    if(!_eventInterceptors.empty() && !_eventInterceptors[0].empty()) {
+        allEventInterceptors = _eventInterceptors[0].snapshot();
+    }
+
+    if(evt->typeIndex != 0 && evt->typeIndex < _eventInterceptors.size() && !_eventInterceptors[evt->typeIndex].empty()) {
+        eventInterceptors = _eventInterceptors[evt->typeIndex].snapshot();
+    }
+
+    if (allEventInterceptors) {
+        for (EventInterceptInfo const &info : *allEventInterceptors) {
+            waitForWorkers(info.listeningServiceId);
             if (!info.preIntercept(*evt)) {
                 allowProcessing = false;
             }
         }
     }
 
-    if (interceptorsForEvent != end(_eventInterceptors)) {
-        // Make copy because the vector can be modified in the preIntercept() call.
-        eventInterceptorsCopy = interceptorsForEvent->second;
-        for (EventInterceptInfo const &info : eventInterceptorsCopy) {
+    if (eventInterceptors) {
+        for (EventInterceptInfo const &info : *eventInterceptors) {
+            waitForWorkers(info.listeningServiceId);
             if (!info.preIntercept(*evt)) {
                 allowProcessing = false;
             }
@@ -86,51 +138,43 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
 
     if (allowProcessing) {
         switch (evt->type) {
-            case DependencyOnlineEvent::TYPE: {
+            case managerEventType<DependencyOnlineEvent>(): {
                 INTERNAL_DEBUG("DependencyOnlineEvent {}", evt->id);
-                auto *depOnlineEvt = static_cast<DependencyOnlineEvent *>(evt.get());
-                auto managerIt = _services.find(depOnlineEvt->originatingService);
+                auto *manager = findService(evt->originatingService);
 
-                if (managerIt == end(_services)) {
+                if (manager == nullptr) {
                     break;
                 }
 
-                auto &manager = managerIt->second;
-
-                if (!manager->setInjected()) {
-                    INTERNAL_DEBUG("Couldn't set injected for {} {} {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
-                    break;
-                }
-
-                auto const filterProp = manager->getProperties().find("Filter");
-                const Filter *filter = nullptr;
-                if (filterProp != cend(manager->getProperties())) {
-                    filter = Ichor::any_cast<Filter *const>(&filterProp->second);
-                }
+                handleServiceOnline(*manager);
+            }
+                break;
+            case managerEventType<DependencyOnlineBatchEvent>(): {
+                INTERNAL_DEBUG("DependencyOnlineBatchEvent {}", evt->id);
+                auto *depOnlineBatchEvt = static_cast<DependencyOnlineBatchEvent *>(evt);
 
-                for (auto const &[key, possibleDependentLifecycleManager]: _services) {
-                    if (key == depOnlineEvt->originatingService || (filter != nullptr && !filter->compareTo(*possibleDependentLifecycleManager.get()))) {
-                        continue;
-                    }
+                bool const ownsBatch = beginServiceBatch();
+                for (uint64_t serviceId : depOnlineBatchEvt->serviceIds) {
+                    auto *manager = findService(serviceId);
 
-                    if (possibleDependentLifecycleManager->dependencyOnline(manager.get()) == Detail::DependencyChange::FOUND_AND_START_ME) {
-                        pushPrioritisedEvent<StartServiceEvent>(depOnlineEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY,
-                                                             possibleDependentLifecycleManager->serviceId());
+                    if (manager != nullptr) {
+                        handleServiceOnline(*manager);
                     }
                 }
+                if (ownsBatch) {
+                    endServiceBatch();
+                }
             }
                 break;
-            case DependencyOfflineEvent::TYPE: {
+            case managerEventType<DependencyOfflineEvent>(): {
                 INTERNAL_DEBUG("DependencyOfflineEvent {} {}", evt->id, evt->originatingService);
-                auto *depOfflineEvt = static_cast<DependencyOfflineEvent *>(evt.get());
-                auto managerIt = _services.find(depOfflineEvt->originatingService);
+                auto *depOfflineEvt = static_cast<DependencyOfflineEvent *>(evt);
+                auto *manager = findService(depOfflineEvt->originatingService);
 
-                if (managerIt == end(_services)) {
+                if (manager == nullptr) {
                     break;
                 }
 
-                auto &manager = managerIt->second;
-
                 if (!manager->setUninjected()) {
                     // DependencyOfflineEvent already processed
                     INTERNAL_DEBUG("Couldn't set uninjected for {} {} {}", manager->serviceId(), manager->implementationName(), manager->getServiceState());
@@ -140,35 +184,49 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 // copy dependees as it will be modified during this loop
                 auto dependees = manager->getDependees();
                 for (auto &serviceId : dependees) {
-                    auto depIt = _services.find(serviceId);
+                    auto *dependee = findService(serviceId);
 
-                    if(depIt == _services.end()) {
+                    if(dependee == nullptr) {
                         continue;
                     }
 
-                    if (depIt->second->dependencyOffline(manager.get()) == Detail::DependencyChange::FOUND_AND_STOP_ME) {
-                        INTERNAL_DEBUG("svc {}:{} reported dependency found and to stop ---------", serviceId, depIt->second->implementationName());
+                    if (dependee->dependencyOffline(manager) == Detail::DependencyChange::FOUND_AND_STOP_ME) {
+                        INTERNAL_DEBUG("svc {}:{} reported dependency found and to stop ---------", serviceId, dependee->implementationName());
                         pushPrioritisedEvent<StopServiceEvent>(depOfflineEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY,
-                                                            depIt->second->serviceId());
+                                                            dependee->serviceId());
                     }
                 }
             }
                 break;
-            case DependencyRequestEvent::TYPE: {
-                auto *depReqEvt = static_cast<DependencyRequestEvent *>(evt.get());
+            case managerEventType<DependencyRequestEvent>(): {
+                handleDependencyRequest(*static_cast<DependencyRequestEvent *>(evt));
+            }
+                break;
+            case managerEventType<DependencyRequestBatchEvent>(): {
+                INTERNAL_DEBUG("DependencyRequestBatchEvent {}", evt->id);
+                auto *depReqBatchEvt = static_cast<DependencyRequestBatchEvent *>(evt);
 
-                auto trackers = _dependencyRequestTrackers.find(depReqEvt->dependency.interfaceNameHash);
-                if (trackers == end(_dependencyRequestTrackers)) {
-                    break;
-                }
+                // services created by trackers, like loggers, come online in one batch as well
+                bool const ownsBatch = beginServiceBatch();
+                for (uint64_t serviceId : depReqBatchEvt->serviceIds) {
+                    auto *manager = findService(serviceId);
 
-                for (DependencyTrackerInfo &info: trackers->second) {
-                    info.trackFunc(*depReqEvt);
+                    if (manager == nullptr) {
+                        continue;
+                    }
+
+                    for (auto const &[key, registration] : manager->getDependencyRegistry()->_registrations) {
+                        auto const &props = std::get<std::optional<Properties>>(registration);
+                        handleDependencyRequest(DependencyRequestEvent{evt->id, serviceId, evt->priority, std::get<Dependency>(registration), props.has_value() ? &props.value() : std::optional<Properties const *>{}});
+                    }
+                }
+                if (ownsBatch) {
+                    endServiceBatch();
                 }
             }
                 break;
-            case DependencyUndoRequestEvent::TYPE: {
-                auto *depUndoReqEvt = static_cast<DependencyUndoRequestEvent *>(evt.get());
+            case managerEventType<DependencyUndoRequestEvent>(): {
+                auto *depUndoReqEvt = static_cast<DependencyUndoRequestEvent *>(evt);
 
                 auto trackers = _dependencyUndoRequestTrackers.find(depUndoReqEvt->dependency.interfaceNameHash);
                 if (trackers == end(_dependencyUndoRequestTrackers)) {
@@ -180,65 +238,50 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 }
             }
                 break;
-            case QuitEvent::TYPE: {
+            case managerEventType<QuitEvent>(): {
                 INTERNAL_DEBUG("QuitEvent {}", evt->id);
-                auto *_quitEvt = static_cast<QuitEvent *>(evt.get());
-
-                bool allServicesStopped{true};
-
-                for (auto const &[key, possibleManager]: _services) {
-                    if (possibleManager->getServiceState() != ServiceState::INSTALLED) {
-                        allServicesStopped = false;
+                auto *_quitEvt = static_cast<QuitEvent *>(evt);
 
-                        auto &dependees = possibleManager->getDependees();
-
-                        for(auto &serviceId : dependees) {
-                            pushPrioritisedEvent<StopServiceEvent>(_quitEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY,
-                                                                serviceId);
-                        }
-
-                        pushPrioritisedEvent<StopServiceEvent>(_quitEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY,
-                                                            possibleManager->serviceId());
-                    }
+                // the stop order is computed once, later QuitEvents have nothing to add
+                if(_shuttingDown) {
+                    break;
                 }
 
-                if (allServicesStopped) {
-                    _eventQueue->quit();
-                } else {
-                    pushPrioritisedEvent<QuitEvent>(_quitEvt->originatingService, INTERNAL_EVENT_PRIORITY + 1);
+                _shuttingDown = true;
+                _shutdownOriginatingService = _quitEvt->originatingService;
+                if(_shutdownTimeout.count() > 0) {
+                    _shutdownDeadline.store(std::chrono::steady_clock::now() + _shutdownTimeout, std::memory_order_release);
                 }
+                stopRemainingServices();
             }
                 break;
-            case StopServiceEvent::TYPE: {
-                auto *stopServiceEvt = static_cast<StopServiceEvent *>(evt.get());
+            case managerEventType<StopServiceEvent>(): {
+                auto *stopServiceEvt = static_cast<StopServiceEvent *>(evt);
 
-                auto toStopServiceIt = _services.find(stopServiceEvt->serviceId);
+                auto *toStopService = findService(stopServiceEvt->serviceId);
 
-                if (toStopServiceIt == end(_services)) {
+                if (toStopService == nullptr) {
                     ICHOR_LOG_ERROR(_logger, "Couldn't stop service {}, missing from known services", stopServiceEvt->serviceId);
                     handleEventError(*stopServiceEvt);
                     break;
                 }
 
-                auto *toStopService = toStopServiceIt->second.get();
-
                 INTERNAL_DEBUG("StopServiceEvent {} {}:{} state {} dependees {}", evt->id, stopServiceEvt->serviceId, toStopService->implementationName(), toStopService->getServiceState(), toStopService->getDependees().size());
 
                 // already stopped
                 if(toStopService->getServiceState() == ServiceState::INSTALLED) {
                     INTERNAL_DEBUG("already stopped");
+                    serviceStoppedDuringShutdown(stopServiceEvt->serviceId);
                     break;
                 }
 
-                auto existingCoroutineEvent = std::find_if(_scopedEvents.begin(), _scopedEvents.end(), [&toStopService](const std::pair<uint64_t, std::shared_ptr<Event>> &t) {
-                    return t.second->originatingService == toStopService->serviceId();
-                });
-
-                // coroutine needs to finish before we can stop the service
-                if(existingCoroutineEvent != _scopedEvents.end()) {
+                // coroutine needs to finish before we can stop the service, eraseScopedEvent() pushes the stop again once the last one finished
+                if(_scopedEventsPerService.contains(toStopService->serviceId())) {
                     INTERNAL_DEBUG("existing scoped event");
-                    pushPrioritisedEvent<StopServiceEvent>(stopServiceEvt->originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY,
-                                                        toStopService->serviceId());
+                    auto &waitingStops = _stopsWaitingForCoroutines[toStopService->serviceId()];
+                    if(std::find(waitingStops.begin(), waitingStops.end(), stopServiceEvt->originatingService) == waitingStops.end()) {
+                        waitingStops.push_back(stopServiceEvt->originatingService);
+                    }
                     break;
                 }
 
@@ -267,15 +310,16 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                         }
                     } else {
                         for (auto &serviceId : dependencies) {
-                            auto depIt = _services.find(serviceId);
+                            auto *dependency = findService(serviceId);
 
-                            if(depIt == _services.end()) {
+                            if(dependency == nullptr) {
                                 continue;
                             }
 
-                            depIt->second->getDependees().erase(stopServiceEvt->serviceId);
+                            dependency->getDependees().erase(stopServiceEvt->serviceId);
                         }
                         handleEventCompletion(*stopServiceEvt);
+                        serviceStoppedDuringShutdown(stopServiceEvt->serviceId);
                     }
                 } else {
                     pushPrioritisedEvent<DependencyOfflineEvent>(toStopService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY - 1);
@@ -283,19 +327,18 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 }
             }
                 break;
-            case RemoveServiceEvent::TYPE: {
+            case managerEventType<RemoveServiceEvent>(): {
                 INTERNAL_DEBUG("RemoveServiceEvent {}", evt->id);
-                auto *removeServiceEvt = static_cast<RemoveServiceEvent *>(evt.get());
+                auto *removeServiceEvt = static_cast<RemoveServiceEvent *>(evt);
 
-                auto toRemoveServiceIt = _services.find(removeServiceEvt->serviceId);
+                auto *toRemoveService = findService(removeServiceEvt->serviceId);
 
-                if (toRemoveServiceIt == end(_services)) {
+                if (toRemoveService == nullptr) {
                     ICHOR_LOG_ERROR(_logger, "Couldn't remove service {}, missing from known services", removeServiceEvt->serviceId);
                     handleEventError(*removeServiceEvt);
                     break;
                 }
 
-                auto *toRemoveService = toRemoveServiceIt->second.get();
                 if (removeServiceEvt->dependenciesStopped) {
                     auto ret = toRemoveService->stop();
                     if (toRemoveService->getServiceState() == ServiceState::ACTIVE && ret != StartBehaviour::SUCCEEDED) {
@@ -309,7 +352,15 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                         }
                     } else {
                         handleEventCompletion(*removeServiceEvt);
-                        _services.erase(toRemoveServiceIt);
+                        // the completion handler may have added services, don't reuse the iterator
+                        auto const handle = _serviceHandles[removeServiceEvt->serviceId];
+                        unindexInterfaces(*toRemoveService, handle);
+                        _services.erase(handle);
+                        _serviceHandles.erase(removeServiceEvt->serviceId);
+                        if(_workerPool != nullptr) {
+                            _workerPool->removeService(removeServiceEvt->serviceId);
+                        }
+                        serviceStoppedDuringShutdown(removeServiceEvt->serviceId);
                     }
                 } else {
                     pushPrioritisedEvent<DependencyOfflineEvent>(toRemoveService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
@@ -319,25 +370,24 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 }
             }
                 break;
-            case StartServiceEvent::TYPE: {
+            case managerEventType<StartServiceEvent>(): {
                 INTERNAL_DEBUG("StartServiceEvent {}", evt->id);
-                auto *startServiceEvt = static_cast<StartServiceEvent *>(evt.get());
+                auto *startServiceEvt = static_cast<StartServiceEvent *>(evt);
 
-                auto toStartServiceIt = _services.find(startServiceEvt->serviceId);
+                auto *toStartService = findService(startServiceEvt->serviceId);
 
-                if (toStartServiceIt == end(_services)) {
+                if (toStartService == nullptr) {
                     ICHOR_LOG_ERROR(_logger, "Couldn't start service {}, missing from known services", startServiceEvt->serviceId);
                     handleEventError(*startServiceEvt);
                     break;
                 }
 
-                auto *toStartService = toStartServiceIt->second.get();
                 if (toStartService->getServiceState() == ServiceState::ACTIVE) {
                     handleEventCompletion(*startServiceEvt);
                 } else {
                     auto ret = toStartService->start();
                     if (ret == StartBehaviour::SUCCEEDED) {
-                        pushPrioritisedEvent<DependencyOnlineEvent>(toStartService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
+                        serviceStarted(toStartService->serviceId(), INTERNAL_DEPENDENCY_EVENT_PRIORITY);
                         handleEventCompletion(*startServiceEvt);
                     } else {
                         INTERNAL_DEBUG("Couldn't start service {}: {}", startServiceEvt->serviceId, toStartService->implementationName());
@@ -350,48 +400,87 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 }
             }
                 break;
-            case DoWorkEvent::TYPE: {
+            case managerEventType<StartServiceBatchEvent>(): {
+                INTERNAL_DEBUG("StartServiceBatchEvent {}", evt->id);
+                auto *startServiceBatchEvt = static_cast<StartServiceBatchEvent *>(evt);
+
+                bool const ownsBatch = beginServiceBatch();
+                for (auto const &[originatingService, serviceId] : startServiceBatchEvt->services) {
+                    // callbacks get the same event as when this service would have been started separately
+                    StartServiceEvent const startServiceEvt{startServiceBatchEvt->id, originatingService, startServiceBatchEvt->priority, serviceId};
+                    auto *toStartService = findService(serviceId);
+
+                    if (toStartService == nullptr) {
+                        ICHOR_LOG_ERROR(_logger, "Couldn't start service {}, missing from known services", serviceId);
+                        handleEventError(startServiceEvt);
+                        continue;
+                    }
+
+                    if (toStartService->getServiceState() == ServiceState::ACTIVE) {
+                        handleEventCompletion(startServiceEvt);
+                        continue;
+                    }
+
+                    auto ret = toStartService->start();
+                    if (ret == StartBehaviour::SUCCEEDED) {
+                        serviceStarted(serviceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY);
+                        handleEventCompletion(startServiceEvt);
+                    } else {
+                        INTERNAL_DEBUG("Couldn't start service {}: {}", serviceId, toStartService->implementationName());
+                        handleEventError(startServiceEvt);
+                        if (ret == StartBehaviour::FAILED_AND_RETRY) {
+                            pushPrioritisedEvent<StartServiceEvent>(originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, serviceId);
+                        }
+                    }
+                }
+                if (ownsBatch) {
+                    endServiceBatch();
+                }
+            }
+                break;
+            case managerEventType<DoWorkEvent>(): {
                 INTERNAL_DEBUG("DoWorkEvent {}", evt->id);
                 handleEventCompletion(*evt);
             }
                 break;
-            case RemoveCompletionCallbacksEvent::TYPE: {
+            case managerEventType<RemoveCompletionCallbacksEvent>(): {
                 INTERNAL_DEBUG("RemoveCompletionCallbacksEvent {}", evt->id);
-                auto *removeCallbacksEvt = static_cast<RemoveCompletionCallbacksEvent *>(evt.get());
+                auto *removeCallbacksEvt = static_cast<RemoveCompletionCallbacksEvent *>(evt);
 
                 _completionCallbacks.erase(removeCallbacksEvt->key);
                 _errorCallbacks.erase(removeCallbacksEvt->key);
             }
                 break;
-            case RemoveEventHandlerEvent::TYPE: {
+            case managerEventType<RemoveEventHandlerEvent>(): {
                 INTERNAL_DEBUG("RemoveEventHandlerEvent {}", evt->id);
-                auto *removeEventHandlerEvt = static_cast<RemoveEventHandlerEvent *>(evt.get());
+                auto *removeEventHandlerEvt = static_cast<RemoveEventHandlerEvent *>(evt);
 
                 // key.id = service id, key.type == event id
-                auto existingHandlers = _eventCallbacks.find(removeEventHandlerEvt->key.type);
-                if (existingHandlers != end(_eventCallbacks)) {
-                    std::erase_if(existingHandlers->second, [removeEventHandlerEvt](const EventCallbackInfo &info) noexcept {
+                auto const typeIndex = Detail::findEventTypeIndex(removeEventHandlerEvt->key.type);
+                if (typeIndex != 0 && typeIndex < _eventCallbacks.size()) {
+                    _eventCallbacks[typeIndex].erase_if([removeEventHandlerEvt](const EventCallbackInfo &info) noexcept {
                         return info.listeningServiceId == removeEventHandlerEvt->key.id;
                     });
                 }
             }
                 break;
-            case RemoveEventInterceptorEvent::TYPE: {
+            case managerEventType<RemoveEventInterceptorEvent>(): {
                 INTERNAL_DEBUG("RemoveEventInterceptorEvent {}", evt->id);
-                auto *removeEventHandlerEvt = static_cast<RemoveEventInterceptorEvent *>(evt.get());
+                auto *removeEventHandlerEvt = static_cast<RemoveEventInterceptorEvent *>(evt);
 
                 // key.id = service id, key.type == event id
-                auto existingHandlers = _eventInterceptors.find(removeEventHandlerEvt->key.type);
-                if (existingHandlers != end(_eventInterceptors)) {
-                    std::erase_if(existingHandlers->second, [removeEventHandlerEvt](const EventInterceptInfo &info) noexcept {
+                // key.type 0 is not registered and maps to the interceptors for all events
+                auto const typeIndex = Detail::findEventTypeIndex(removeEventHandlerEvt->key.type);
+                if (typeIndex < _eventInterceptors.size()) {
+                    _eventInterceptors[typeIndex].erase_if([removeEventHandlerEvt](const EventInterceptInfo &info) noexcept {
                         return info.listeningServiceId == removeEventHandlerEvt->key.id;
                     });
                 }
             }
                 break;
-            case RemoveTrackerEvent::TYPE: {
+            case managerEventType<RemoveTrackerEvent>(): {
                 INTERNAL_DEBUG("RemoveTrackerEvent {}", evt->id);
-                auto *removeTrackerEvt = static_cast<RemoveTrackerEvent *>(evt.get());
+                auto *removeTrackerEvt = static_cast<RemoveTrackerEvent *>(evt);
 
                 _dependencyRequestTrackers.erase(removeTrackerEvt->interfaceNameHash);
                 _dependencyUndoRequestTrackers.erase(removeTrackerEvt->interfaceNameHash);
@@ -399,12 +488,17 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                 break;
             case ContinuableEvent::TYPE: {
                 INTERNAL_DEBUG("ContinuableEventAsync {}", evt->id);
-                auto *continuableEvt = static_cast<ContinuableEvent *>(evt.get());
+                auto *continuableEvt = static_cast<ContinuableEvent *>(evt);
                 auto genIt = _scopedGenerators.find(continuableEvt->promiseId);
 
                 if (genIt != _scopedGenerators.end()) {
                     INTERNAL_DEBUG("ContinuableEventAsync2 {}", genIt->second->done());
 
+                    // which service the coroutine belongs to is unknown
+                    if (_workerPool != nullptr) {
+                        _workerPool->waitForAll();
+                    }
+
                     if (!genIt->second->done()) {
                         auto it = genIt->second->begin_interface();
                         INTERNAL_DEBUG("ContinuableEventAsync it {} {} {}", it->get_finished(), it->get_op_state(), it->get_promise_state());
@@ -416,25 +510,25 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                         if (it->get_finished()) {
                             INTERNAL_DEBUG("removed1 {} {}", continuableEvt->promiseId, _scopedGenerators.size() - 1);
                             _scopedGenerators.erase(continuableEvt->promiseId);
-                            _scopedEvents.erase(continuableEvt->promiseId);
+                            eraseScopedEvent(continuableEvt->promiseId);
                         }
                     } else {
                         INTERNAL_DEBUG("removed2 {} {}", continuableEvt->promiseId, _scopedGenerators.size() - 1);
                         _scopedGenerators.erase(continuableEvt->promiseId);
-                        _scopedEvents.erase(continuableEvt->promiseId);
+                        eraseScopedEvent(continuableEvt->promiseId);
                     }
                 }
             }
                 break;
-            case RunFunctionEvent::TYPE: {
+            case managerEventType<RunFunctionEvent>(): {
                 INTERNAL_DEBUG("RunFunctionEvent {}", evt->id);
-                auto *runFunctionEvt = static_cast<RunFunctionEvent *>(evt.get());
+                auto *runFunctionEvt = static_cast<RunFunctionEvent *>(evt);
 
                 // Do not handle stale run function events
                 if(runFunctionEvt->originatingService != 0) {
-                    auto requestingServiceIt = _services.find(runFunctionEvt->originatingService);
-                    if(requestingServiceIt != end(_services) && requestingServiceIt->second->getServiceState() == ServiceState::INSTALLED) {
-                        INTERNAL_DEBUG("Service {}:{} not active", runFunctionEvt->originatingService, requestingServiceIt->second->implementationName());
+                    auto *requestingService = findService(runFunctionEvt->originatingService);
+                    if(requestingService != nullptr && requestingService->getServiceState() == ServiceState::INSTALLED) {
+                        INTERNAL_DEBUG("Service {}:{} not active", runFunctionEvt->originatingService, requestingService->implementationName());
                         break;
                     }
                 }
@@ -451,42 +545,76 @@ void Ichor::DependencyManager::processEvent(std::unique_ptr<Event> &&uniqueEvt)
                     INTERNAL_DEBUG("contains2 {} {} {}", it.get_promise_id(), _scopedGenerators.contains(it.get_promise_id()),
                                    _scopedGenerators.size() + 1);
                     _scopedGenerators.emplace(it.get_promise_id(), std::make_unique<AsyncGenerator<void>>(std::move(gen)));
-                    _scopedEvents.emplace(it.get_promise_id(), evt);
+                    _suspendedPromiseIds.push_back(it.get_promise_id());
                 } else {
                     INTERNAL_DEBUG("removed3 {} {}", it.get_promise_id(), _scopedGenerators.size() - 1);
                     _scopedGenerators.erase(it.get_promise_id());
-                    _scopedEvents.erase(it.get_promise_id());
+                    eraseScopedEvent(it.get_promise_id());
                 }
             }
                 break;
             default: {
                 INTERNAL_DEBUG("broadcastEvent {}", evt->id);
-                handlerAmount = broadcastEvent(evt);
+                handlerAmount = broadcastEvent(*evt);
             }
                 break;
         }
     }
 
-    if (interceptorsForAllEvents != end(_eventInterceptors)) {
-        for (EventInterceptInfo const &info : allEventInterceptorsCopy) {
+    if (allEventInterceptors) {
+        for (EventInterceptInfo const &info : *allEventInterceptors) {
+            waitForWorkers(info.listeningServiceId);
             info.postIntercept(*evt, allowProcessing && handlerAmount > 0);
         }
     }
 
-    if (interceptorsForEvent != end(_eventInterceptors)) {
-        for (EventInterceptInfo const &info : eventInterceptorsCopy) {
+    if (eventInterceptors) {
+        for (EventInterceptInfo const &info : *eventInterceptors) {
+            waitForWorkers(info.listeningServiceId);
             info.postIntercept(*evt, allowProcessing && handlerAmount > 0);
         }
     }
 
+    // Suspended handlers and worker handlers still refer to the event, only now pay for shared ownership
+    if(!_suspendedPromiseIds.empty() || !_workerHandlers.empty()) {
+        std::shared_ptr<Event> sharedEvt{std::move(uniqueEvt)};
+        for(uint64_t promiseId : _suspendedPromiseIds) {
+            addScopedEvent(promiseId, sharedEvt);
+        }
+        _suspendedPromiseIds.clear();
+
+        if(!_workerHandlers.empty()) {
+            dispatchToWorkers(std::move(sharedEvt));
+        }
+    }
 }
 
 void Ichor::DependencyManager::stop() {
-    for(auto &[key, manager] : _services) {
+    // waits for the remaining worker handlers, the services they run on are about to stop
+    _workerPool.reset();
+
+    if(!_servicesToStop.empty()) {
+        auto progress = getShutdownProgress();
+        for(uint64_t serviceId : progress.blockingServices) {
+            ICHOR_LOG_ERROR(_logger, "Service {}:{} did not stop in time", serviceId, getImplementationNameFor(serviceId).value_or("unknown"));
+        }
+        if(_onIncompleteShutdown) {
+            _onIncompleteShutdown(progress);
+        }
+    }
+
+    for(auto &manager : _services) {
         auto _ = manager->stop();
     }
 
     _services.clear();
+    _serviceHandles.clear();
+    _servicesProvidingInterface.clear();
+    _servicesProvidingToService.clear();
+    _servicesRequestingInterface.clear();
+    _stopsWaitingForCoroutines.clear();
+    _servicesToStop.clear();
+    _servicesWaitingForStop.clear();
 
     if(_communicationChannel != nullptr) {
         _communicationChannel->removeManager(this);
@@ -496,13 +624,400 @@ void Ichor::DependencyManager::stop() {
     Ichor::Detail::_local_dm = nullptr;
 }
 
+void Ichor::DependencyManager::handleServiceOnline(ILifecycleManager &manager) {
+    if (!manager.setInjected()) {
+        INTERNAL_DEBUG("Couldn't set injected for {} {} {}", manager.serviceId(), manager.implementationName(), manager.getServiceState());
+        return;
+    }
+
+    auto const *filter = manager.getFilter();
+
+    if (filter != nullptr && filter->requiredServiceId()) {
+        // the filter can only match one service, no need to look at the others
+        auto *possibleDependent = findService(*filter->requiredServiceId());
+        if (possibleDependent != nullptr && possibleDependent != &manager && filter->compareTo(*possibleDependent) &&
+            possibleDependent->dependencyOnline(&manager) == Detail::DependencyChange::FOUND_AND_START_ME) {
+            startDependent(manager.serviceId(), possibleDependent->serviceId());
+        }
+        return;
+    }
+
+    // only services that requested one of the interfaces of manager can be interested
+    auto const &interfaces = manager.getInterfaces();
+    for (std::size_t i = 0; i < interfaces.size(); i++) {
+        auto requesting = _servicesRequestingInterface.find(interfaces[i].interfaceNameHash);
+        if (requesting == end(_servicesRequestingInterface)) {
+            continue;
+        }
+
+        // Snapshot because services may be added while injecting
+        auto const handles = requesting->second.snapshot();
+        for (SlotMapHandle handle : *handles) {
+            auto const *possibleDependentLifecycleManager = _services.find(handle);
+            if (possibleDependentLifecycleManager == nullptr) {
+                continue;
+            }
+
+            auto *possibleDependent = possibleDependentLifecycleManager->get();
+            if (possibleDependent == &manager || (filter != nullptr && !filter->compareTo(*possibleDependent))) {
+                continue;
+            }
+
+            // dependencyOnline() handles all interfaces at once, skip services already handled for an earlier interface
+            auto const &registrations = possibleDependent->getDependencyRegistry()->_registrations;
+            if (std::any_of(interfaces.begin(), interfaces.begin() + static_cast<std::ptrdiff_t>(i), [&registrations](Dependency const &interface) { return registrations.contains(interface.interfaceNameHash); })) {
+                continue;
+            }
+
+            if (possibleDependent->dependencyOnline(&manager) == Detail::DependencyChange::FOUND_AND_START_ME) {
+                startDependent(manager.serviceId(), possibleDependent->serviceId());
+            }
+        }
+    }
+}
+
+void Ichor::DependencyManager::handleDependencyRequest(DependencyRequestEvent const &evt) {
+    auto trackers = _dependencyRequestTrackers.find(evt.dependency.interfaceNameHash);
+    if (trackers == end(_dependencyRequestTrackers)) {
+        return;
+    }
+
+    for (DependencyTrackerInfo &info: trackers->second) {
+        info.trackFunc(evt);
+    }
+}
+
+bool Ichor::DependencyManager::beginServiceBatch() {
+    if(_serviceBatch) {
+        return false;
+    }
+
+    _serviceBatch.emplace();
+    return true;
+}
+
+void Ichor::DependencyManager::endServiceBatch() {
+    // pushing may run into code creating services again, which should not end up in this batch
+    ServiceBatch batch = std::move(*_serviceBatch);
+    _serviceBatch.reset();
+
+    if(!batch.startedServices.empty()) {
+        pushPrioritisedEvent<DependencyOnlineBatchEvent>(0, batch.dependencyPriority, std::move(batch.startedServices));
+    }
+
+    if(!batch.servicesToStart.empty()) {
+        pushPrioritisedEvent<StartServiceBatchEvent>(0, INTERNAL_DEPENDENCY_EVENT_PRIORITY, std::move(batch.servicesToStart));
+    }
+
+    if(!batch.requestingServices.empty()) {
+        pushPrioritisedEvent<DependencyRequestBatchEvent>(0, batch.requestPriority, std::move(batch.requestingServices));
+    }
+}
+
+void Ichor::DependencyManager::requestDependencies(ILifecycleManager const &mgr, uint64_t priority) {
+    auto const &registrations = mgr.getDependencyRegistry()->_registrations;
+
+    if(_serviceBatch) {
+        if(!registrations.empty()) {
+            _serviceBatch->requestingServices.push_back(mgr.serviceId());
+            _serviceBatch->requestPriority = std::min(_serviceBatch->requestPriority, priority);
+        }
+        return;
+    }
+
+    for (auto const &[key, registration] : registrations) {
+        auto const &props = std::get<std::optional<Properties>>(registration);
+        pushPrioritisedEvent<DependencyRequestEvent>(mgr.serviceId(), priority, std::get<Dependency>(registration), props.has_value() ? &props.value() : std::optional<Properties const *>{});
+    }
+}
+
+void Ichor::DependencyManager::serviceStarted(uint64_t serviceId, uint64_t priority) {
+    if(_serviceBatch) {
+        _serviceBatch->startedServices.push_back(serviceId);
+        _serviceBatch->dependencyPriority = std::min(_serviceBatch->dependencyPriority, priority);
+        return;
+    }
+
+    pushPrioritisedEvent<DependencyOnlineEvent>(serviceId, priority);
+}
+
+void Ichor::DependencyManager::startDependent(uint64_t originatingServiceId, uint64_t serviceId) {
+    if(_serviceBatch) {
+        _serviceBatch->servicesToStart.emplace_back(originatingServiceId, serviceId);
+        return;
+    }
+
+    pushPrioritisedEvent<StartServiceEvent>(originatingServiceId, INTERNAL_DEPENDENCY_EVENT_PRIORITY, serviceId);
+}
+
+void Ichor::DependencyManager::setShutdownTimeout(std::chrono::milliseconds timeout, std::function<void(ShutdownProgress const &)> onIncompleteShutdown) {
+    _shutdownTimeout = timeout;
+    _onIncompleteShutdown = std::move(onIncompleteShutdown);
+}
+
+Ichor::ShutdownProgress Ichor::DependencyManager::getShutdownProgress() const {
+    ShutdownProgress progress{_servicesToStopDuringShutdown, _servicesStoppedDuringShutdown, {}};
+
+    for(auto const &[serviceId, dependeesToStop] : _servicesToStop) {
+        if(dependeesToStop == 0) {
+            progress.blockingServices.push_back(serviceId);
+        }
+    }
+
+    return progress;
+}
+
+void Ichor::DependencyManager::setWorkerThreadCount(uint32_t count) {
+    if(_started) {
+        throw std::runtime_error("Worker threads have to be set before starting the manager");
+    }
+
+    _workerThreadCount = count;
+}
+
+void Ichor::DependencyManager::stopRemainingServices() {
+    _servicesToStop.reserve(_services.size());
+    for(auto const &manager : _services) {
+        if(manager->getServiceState() != ServiceState::INSTALLED) {
+            _servicesToStop.emplace(manager->serviceId(), 0);
+        }
+    }
+
+    if(_servicesToStop.empty()) {
+        _eventQueue->quit();
+        return;
+    }
+
+    _servicesToStopDuringShutdown += _servicesToStop.size();
+
+    // A service is stopped once every service depending on it stopped. Dependees that are not running are left to the StopServiceEvent itself.
+    for(auto const &manager : _services) {
+        if(manager->getDependees().empty() || manager->getServiceState() == ServiceState::INSTALLED) {
+            continue;
+        }
+
+        auto &dependeesToStop = _servicesToStop[manager->serviceId()];
+        for(uint64_t dependeeId : manager->getDependees()) {
+            if(_servicesToStop.contains(dependeeId)) {
+                dependeesToStop++;
+                _servicesWaitingForStop[dependeeId].push_back(manager->serviceId());
+            }
+        }
+    }
+
+    if(!_servicesWaitingForStop.empty()) {
+        breakDependencyCycles();
+    }
+
+    for(auto const &[serviceId, dependeesToStop] : _servicesToStop) {
+        if(dependeesToStop == 0) {
+            pushPrioritisedEvent<StopServiceEvent>(_shutdownOriginatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, serviceId);
+        }
+    }
+}
+
+void Ichor::DependencyManager::breakDependencyCycles() {
+    // Kahn's algorithm on a copy of the counts, services it cannot reach are part of (or depend on) a cycle.
+    // Those are stopped right away, their StopServiceEvent takes their dependees offline first.
+    std::vector<uint64_t> stopOrder{};
+    unordered_map<uint64_t, uint64_t> remaining{_servicesToStop};
+    for(auto const &[serviceId, dependeesToStop] : remaining) {
+        if(dependeesToStop == 0) {
+            stopOrder.push_back(serviceId);
+        }
+    }
+    for(std::size_t i = 0; i < stopOrder.size(); i++) {
+        auto waiting = _servicesWaitingForStop.find(stopOrder[i]);
+        if(waiting == _servicesWaitingForStop.end()) {
+            continue;
+        }
+        for(uint64_t serviceId : waiting->second) {
+            if(--remaining[serviceId] == 0) {
+                stopOrder.push_back(serviceId);
+            }
+        }
+    }
+    if(stopOrder.size() != remaining.size()) {
+        for(auto const &[serviceId, dependeesToStop] : remaining) {
+            if(dependeesToStop != 0) {
+                _servicesToStop[serviceId] = 0;
+            }
+        }
+    }
+}
+
+void Ichor::DependencyManager::serviceStoppedDuringShutdown(uint64_t serviceId) {
+    auto stopped = _servicesToStop.find(serviceId);
+    if(stopped == _servicesToStop.end()) {
+        return;
+    }
+    _servicesToStop.erase(stopped);
+    _servicesStoppedDuringShutdown++;
+
+    if(auto waiting = _servicesWaitingForStop.find(serviceId); waiting != _servicesWaitingForStop.end()) {
+        for(uint64_t dependencyId : waiting->second) {
+            auto dependency = _servicesToStop.find(dependencyId);
+            // already stopped, or released early because of a cycle
+            if(dependency == _servicesToStop.end() || dependency->second == 0) {
+                continue;
+            }
+            if(--dependency->second == 0) {
+                pushPrioritisedEvent<StopServiceEvent>(_shutdownOriginatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, dependencyId);
+            }
+        }
+        _servicesWaitingForStop.erase(waiting);
+    }
+
+    // services may have been started during the shutdown, check once more before quitting
+    if(_servicesToStop.empty()) {
+        _servicesWaitingForStop.clear();
+        stopRemainingServices();
+    }
+}
+
+bool Ichor::DependencyManager::shutdownTimedOut() const noexcept {
+    auto const deadline = _shutdownDeadline.load(std::memory_order_acquire);
+    return deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= deadline;
+}
+
+void Ichor::DependencyManager::addScopedEvent(uint64_t promiseId, std::shared_ptr<Event> const &evt) {
+    if(_scopedEvents.emplace(promiseId, evt).second) {
+        _scopedEventsPerService[evt->originatingService]++;
+    }
+}
+
+void Ichor::DependencyManager::eraseScopedEvent(uint64_t promiseId) {
+    auto scopedEvt = _scopedEvents.find(promiseId);
+    if(scopedEvt == _scopedEvents.end()) {
+        return;
+    }
+
+    auto const serviceId = scopedEvt->second->originatingService;
+    _scopedEvents.erase(scopedEvt);
+
+    auto count = _scopedEventsPerService.find(serviceId);
+    if(--count->second > 0) {
+        return;
+    }
+    _scopedEventsPerService.erase(count);
+
+    auto waitingStops = _stopsWaitingForCoroutines.find(serviceId);
+    if(waitingStops == _stopsWaitingForCoroutines.end()) {
+        return;
+    }
+
+    for(uint64_t originatingService : waitingStops->second) {
+        pushPrioritisedEvent<StopServiceEvent>(originatingService, INTERNAL_DEPENDENCY_EVENT_PRIORITY, serviceId);
+    }
+    _stopsWaitingForCoroutines.erase(waitingStops);
+}
+
+void Ichor::DependencyManager::indexInterfaces(ILifecycleManager const &mgr, SlotMapHandle handle) {
+    if(auto const *filter = mgr.getFilter(); filter != nullptr && filter->requiredServiceId()) {
+        _servicesProvidingToService[*filter->requiredServiceId()].emplace_back(handle);
+    } else {
+        for(auto const &interface : mgr.getInterfaces()) {
+            _servicesProvidingInterface[interface.interfaceNameHash].emplace_back(handle);
+        }
+    }
+
+    auto const *registry = mgr.getDependencyRegistry();
+    if(registry == nullptr) {
+        return;
+    }
+
+    for(auto const &[interfaceHash, registration] : registry->_registrations) {
+        _servicesRequestingInterface[interfaceHash].emplace_back(handle);
+    }
+}
+
+void Ichor::DependencyManager::unindexInterfaces(ILifecycleManager const &mgr, SlotMapHandle handle) {
+    if(auto const *filter = mgr.getFilter(); filter != nullptr && filter->requiredServiceId()) {
+        if(auto providing = _servicesProvidingToService.find(*filter->requiredServiceId()); providing != end(_servicesProvidingToService)) {
+            providing->second.erase_if([handle](SlotMapHandle h) noexcept { return h == handle; });
+            // service ids are not reused
+            if(providing->second.empty()) {
+                _servicesProvidingToService.erase(providing);
+            }
+        }
+    } else {
+        for(auto const &interface : mgr.getInterfaces()) {
+            if(auto providing = _servicesProvidingInterface.find(interface.interfaceNameHash); providing != end(_servicesProvidingInterface)) {
+                providing->second.erase_if([handle](SlotMapHandle h) noexcept { return h == handle; });
+            }
+        }
+    }
+
+    auto const *registry = mgr.getDependencyRegistry();
+    if(registry == nullptr) {
+        return;
+    }
+
+    for(auto const &[interfaceHash, registration] : registry->_registrations) {
+        if(auto requesting = _servicesRequestingInterface.find(interfaceHash); requesting != end(_servicesRequestingInterface)) {
+            requesting->second.erase_if([handle](SlotMapHandle h) noexcept { return h == handle; });
+        }
+    }
+}
+
+void Ichor::DependencyManager::injectActiveDependencies(ILifecycleManager &requestingMgr) {
+    auto const &registrations = requestingMgr.getDependencyRegistry()->_registrations;
+
+    for(auto registration = registrations.begin(); registration != registrations.end(); ++registration) {
+        auto providing = _servicesProvidingInterface.find(registration->first);
+        if(providing == end(_servicesProvidingInterface)) {
+            continue;
+        }
+
+        // Snapshot because services may be added while injecting
+        auto const handles = providing->second.snapshot();
+        for(SlotMapHandle handle : *handles) {
+            auto const *mgr = _services.find(handle);
+            if(mgr == nullptr || (*mgr)->getServiceState() != ServiceState::ACTIVE) {
+                continue;
+            }
+
+            // dependencyOnline() handles all interfaces at once, skip services already handled for an earlier registration
+            auto const &interfaces = (*mgr)->getInterfaces();
+            if(std::any_of(registrations.begin(), registration, [&interfaces](auto const &earlierRegistration) {
+                return std::any_of(interfaces.begin(), interfaces.end(), [&earlierRegistration](Dependency const &interface) { return interface.interfaceNameHash == earlierRegistration.first; });
+            })) {
+                continue;
+            }
+
+            auto const *filter = (*mgr)->getFilter();
+            if (filter != nullptr && !filter->compareTo(requestingMgr)) {
+                continue;
+            }
+
+            requestingMgr.dependencyOnline(mgr->get());
+        }
+    }
+
+    // services whose filter only matches requestingMgr, dependencyOnline() ignores the interfaces requestingMgr did not request
+    auto providingToService = _servicesProvidingToService.find(requestingMgr.serviceId());
+    if(providingToService == end(_servicesProvidingToService)) {
+        return;
+    }
+
+    auto const handles = providingToService->second.snapshot();
+    for(SlotMapHandle handle : *handles) {
+        auto const *mgr = _services.find(handle);
+        if(mgr == nullptr || (*mgr)->getServiceState() != ServiceState::ACTIVE || !(*mgr)->getFilter()->compareTo(requestingMgr)) {
+            continue;
+        }
+
+        requestingMgr.dependencyOnline(mgr->get());
+    }
+}
+
 void Ichor::DependencyManager::handleEventCompletion(Ichor::Event const &evt) {
     if(evt.originatingService == 0) {
         return;
     }
 
-    auto service = _services.find(evt.originatingService);
-    if(service == end(_services) || (service->second->getServiceState() != ServiceState::ACTIVE && service->second->getServiceState() != ServiceState::INJECTING)) {
+    auto const *service = findService(evt.originatingService);
+    if(service == nullptr || (service->getServiceState() != ServiceState::ACTIVE && service->getServiceState() != ServiceState::INJECTING)) {
         return;
     }
 
@@ -514,27 +1029,45 @@ void Ichor::DependencyManager::handleEventCompletion(Ichor::Event const &evt) {
     callback->second(evt);
 }
 
-uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
-    auto registeredListeners = _eventCallbacks.find(evt->type);
-
-    if(registeredListeners == end(_eventCallbacks)) {
+uint64_t Ichor::DependencyManager::broadcastEvent(Event const &evt) {
+    // processEvent() resolved the index of events not created by a manager
+    if(evt.typeIndex == 0 || evt.typeIndex >= _eventCallbacks.size()) {
         return 0;
     }
 
-    // Make copy because the vector can be modified in the callback() call.
-    std::vector<EventCallbackInfo> callbacksCopy = registeredListeners->second;
+    // Snapshot because the handlers can be modified in the callback() call. Only modifications during dispatch copy the handlers.
+    auto const callbacks = _eventCallbacks[evt.typeIndex].snapshot();
+
+    for(auto const &callbackInfo : *callbacks) {
+        // a stale handle means the service was removed
+        ILifecycleManager const *service{};
+        if(callbackInfo.listeningServiceHandle != SlotMap<std::unique_ptr<ILifecycleManager>>::INVALID_HANDLE) {
+            auto const *mgr = _services.find(callbackInfo.listeningServiceHandle);
+            service = mgr == nullptr ? nullptr : mgr->get();
+        } else {
+            service = findService(callbackInfo.listeningServiceId);
+        }
 
-    for(auto &callbackInfo : callbacksCopy) {
-        auto service = _services.find(callbackInfo.listeningServiceId);
-        if(service == end(_services) || (service->second->getServiceState() != ServiceState::ACTIVE && service->second->getServiceState() != ServiceState::INJECTING)) {
+        if(service == nullptr || (service->getServiceState() != ServiceState::ACTIVE && service->getServiceState() != ServiceState::INJECTING)) {
             continue;
         }
 
-        if(callbackInfo.filterServiceId.has_value() && *callbackInfo.filterServiceId != evt->originatingService) {
+        if(callbackInfo.filterServiceId.has_value() && *callbackInfo.filterServiceId != evt.originatingService) {
+            continue;
+        }
+
+        if(callbackInfo.workerCallback) {
+            if(_workerPool == nullptr) {
+                callbackInfo.workerCallback(evt);
+            } else {
+                _workerHandlers.push_back(&callbackInfo);
+            }
             continue;
         }
 
-        auto gen = callbackInfo.callback(*evt);
+        waitForWorkers(callbackInfo.listeningServiceId);
+
+        auto gen = callbackInfo.callback(evt);
 
         if(!gen.done()) {
             auto it = gen.begin();
@@ -547,8 +1080,8 @@ uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
             }
 
             if(!it.get_finished() && it.get_promise_state() != state::value_not_ready_consumer_active) {
-                pushPrioritisedEvent<ContinuableEvent>(evt->originatingService, evt->priority, it.get_promise_id());
-                _scopedEvents.emplace(it.get_promise_id(), evt);
+                pushPrioritisedEvent<ContinuableEvent>(evt.originatingService, evt.priority, it.get_promise_id());
+                _suspendedPromiseIds.push_back(it.get_promise_id());
             }
 
             if(it.get_finished()) {
@@ -558,7 +1091,27 @@ uint64_t Ichor::DependencyManager::broadcastEvent(std::shared_ptr<Event> &evt) {
         }
     }
 
-    return callbacksCopy.size();
+    if(!_workerHandlers.empty()) {
+        _workerHandlersSnapshot = callbacks;
+    }
+
+    return callbacks->size();
+}
+
+void Ichor::DependencyManager::dispatchToWorkers(std::shared_ptr<Event> &&evt) {
+    auto dispatch = std::make_shared<Detail::WorkerDispatch>(std::move(evt), std::move(_workerHandlersSnapshot));
+    _workerHandlersSnapshot = {};
+
+    for(EventCallbackInfo const *callbackInfo : _workerHandlers) {
+        _workerPool->post(callbackInfo->listeningServiceId, Detail::WorkerTask{dispatch, callbackInfo});
+    }
+    _workerHandlers.clear();
+}
+
+void Ichor::DependencyManager::waitForWorkers(uint64_t serviceId) noexcept {
+    if(_workerPool != nullptr) {
+        _workerPool->waitForService(serviceId);
+    }
 }
 
 void Ichor::DependencyManager::runForOrQueueEmpty(std::chrono::milliseconds ms) const noexcept {
@@ -576,19 +1129,23 @@ void Ichor::DependencyManager::runForOrQueueEmpty(std::chrono::milliseconds ms)
 }
 
 std::optional<std::string_view> Ichor::DependencyManager::getImplementationNameFor(uint64_t serviceId) const noexcept {
-    auto service = _services.find(serviceId);
+    auto const *service = findService(serviceId);
 
-    if(service == end(_services)) {
+    if(service == nullptr) {
         return {};
     }
 
-    return service->second->implementationName();
+    return service->implementationName();
 }
 
 uint64_t Ichor::DependencyManager::getNextEventId() noexcept {
     return _eventIdCounter.fetch_add(1, std::memory_order_acq_rel);
 }
 
+uint64_t Ichor::DependencyManager::getDroppedEventCount() const noexcept {
+    return _droppedEventCount.load(std::memory_order_relaxed);
+}
+
 void Ichor::DependencyManager::setCommunicationChannel(Ichor::CommunicationChannel *channel) {
     _communicationChannel = channel;
 }
@@ -3,4 +3,13 @@
 
 Ichor::DependencyRegister::DependencyRegister(DependencyManager *mng) noexcept : _registrations() {
 
+}
+
+std::shared_ptr<Ichor::ITemplatedFilter const> Ichor::Detail::findFilter(Properties const &properties) {
+    auto const filterProp = properties.find("Filter");
+    if(filterProp == cend(properties)) {
+        return nullptr;
+    }
+
+    return Ichor::any_cast<Filter const &>(filterProp->second)._templatedFilter;
 }
\ No newline at end of file
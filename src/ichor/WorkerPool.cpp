@@ -0,0 +1,236 @@
+#include <ichor/WorkerPool.h>
+#include <ichor/DependencyManager.h>
+
+thread_local Ichor::DependencyManager *Ichor::Detail::_local_worker_dm = nullptr;
+
+namespace Ichor::Detail {
+    WorkerPool::WorkerPool(DependencyManager *dm, uint32_t threadCount) : _dm(dm) {
+        _workers.reserve(threadCount);
+        for(uint32_t i = 0; i < threadCount; i++) {
+            _workers.emplace_back(std::make_unique<Worker>());
+        }
+
+        // only start once all workers exist, they steal from each other
+        for(uint32_t i = 0; i < threadCount; i++) {
+            _workers[i]->thread = std::thread([this, i]() {
+                run(i);
+            });
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        waitForAll();
+
+        _quit.store(true, std::memory_order_release);
+        {
+            std::lock_guard const l(_wakeupMutex);
+            _wakeup.notify_all();
+        }
+
+        for(auto &worker : _workers) {
+            worker->thread.join();
+        }
+    }
+
+    void WorkerPool::post(uint64_t serviceId, WorkerTask &&task) {
+        auto pending = _pending.load(std::memory_order_acquire);
+        while(pending >= MAX_PENDING_TASKS) {
+            _pending.wait(pending, std::memory_order_acquire);
+            pending = _pending.load(std::memory_order_acquire);
+        }
+
+        auto strandIt = _strands.find(serviceId);
+        if(strandIt == _strands.end()) {
+            strandIt = _strands.emplace(serviceId, std::make_unique<Strand>()).first;
+        }
+        auto &strand = *strandIt->second;
+
+        _pending.fetch_add(1, std::memory_order_relaxed);
+        strand.pending.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::lock_guard const l(strand.mutex);
+            strand.tasks.push_back(std::move(task));
+            if(strand.scheduled) {
+                return;
+            }
+            strand.scheduled = true;
+        }
+
+        auto &worker = *_workers[_nextWorker];
+        _nextWorker = (_nextWorker + 1) % static_cast<uint32_t>(_workers.size());
+        {
+            std::lock_guard const l(worker.mutex);
+            worker.strands.push_back(&strand);
+        }
+
+        // seq_cst pairs with run(): either we see the worker sleeping, or the worker sees the queued strand.
+        _queuedStrands.fetch_add(1, std::memory_order_seq_cst);
+        if(_sleepingWorkers.load(std::memory_order_seq_cst) != 0) {
+            wakeWorker();
+        }
+    }
+
+    void WorkerPool::waitForService(uint64_t serviceId) noexcept {
+        auto strand = _strands.find(serviceId);
+        if(strand == _strands.end()) {
+            return;
+        }
+
+        auto &pending = strand->second->pending;
+        auto count = pending.load(std::memory_order_acquire);
+        while(count != 0) {
+            pending.wait(count, std::memory_order_acquire);
+            count = pending.load(std::memory_order_acquire);
+        }
+    }
+
+    void WorkerPool::waitForAll() noexcept {
+        auto pending = _pending.load(std::memory_order_acquire);
+        while(pending != 0) {
+            _pending.wait(pending, std::memory_order_acquire);
+            pending = _pending.load(std::memory_order_acquire);
+        }
+    }
+
+    void WorkerPool::removeService(uint64_t serviceId) noexcept {
+        auto strand = _strands.find(serviceId);
+        if(strand == _strands.end()) {
+            return;
+        }
+
+        waitForService(serviceId);
+
+        // the worker that ran the last task may not have let go of the strand yet
+        while(true) {
+            {
+                std::lock_guard const l(strand->second->mutex);
+                if(!strand->second->scheduled) {
+                    break;
+                }
+            }
+            std::this_thread::yield();
+        }
+
+        _strands.erase(strand);
+    }
+
+    bool WorkerPool::idle() const noexcept {
+        return _pending.load(std::memory_order_acquire) == 0;
+    }
+
+    void WorkerPool::run(uint32_t index) {
+        _local_worker_dm = _dm;
+
+#ifdef __linux__
+        pthread_setname_np(pthread_self(), fmt::format("DepMan #{} W{}", _dm->getId(), index).c_str());
+#endif
+
+        std::vector<WorkerTask> tasks{};
+        while(true) {
+            auto *strand = take(index);
+
+            if(strand != nullptr) {
+                runStrand(*strand, index, tasks);
+                continue;
+            }
+
+            if(_quit.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            std::unique_lock l(_wakeupMutex);
+            _sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            _wakeup.wait_for(l, 500ms, [this]() {
+                return _queuedStrands.load(std::memory_order_seq_cst) != 0 || _quit.load(std::memory_order_acquire);
+            });
+            _sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        _local_worker_dm = nullptr;
+    }
+
+    Strand* WorkerPool::take(uint32_t index) noexcept {
+        if(_queuedStrands.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+
+        // own strands oldest first, stolen strands newest first to stay out of the way of their owner
+        auto const workerCount = static_cast<uint32_t>(_workers.size());
+        for(uint32_t i = 0; i < workerCount; i++) {
+            auto &worker = *_workers[(index + i) % workerCount];
+            std::lock_guard const l(worker.mutex);
+
+            if(worker.strands.empty()) {
+                continue;
+            }
+
+            Strand *strand;
+            if(i == 0) {
+                strand = worker.strands.front();
+                worker.strands.pop_front();
+            } else {
+                strand = worker.strands.back();
+                worker.strands.pop_back();
+            }
+
+            _queuedStrands.fetch_sub(1, std::memory_order_relaxed);
+            return strand;
+        }
+
+        return nullptr;
+    }
+
+    void WorkerPool::runStrand(Strand &strand, uint32_t index, std::vector<WorkerTask> &tasks) {
+        {
+            std::lock_guard const l(strand.mutex);
+            std::swap(tasks, strand.tasks);
+        }
+
+        for(auto const &task : tasks) {
+            // an exception would end the worker thread and leave the task pending forever, keep going with the next task instead
+            try {
+                task.callbackInfo->workerCallback(*task.dispatch->event);
+            } catch(const std::exception &ex) {
+                std::string_view const what = ex.what();
+                ICHOR_LOG_ERROR(_dm->getLogger(), "Worker handler of service {} threw on event {}: \"{}\"", task.callbackInfo->listeningServiceId, task.dispatch->event->name, what);
+            } catch(...) {
+                ICHOR_LOG_ERROR(_dm->getLogger(), "Worker handler of service {} threw an unknown exception on event {}", task.callbackInfo->listeningServiceId, task.dispatch->event->name);
+            }
+        }
+
+        auto const count = static_cast<uint64_t>(tasks.size());
+        // releases events of which all handlers ran
+        tasks.clear();
+
+        if(strand.pending.fetch_sub(count, std::memory_order_acq_rel) == count) {
+            strand.pending.notify_all();
+        }
+        _pending.fetch_sub(count, std::memory_order_acq_rel);
+        _pending.notify_all();
+
+        {
+            std::lock_guard const l(strand.mutex);
+            if(strand.tasks.empty()) {
+                strand.scheduled = false;
+                return;
+            }
+        }
+
+        // more tasks were posted in the meantime, requeue instead of running them right away so other strands get their turn
+        auto &worker = *_workers[index];
+        {
+            std::lock_guard const l(worker.mutex);
+            worker.strands.push_back(&strand);
+        }
+        _queuedStrands.fetch_add(1, std::memory_order_seq_cst);
+        if(_sleepingWorkers.load(std::memory_order_seq_cst) != 0) {
+            wakeWorker();
+        }
+    }
+
+    void WorkerPool::wakeWorker() {
+        std::lock_guard const l(_wakeupMutex);
+        _wakeup.notify_one();
+    }
+}
@@ -0,0 +1,344 @@
+#ifdef __linux__
+
+#include <ichor/event_queues/EpollQueue.h>
+#include <ichor/DependencyManager.h>
+#include <array>
+#include <csignal>
+#include <system_error>
+#include <thread>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace Ichor::Detail {
+    extern std::atomic<bool> sigintQuit;
+    extern std::atomic<bool> registeredSignalHandler;
+    void on_sigint([[maybe_unused]] int sig);
+}
+
+namespace {
+    // epoll data of the eventfd, watches start at 1
+    constexpr uint64_t EVENTFD_ID = 0;
+    constexpr int MAX_READY_FDS = 64;
+
+    [[nodiscard]] uint32_t toEpollEvents(Ichor::FdInterest interest) noexcept {
+        uint32_t events = EPOLLRDHUP;
+        if((static_cast<uint32_t>(interest) & static_cast<uint32_t>(Ichor::FdInterest::READ)) != 0) {
+            events |= EPOLLIN;
+        }
+        if((static_cast<uint32_t>(interest) & static_cast<uint32_t>(Ichor::FdInterest::WRITE)) != 0) {
+            events |= EPOLLOUT;
+        }
+        return events;
+    }
+}
+
+namespace Ichor {
+    EpollQueue::EpollQueue(uint64_t maxEventsBetweenPolls) : _maxEventsBetweenPolls(maxEventsBetweenPolls) {
+        if(_maxEventsBetweenPolls == 0) {
+            throw std::runtime_error("Has to process at least 1 event between polls");
+        }
+
+        _epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if(_epollFd < 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_create1() failed");
+        }
+
+        _eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(_eventFd < 0) {
+            auto const err = errno;
+            close(_epollFd);
+            throw std::system_error(err, std::generic_category(), "eventfd() failed");
+        }
+
+        epoll_event evt{};
+        evt.events = EPOLLIN;
+        evt.data.u64 = EVENTFD_ID;
+        if(epoll_ctl(_epollFd, EPOLL_CTL_ADD, _eventFd, &evt) < 0) {
+            auto const err = errno;
+            close(_eventFd);
+            close(_epollFd);
+            throw std::system_error(err, std::generic_category(), "epoll_ctl() failed");
+        }
+
+        _readyWatches.reserve(MAX_READY_FDS);
+        _readiness.reserve(MAX_READY_FDS);
+    }
+
+    EpollQueue::~EpollQueue() {
+        // services may still remove their watches when they are destroyed, so destroy them before the watches
+        stopDm();
+        _eventQueue.clear();
+        destroyDm();
+
+        close(_eventFd);
+        close(_epollFd);
+
+        if(Detail::registeredSignalHandler) {
+            if (::signal(SIGINT, SIG_DFL) == SIG_ERR) {
+                fmt::print("Couldn't unset signal handler\n");
+            }
+        }
+    }
+
+    PushResult EpollQueue::pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        if(!event) {
+            throw std::runtime_error("Pushing nullptr");
+        }
+
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        {
+            std::lock_guard const l(_eventQueueMutex);
+            _eventQueue.emplace(priority, std::move(event));
+        }
+        wakeSleepingConsumer();
+
+        return PushResult::QUEUED;
+    }
+
+    PushResult EpollQueue::pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        auto const result = pushToMailbox(priority, std::move(event));
+
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
+    }
+
+    PushResult EpollQueue::pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        auto const result = pushToTimerMailbox(deadline, priority, std::move(event));
+
+        // the consumer may be sleeping until a later deadline
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
+    }
+
+    uint64_t EpollQueue::addFd(int fd, FdInterest interest, std::function<void(FdReadiness)> onReady) {
+        if(!onReady) {
+            throw std::runtime_error("No callback set.");
+        }
+
+        uint64_t const id = _nextWatchId++;
+
+        epoll_event evt{};
+        evt.events = toEpollEvents(interest);
+        evt.data.u64 = id;
+        if(epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &evt) < 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl() failed");
+        }
+
+        _watches.emplace(id, std::make_shared<FdWatch>(FdWatch{fd, false, std::move(onReady)}));
+
+        return id;
+    }
+
+    void EpollQueue::modifyFd(uint64_t id, FdInterest interest) {
+        auto watch = _watches.find(id);
+        if(watch == _watches.end()) {
+            throw std::runtime_error("Unknown fd watch");
+        }
+
+        epoll_event evt{};
+        evt.events = toEpollEvents(interest);
+        evt.data.u64 = id;
+        if(epoll_ctl(_epollFd, EPOLL_CTL_MOD, watch->second->fd, &evt) < 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_ctl() failed");
+        }
+    }
+
+    void EpollQueue::removeFd(uint64_t id) {
+        auto watch = _watches.find(id);
+        if(watch == _watches.end()) {
+            return;
+        }
+
+        // the fd may already be closed, in which case the kernel already removed it
+        epoll_ctl(_epollFd, EPOLL_CTL_DEL, watch->second->fd, nullptr);
+
+        // the watch may be running or about to run in poll(), which holds on to it until it's done
+        watch->second->removed = true;
+        _watches.erase(watch);
+    }
+
+    bool EpollQueue::empty() const noexcept {
+        std::lock_guard const l(_eventQueueMutex);
+        return _eventQueue.empty() && mailboxSize() == 0;
+    }
+
+    uint64_t EpollQueue::size() const noexcept {
+        std::lock_guard const l(_eventQueueMutex);
+        return _eventQueue.size() + mailboxSize();
+    }
+
+    void EpollQueue::start(bool captureSigInt) {
+        if(!_dm) {
+            throw std::runtime_error("Please create a manager first!");
+        }
+
+        if(captureSigInt && !Ichor::Detail::registeredSignalHandler.exchange(true)) {
+            if (::signal(SIGINT, Ichor::Detail::on_sigint) == SIG_ERR) {
+                throw std::runtime_error("Couldn't set signal");
+            }
+        }
+
+        startDm();
+
+        while(!shouldQuit()) {
+            bool idle;
+            {
+                std::lock_guard const l(_eventQueueMutex);
+                moveMailboxAndTimerEvents();
+                shouldAddQuitEvent();
+                idle = _eventQueue.empty();
+            }
+
+            if(shouldQuit()) {
+                break;
+            }
+
+            if(idle) {
+                // seq_cst pairs with wakeSleepingConsumer(): either the producer sees us sleeping and wakes us through the eventfd, or we see its event here.
+                _consumerSleeping.store(true, std::memory_order_seq_cst);
+                bool stillIdle;
+                {
+                    std::lock_guard const l(_eventQueueMutex);
+                    stillIdle = _eventQueue.empty() && mailboxSize() == 0 && timerMailboxSize() == 0;
+                }
+                poll(stillIdle ? timeUntilNextTimer(500ms) : std::chrono::nanoseconds{0});
+                _consumerSleeping.store(false, std::memory_order_relaxed);
+                if(!stillIdle) {
+                    // the mailboxes were just drained, a producer may be between counting and linking its event, let it finish instead of spinning
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+
+            // no need for a syscall per batch if nothing is watched
+            if(!_watches.empty()) {
+                poll(std::chrono::nanoseconds{0});
+            }
+
+            for(uint64_t i = 0; i < _maxEventsBetweenPolls && !shouldQuit(); i++) {
+                std::unique_lock l(_eventQueueMutex);
+                if(i != 0) {
+                    moveMailboxAndTimerEvents();
+                }
+
+                if(_eventQueue.empty()) {
+                    break;
+                }
+
+                auto node = _eventQueue.extract(_eventQueue.begin());
+                l.unlock();
+                releaseCapacity(*node.mapped());
+                processEvent(std::move(node.mapped()));
+            }
+        }
+
+        stopDm();
+    }
+
+    void EpollQueue::poll(std::chrono::nanoseconds timeout) {
+        std::array<epoll_event, MAX_READY_FDS> events{};
+        // epoll_wait() takes milliseconds, round up so that delayed events are not woken up for too early
+        auto const timeoutMs = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+
+        int const ready = epoll_wait(_epollFd, events.data(), MAX_READY_FDS, timeoutMs);
+        if(ready < 0) {
+            if(errno == EINTR) {
+                return;
+            }
+            throw std::system_error(errno, std::generic_category(), "epoll_wait() failed");
+        }
+
+        // collect the watches first, their callbacks may add or remove watches
+        for(int i = 0; i < ready; i++) {
+            auto const &evt = events[static_cast<uint64_t>(i)];
+
+            if(evt.data.u64 == EVENTFD_ID) {
+                uint64_t val;
+                [[maybe_unused]] auto n = read(_eventFd, &val, sizeof(val));
+                _wakeupPending.store(false, std::memory_order_release);
+                continue;
+            }
+
+            auto watch = _watches.find(evt.data.u64);
+            if(watch == _watches.end()) {
+                continue;
+            }
+
+            _readyWatches.push_back(watch->second);
+            _readiness.push_back(FdReadiness{
+                (evt.events & (EPOLLIN | EPOLLPRI)) != 0,
+                (evt.events & EPOLLOUT) != 0,
+                (evt.events & (EPOLLHUP | EPOLLRDHUP | EPOLLERR)) != 0
+            });
+        }
+
+        for(uint64_t i = 0; i < _readyWatches.size(); i++) {
+            if(!_readyWatches[i]->removed) {
+                _readyWatches[i]->onReady(_readiness[i]);
+            }
+        }
+
+        _readyWatches.clear();
+        _readiness.clear();
+    }
+
+    void EpollQueue::moveMailboxAndTimerEvents() {
+        auto insert = [this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            _eventQueue.emplace(priority, std::move(event));
+        };
+        drainMailbox(insert);
+        expireTimers(insert);
+    }
+
+    void EpollQueue::wakeSleepingConsumer() {
+        // only the first producer to see the consumer sleeping pays for the write
+        if(_consumerSleeping.load(std::memory_order_seq_cst) && !_wakeupPending.exchange(true, std::memory_order_acq_rel)) {
+            uint64_t val = 1;
+            [[maybe_unused]] auto n = write(_eventFd, &val, sizeof(val));
+        }
+    }
+
+    bool EpollQueue::shouldQuit() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if (shouldQuit && _quitEventSent && std::chrono::steady_clock::now() - _whenQuitEventWasSent >= 500ms) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        if (shutdownTimedOut()) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        return _quit.load(std::memory_order_acquire);
+    }
+
+    void EpollQueue::shouldAddQuitEvent() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if(shouldQuit && !_quitEventSent) {
+            // assume _eventQueueMutex is locked
+            _eventQueue.emplace(INTERNAL_EVENT_PRIORITY, std::make_unique<QuitEvent>(_dm->getNextEventId(), 0, INTERNAL_EVENT_PRIORITY));
+            _quitEventSent = true;
+            _whenQuitEventWasSent = std::chrono::steady_clock::now();
+        }
+    }
+
+    void EpollQueue::quit() {
+        _quit.store(true, std::memory_order_release);
+
+        uint64_t val = 1;
+        [[maybe_unused]] auto n = write(_eventFd, &val, sizeof(val));
+    }
+}
+
+#endif
@@ -1,5 +1,9 @@
 #include <ichor/event_queues/IEventQueue.h>
 #include <ichor/DependencyManager.h>
+#include <ichor/events/ContinuableEvent.h>
+#include <ichor/stl/RealtimeMutex.h>
+#include <ichor/stl/ConditionVariable.h>
+#include <algorithm>
 #include <atomic>
 
 namespace Ichor::Detail {
@@ -9,10 +13,78 @@ namespace Ichor::Detail {
     void on_sigint([[maybe_unused]] int sig) {
         Ichor::Detail::sigintQuit.store(true, std::memory_order_release);
     }
+
+    struct PriorityLimit final {
+        explicit PriorityLimit(uint64_t _max) noexcept : max(_max) {}
+
+        const uint64_t max;
+        std::atomic<uint64_t> queued{};
+    };
+
+    struct EventQueueLimiter final {
+        explicit EventQueueLimiter(EventQueueCapacity _capacity) : capacity(std::move(_capacity)) {
+            for(auto const &[priority, max] : capacity.maxEventsPerPriority) {
+                limits.emplace(priority, std::make_unique<PriorityLimit>(max));
+            }
+        }
+
+        EventQueueCapacity capacity;
+        // only modified in the constructor, lookups from multiple threads are fine
+        unordered_map<uint64_t, std::unique_ptr<PriorityLimit>> limits{};
+        std::atomic<uint64_t> queued{};
+        std::atomic<bool> aboveHighWaterMark{};
+        std::atomic<bool> running{};
+        std::atomic<uint64_t> blockedProducers{};
+        RealtimeMutex roomMutex{};
+        ConditionVariable roomAvailable{};
+    };
+
+    // Events of the framework itself. Dropping or delaying them would leave coroutines suspended forever or services half started, so they are never limited nor counted.
+    [[nodiscard]] static bool isUnlimitedEvent(Event const &event) noexcept {
+        switch(event.type) {
+            case QuitEvent::TYPE:
+            case QueueHighWaterMarkEvent::TYPE:
+            case QueueLowWaterMarkEvent::TYPE:
+            case ContinuableEvent::TYPE:
+            case DependencyOnlineEvent::TYPE:
+            case DependencyOfflineEvent::TYPE:
+            case DependencyRequestEvent::TYPE:
+            case DependencyUndoRequestEvent::TYPE:
+            case DependencyOnlineBatchEvent::TYPE:
+            case DependencyRequestBatchEvent::TYPE:
+            case StartServiceEvent::TYPE:
+            case StartServiceBatchEvent::TYPE:
+            case StopServiceEvent::TYPE:
+            case RemoveServiceEvent::TYPE:
+            case DoWorkEvent::TYPE:
+            case RemoveCompletionCallbacksEvent::TYPE:
+            case RemoveEventHandlerEvent::TYPE:
+            case RemoveEventInterceptorEvent::TYPE:
+            case RemoveTrackerEvent::TYPE:
+                return true;
+            default:
+                return false;
+        }
+    }
 }
 
 namespace Ichor {
+    IEventQueue::IEventQueue() noexcept = default;
+
+    IEventQueue::IEventQueue(bool storesEventsInline) noexcept : _storesEventsInline(storesEventsInline) {}
+
     IEventQueue::~IEventQueue() {
+        destroyDm();
+    }
+
+    void IEventQueue::destroyDm() noexcept {
+        // unprocessed events may use the allocator of the manager
+        drainMailbox([](uint64_t, std::unique_ptr<Event, EventDeleter> &&) {});
+        TimerMailboxEvent timerEvent{};
+        while(_timerMailbox.pop(timerEvent)) {
+            _timerMailboxSize.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        _timerWheel.clear();
         _dm = nullptr;
     }
 
@@ -23,15 +95,206 @@ namespace Ichor {
         return *_dm;
     }
 
+    void IEventQueue::setCapacity(EventQueueCapacity capacity) {
+        if(capacity.highWaterMark != 0 && capacity.lowWaterMark >= capacity.highWaterMark) {
+            throw std::runtime_error("Low water mark has to be lower than the high water mark");
+        }
+
+        // queued events reserved capacity with the old limits and would be released against the new ones
+        if(!empty() || (_dm && _dm->isRunning())) {
+            throw std::runtime_error("Capacity has to be set before events are pushed and before the queue is started");
+        }
+
+        _limiter = std::make_unique<Detail::EventQueueLimiter>(std::move(capacity));
+    }
+
+    bool IEventQueue::isAboveHighWaterMark() const noexcept {
+        return _limiter && _limiter->aboveHighWaterMark.load(std::memory_order_acquire);
+    }
+
     void IEventQueue::startDm() {
+        if(_limiter) {
+            _limiter->running.store(true, std::memory_order_release);
+        }
         _dm->start();
     }
 
-    void IEventQueue::processEvent(std::unique_ptr<Event> &&evt) {
+    void IEventQueue::processEvent(std::unique_ptr<Event, EventDeleter> &&evt) {
         _dm->processEvent(std::move(evt));
     }
 
+    PushResult IEventQueue::pushInlineEvent([[maybe_unused]] uint64_t priority, [[maybe_unused]] EventStackUniquePtr &&event) {
+        throw std::runtime_error("This queue does not store events inline");
+    }
+
+    uint64_t IEventQueue::addFd([[maybe_unused]] int fd, [[maybe_unused]] FdInterest interest, [[maybe_unused]] std::function<void(FdReadiness)> onReady) {
+        throw std::runtime_error("This queue does not support file descriptors");
+    }
+
+    void IEventQueue::modifyFd([[maybe_unused]] uint64_t id, [[maybe_unused]] FdInterest interest) {
+        throw std::runtime_error("This queue does not support file descriptors");
+    }
+
+    void IEventQueue::removeFd([[maybe_unused]] uint64_t id) {
+        throw std::runtime_error("This queue does not support file descriptors");
+    }
+
+    PushResult IEventQueue::pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        return pushEvent(priority, std::move(event));
+    }
+
+    PushResult IEventQueue::pushDelayedEvent([[maybe_unused]] std::chrono::steady_clock::time_point deadline, [[maybe_unused]] uint64_t priority, [[maybe_unused]] std::unique_ptr<Event, EventDeleter> &&event) {
+        throw std::runtime_error("This queue does not support delayed events");
+    }
+
+    PushResult IEventQueue::pushToTimerMailbox(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        if(!event) {
+            throw std::runtime_error("Pushing nullptr");
+        }
+
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        _timerMailboxSize.fetch_add(1, std::memory_order_seq_cst);
+        _timerMailbox.push(TimerMailboxEvent{deadline, priority, std::move(event)});
+
+        return PushResult::QUEUED;
+    }
+
+    std::chrono::nanoseconds IEventQueue::timeUntilNextTimer(std::chrono::nanoseconds maxWait) const noexcept {
+        auto const deadline = _timerWheel.nextDeadline();
+        if(!deadline) {
+            return maxWait;
+        }
+
+        auto const now = std::chrono::steady_clock::now();
+        if(*deadline <= now) {
+            return std::chrono::nanoseconds{0};
+        }
+
+        return std::min<std::chrono::nanoseconds>(maxWait, *deadline - now);
+    }
+
+    PushResult IEventQueue::pushToMailbox(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        if(!event) {
+            throw std::runtime_error("Pushing nullptr");
+        }
+
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        // counted before it is linked, so the consumer keeps looking until the producer finished pushing
+        _mailboxSize.fetch_add(1, std::memory_order_seq_cst);
+        _mailbox.push(MailboxEvent{priority, std::move(event)});
+
+        return PushResult::QUEUED;
+    }
+
     void IEventQueue::stopDm() {
+        if(_limiter) {
+            // release blocked producers, the event loop won't make room for them anymore
+            _limiter->running.store(false, std::memory_order_seq_cst);
+            std::lock_guard const l(_limiter->roomMutex);
+            _limiter->roomAvailable.notify_all();
+        }
         _dm->stop();
     }
+
+    bool IEventQueue::shutdownTimedOut() const noexcept {
+        return _dm && _dm->shutdownTimedOut();
+    }
+
+    bool IEventQueue::reserveCapacity(Event const &event) {
+        if(!_limiter || Detail::isUnlimitedEvent(event)) {
+            return true;
+        }
+
+        auto &limiter = *_limiter;
+        auto limitIt = limiter.limits.find(event.priority);
+
+        if(limitIt != limiter.limits.end()) {
+            auto &limit = *limitIt->second;
+            uint64_t queued = limit.queued.load(std::memory_order_acquire);
+
+            while(true) {
+                if(queued < limit.max) {
+                    if(limit.queued.compare_exchange_weak(queued, queued + 1, std::memory_order_seq_cst)) {
+                        break;
+                    }
+                    continue;
+                }
+
+                // The thread running the event loop can never wait for itself to make room, neither can its workers as it may be waiting for them.
+                // Neither may they drop events, the framework continues coroutines and starts services from their pushes without checking the result.
+                if(Detail::_local_dm == _dm.get() || Detail::_local_worker_dm == _dm.get()) {
+                    limit.queued.fetch_add(1, std::memory_order_seq_cst);
+                    break;
+                }
+
+                auto const behaviour = limiter.capacity.overflowPolicy ? limiter.capacity.overflowPolicy(event) : limiter.capacity.whenFull;
+
+                if(behaviour == QueueFullBehaviour::FAIL) {
+                    return false;
+                }
+
+                // Nobody can wait before the event loop has started.
+                if(behaviour == QueueFullBehaviour::INSERT || !limiter.running.load(std::memory_order_acquire)) {
+                    limit.queued.fetch_add(1, std::memory_order_seq_cst);
+                    break;
+                }
+
+                // seq_cst pairs with releaseCapacity(): either it sees us as blocked, or we see the room it made.
+                limiter.blockedProducers.fetch_add(1, std::memory_order_seq_cst);
+                {
+                    std::unique_lock l(limiter.roomMutex);
+                    limiter.roomAvailable.wait_for(l, 100ms, [&limit, &limiter]() {
+                        return limit.queued.load(std::memory_order_seq_cst) < limit.max || !limiter.running.load(std::memory_order_seq_cst);
+                    });
+                }
+                limiter.blockedProducers.fetch_sub(1, std::memory_order_seq_cst);
+
+                // the event loop stopped, the event is discarded together with the rest of the queue
+                if(!limiter.running.load(std::memory_order_acquire)) {
+                    limit.queued.fetch_add(1, std::memory_order_seq_cst);
+                    break;
+                }
+
+                queued = limit.queued.load(std::memory_order_acquire);
+            }
+        }
+
+        uint64_t const queued = limiter.queued.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+        if(limiter.capacity.highWaterMark != 0 && queued >= limiter.capacity.highWaterMark && !limiter.aboveHighWaterMark.load(std::memory_order_acquire) && !limiter.aboveHighWaterMark.exchange(true, std::memory_order_acq_rel)) {
+            pushEvent(INTERNAL_DEPENDENCY_EVENT_PRIORITY, std::make_unique<QueueHighWaterMarkEvent>(_dm->getNextEventId(), 0, INTERNAL_DEPENDENCY_EVENT_PRIORITY, queued));
+        }
+
+        return true;
+    }
+
+    void IEventQueue::releaseCapacity(Event const &event) {
+        if(!_limiter || Detail::isUnlimitedEvent(event)) {
+            return;
+        }
+
+        auto &limiter = *_limiter;
+        auto limitIt = limiter.limits.find(event.priority);
+
+        if(limitIt != limiter.limits.end()) {
+            limitIt->second->queued.fetch_sub(1, std::memory_order_seq_cst);
+
+            if(limiter.blockedProducers.load(std::memory_order_seq_cst) > 0) {
+                std::lock_guard const l(limiter.roomMutex);
+                limiter.roomAvailable.notify_all();
+            }
+        }
+
+        uint64_t const queued = limiter.queued.fetch_sub(1, std::memory_order_acq_rel) - 1;
+
+        if(limiter.capacity.highWaterMark != 0 && queued <= limiter.capacity.lowWaterMark && limiter.aboveHighWaterMark.load(std::memory_order_acquire) && limiter.aboveHighWaterMark.exchange(false, std::memory_order_acq_rel)) {
+            pushEvent(INTERNAL_DEPENDENCY_EVENT_PRIORITY, std::make_unique<QueueLowWaterMarkEvent>(_dm->getNextEventId(), 0, INTERNAL_DEPENDENCY_EVENT_PRIORITY, queued));
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include <ichor/event_queues/InlineEventQueue.h>
+#include <ichor/DependencyManager.h>
+#include <algorithm>
+#include <csignal>
+#include <thread>
+
+namespace Ichor::Detail {
+    extern std::atomic<bool> sigintQuit;
+    extern std::atomic<bool> registeredSignalHandler;
+    void on_sigint([[maybe_unused]] int sig);
+}
+
+namespace {
+    // std::push_heap and friends build a max heap, invert the comparison to get the lowest priority on top
+    template <typename T>
+    [[nodiscard]] bool processedLater(T const &lhs, T const &rhs) noexcept {
+        return lhs.priority > rhs.priority || (lhs.priority == rhs.priority && lhs.sequence > rhs.sequence);
+    }
+}
+
+namespace Ichor {
+    InlineEventQueue::InlineEventQueue(uint32_t slotsPerChunk) : IEventQueue(true), _slotsPerChunk(slotsPerChunk) {
+        if(_slotsPerChunk == 0) {
+            throw std::runtime_error("Slots per chunk has to be at least 1");
+        }
+    }
+
+    InlineEventQueue::~InlineEventQueue() {
+        stopDm();
+        // queued events may have been allocated by the manager, destroy them before the manager
+        {
+            std::lock_guard const l(_eventQueueMutex);
+            _eventQueue.clear();
+        }
+        // Events kept alive by suspended handlers give their slot back to this queue, destroy the manager while the slots still exist.
+        destroyDm();
+
+        if(Detail::registeredSignalHandler) {
+            if (::signal(SIGINT, SIG_DFL) == SIG_ERR) {
+                fmt::print("Couldn't unset signal handler\n");
+            }
+        }
+    }
+
+    PushResult InlineEventQueue::pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        if(!event) {
+            throw std::runtime_error("Pushing nullptr");
+        }
+
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        {
+            std::lock_guard const l(_eventQueueMutex);
+            insert(QueuedEvent{priority, _sequence++, NO_SLOT, std::move(event)});
+        }
+        _wakeup.notify_all();
+
+        return PushResult::QUEUED;
+    }
+
+    PushResult InlineEventQueue::pushInlineEvent(uint64_t priority, EventStackUniquePtr &&event) {
+        if(event.empty()) {
+            throw std::runtime_error("Pushing empty event");
+        }
+
+        if(!reserveCapacity(*event.get())) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        {
+            std::lock_guard const l(_eventQueueMutex);
+            uint32_t const slot = acquireSlot();
+            slotAt(slot) = std::move(event);
+            insert(QueuedEvent{priority, _sequence++, slot, nullptr});
+        }
+        _wakeup.notify_all();
+
+        return PushResult::QUEUED;
+    }
+
+    PushResult InlineEventQueue::pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        // A sleeping consumer has to be woken up under the lock anyway, insert directly instead of making it drain the mailbox after waking up.
+        // Only with an empty mailbox though, earlier events of this producer may still be in there.
+        if(_consumerSleeping.load(std::memory_order_seq_cst) && mailboxSize() == 0) {
+            return pushEvent(priority, std::move(event));
+        }
+
+        auto const result = pushToMailbox(priority, std::move(event));
+
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
+    }
+
+    PushResult InlineEventQueue::pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        auto const result = pushToTimerMailbox(deadline, priority, std::move(event));
+
+        // the consumer may be sleeping until a later deadline
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
+    }
+
+    bool InlineEventQueue::empty() const noexcept {
+        std::lock_guard const l(_eventQueueMutex);
+        return _eventQueue.empty() && mailboxSize() == 0;
+    }
+
+    uint64_t InlineEventQueue::size() const noexcept {
+        std::lock_guard const l(_eventQueueMutex);
+        return _eventQueue.size() + mailboxSize();
+    }
+
+    void InlineEventQueue::start(bool captureSigInt) {
+        if(!_dm) {
+            throw std::runtime_error("Please create a manager first!");
+        }
+
+        if(captureSigInt && !Ichor::Detail::registeredSignalHandler.exchange(true)) {
+            if (::signal(SIGINT, Ichor::Detail::on_sigint) == SIG_ERR) {
+                throw std::runtime_error("Couldn't set signal");
+            }
+        }
+
+        startDm();
+
+        while(!shouldQuit()) {
+            std::unique_lock l(_eventQueueMutex);
+            moveMailboxEvents();
+            moveExpiredTimers();
+            while(!shouldQuit() && _eventQueue.empty()) {
+                _consumerSleeping.store(true, std::memory_order_seq_cst);
+                _wakeup.wait_for(l, timeUntilNextTimer(500ms), [this]() {
+                    shouldAddQuitEvent();
+                    return shouldQuit() || !_eventQueue.empty() || mailboxSize() != 0 || timerMailboxSize() != 0;
+                });
+                _consumerSleeping.store(false, std::memory_order_relaxed);
+                moveExpiredTimers();
+                // the timer mailbox was just drained completely, so anything left in it is still being linked as well
+                if((moveMailboxEvents() == 0 && mailboxSize() != 0) || timerMailboxSize() != 0) {
+                    // a producer is between counting and linking its event, let it finish instead of spinning
+                    l.unlock();
+                    std::this_thread::yield();
+                    l.lock();
+                }
+            }
+
+            shouldAddQuitEvent();
+
+            if(shouldQuit()) {
+                break;
+            }
+
+            std::pop_heap(_eventQueue.begin(), _eventQueue.end(), processedLater<QueuedEvent>);
+            QueuedEvent next = std::move(_eventQueue.back());
+            _eventQueue.pop_back();
+            // producers may add chunks, look up the slot while locked
+            Event *evt = next.slot == NO_SLOT ? nullptr : slotAt(next.slot).get();
+            l.unlock();
+
+            if(next.slot == NO_SLOT) {
+                releaseCapacity(*next.heapEvent);
+                processEvent(std::move(next.heapEvent));
+                continue;
+            }
+
+            // The slot stays in use until the manager destroys the event, which is after any suspended handler finished.
+            releaseCapacity(*evt);
+            processEvent(std::unique_ptr<Event, EventDeleter>{evt, EventDeleter{this, next.slot}});
+        }
+
+        stopDm();
+    }
+
+    bool InlineEventQueue::shouldQuit() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if (shouldQuit && _quitEventSent && std::chrono::steady_clock::now() - _whenQuitEventWasSent >= 500ms) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        if (shutdownTimedOut()) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        return _quit.load(std::memory_order_acquire);
+    }
+
+    void InlineEventQueue::quit() {
+        _quit.store(true, std::memory_order_release);
+    }
+
+    void InlineEventQueue::insert(QueuedEvent &&event) {
+        _eventQueue.push_back(std::move(event));
+        std::push_heap(_eventQueue.begin(), _eventQueue.end(), processedLater<QueuedEvent>);
+    }
+
+    uint32_t InlineEventQueue::acquireSlot() {
+        if(_freeSlots.empty()) {
+            auto const firstSlot = static_cast<uint32_t>(_chunks.size() * _slotsPerChunk);
+            _chunks.emplace_back(std::make_unique<EventStackUniquePtr[]>(_slotsPerChunk));
+            _freeSlots.reserve(_freeSlots.size() + _slotsPerChunk);
+            // hand out the lowest slots first
+            for(uint32_t i = _slotsPerChunk; i > 0; i--) {
+                _freeSlots.push_back(firstSlot + i - 1);
+            }
+        }
+
+        uint32_t const slot = _freeSlots.back();
+        _freeSlots.pop_back();
+        return slot;
+    }
+
+    EventStackUniquePtr& InlineEventQueue::slotAt(uint32_t slot) noexcept {
+        return _chunks[slot / _slotsPerChunk][slot % _slotsPerChunk];
+    }
+
+    void InlineEventQueue::release([[maybe_unused]] Event *evt, uint32_t slot) noexcept {
+        std::lock_guard const l(_eventQueueMutex);
+        slotAt(slot).reset();
+        _freeSlots.push_back(slot);
+    }
+
+    uint64_t InlineEventQueue::moveMailboxEvents() {
+        return drainMailbox([this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            insert(QueuedEvent{priority, _sequence++, NO_SLOT, std::move(event)});
+        });
+    }
+
+    uint64_t InlineEventQueue::moveExpiredTimers() {
+        return expireTimers([this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            insert(QueuedEvent{priority, _sequence++, NO_SLOT, std::move(event)});
+        });
+    }
+
+    void InlineEventQueue::wakeSleepingConsumer() {
+        // seq_cst pairs with the store to _consumerSleeping in start(): either we see the consumer sleeping, or the consumer sees our event.
+        // Taking the lock once makes sure the consumer is not between checking for events and waiting, notifying after releasing it saves the consumer from waking up to a locked mutex.
+        if(_consumerSleeping.load(std::memory_order_seq_cst)) {
+            {
+                std::lock_guard const l(_eventQueueMutex);
+            }
+            _wakeup.notify_all();
+        }
+    }
+
+    void InlineEventQueue::shouldAddQuitEvent() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if(shouldQuit && !_quitEventSent) {
+            // assume _eventQueueMutex is locked
+            insert(QueuedEvent{INTERNAL_EVENT_PRIORITY, _sequence++, NO_SLOT, std::make_unique<QuitEvent>(_dm->getNextEventId(), 0, INTERNAL_EVENT_PRIORITY)});
+            _quitEventSent = true;
+            _whenQuitEventWasSent = std::chrono::steady_clock::now();
+        }
+    }
+}
@@ -0,0 +1,600 @@
+#ifdef ICHOR_USE_LIBURING
+
+#include <ichor/event_queues/IoUringQueue.h>
+#include <ichor/coroutines/AsyncManualResetEvent.h>
+#include <array>
+#include <csignal>
+#include <system_error>
+#include <thread>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace Ichor::Detail {
+    extern std::atomic<bool> sigintQuit;
+    extern std::atomic<bool> registeredSignalHandler;
+    void on_sigint([[maybe_unused]] int sig);
+}
+
+namespace {
+    // user data of the eventfd read, the slot map never hands out 0
+    constexpr uint64_t EVENTFD_ID = 0;
+    // user data of cancellations, whose completions are not interesting
+    constexpr uint64_t IGNORED_ID = std::numeric_limits<uint64_t>::max();
+    constexpr int RECV_BUFFER_GROUP = 0;
+    constexpr unsigned MAX_COMPLETIONS = 64;
+}
+
+namespace Ichor {
+    IoUringQueue::IoUringQueue(uint32_t entries, uint64_t maxEventsBetweenCompletions, uint32_t recvBufferCount, uint32_t recvBufferSize) :
+            _maxEventsBetweenCompletions(maxEventsBetweenCompletions), _recvBufferCount(recvBufferCount), _recvBufferSize(recvBufferSize) {
+        if(_maxEventsBetweenCompletions == 0) {
+            throw std::runtime_error("Has to process at least 1 event between completions");
+        }
+
+        // buffer ids are 16 bits and the kernel requires a power of 2
+        if(_recvBufferCount == 0 || _recvBufferCount > 32768 || (_recvBufferCount & (_recvBufferCount - 1)) != 0) {
+            throw std::runtime_error("Amount of receive buffers has to be a power of 2, at most 32768");
+        }
+
+        if(_recvBufferSize == 0) {
+            throw std::runtime_error("Receive buffers cannot be empty");
+        }
+
+        // only the thread running the event loop uses the ring, so completions can wait until it enters the kernel anyway
+        io_uring_params params{};
+        params.flags = IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+        int ret = io_uring_queue_init_params(entries, &_ring, &params);
+        if(ret == -EINVAL) {
+            // kernels older than 5.19
+            params = {};
+            ret = io_uring_queue_init_params(entries, &_ring, &params);
+        }
+        if(ret < 0) {
+            throw std::system_error(-ret, std::generic_category(), "io_uring_queue_init_params() failed");
+        }
+        _ringInitialized = true;
+
+        _eventFd = eventfd(0, EFD_CLOEXEC);
+        if(_eventFd < 0) {
+            auto const err = errno;
+            io_uring_queue_exit(&_ring);
+            throw std::system_error(err, std::generic_category(), "eventfd() failed");
+        }
+
+        armEventFd();
+    }
+
+    IoUringQueue::~IoUringQueue() {
+        // services may still cancel their operations when they are stopped
+        stopDm();
+        cancelAllOperations();
+
+        if(_recvBufferRing != nullptr) {
+            io_uring_free_buf_ring(&_ring, _recvBufferRing, _recvBufferCount, RECV_BUFFER_GROUP);
+        }
+        io_uring_queue_exit(&_ring);
+        _ringInitialized = false;
+        _operations.clear();
+
+        // suspended coroutines awaiting an operation are destroyed along with the manager
+        _eventQueue.clear();
+        destroyDm();
+
+        close(_eventFd);
+
+        if(Detail::registeredSignalHandler) {
+            if (::signal(SIGINT, SIG_DFL) == SIG_ERR) {
+                fmt::print("Couldn't unset signal handler\n");
+            }
+        }
+    }
+
+    PushResult IoUringQueue::pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        if(!event) {
+            throw std::runtime_error("Pushing nullptr");
+        }
+
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        {
+            std::lock_guard const l(_eventQueueMutex);
+            _eventQueue.emplace(priority, std::move(event));
+        }
+        wakeSleepingConsumer();
+
+        return PushResult::QUEUED;
+    }
+
+    PushResult IoUringQueue::pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        auto const result = pushToMailbox(priority, std::move(event));
+
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
+    }
+
+    PushResult IoUringQueue::pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        auto const result = pushToTimerMailbox(deadline, priority, std::move(event));
+
+        // the consumer may be sleeping until a later deadline
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
+    }
+
+    AsyncGenerator<int32_t> IoUringQueue::recv(int fd, std::span<uint8_t> buf, int flags) {
+        // both live in this coroutine frame, which stays suspended until the operation completed
+        int32_t result{};
+        AsyncManualResetEvent event{};
+
+        submit([&](io_uring_sqe &sqe) {
+            io_uring_prep_recv(&sqe, fd, buf.data(), buf.size(), flags);
+        }, [&](int32_t res, uint32_t) {
+            result = res;
+            event.set();
+        });
+
+        co_await event;
+        co_return result;
+    }
+
+    AsyncGenerator<int32_t> IoUringQueue::send(int fd, std::span<uint8_t const> buf, int flags) {
+        int32_t result{};
+        AsyncManualResetEvent event{};
+
+        submit([&](io_uring_sqe &sqe) {
+            io_uring_prep_send(&sqe, fd, buf.data(), buf.size(), flags);
+        }, [&](int32_t res, uint32_t) {
+            result = res;
+            event.set();
+        });
+
+        co_await event;
+        co_return result;
+    }
+
+    AsyncGenerator<int32_t> IoUringQueue::accept(int fd, sockaddr *addr, socklen_t *addrLen, int flags) {
+        int32_t result{};
+        AsyncManualResetEvent event{};
+
+        submit([&](io_uring_sqe &sqe) {
+            io_uring_prep_accept(&sqe, fd, addr, addrLen, flags);
+        }, [&](int32_t res, uint32_t) {
+            result = res;
+            event.set();
+        });
+
+        co_await event;
+        co_return result;
+    }
+
+    AsyncGenerator<int32_t> IoUringQueue::connect(int fd, sockaddr const *addr, socklen_t addrLen) {
+        int32_t result{};
+        AsyncManualResetEvent event{};
+
+        submit([&](io_uring_sqe &sqe) {
+            io_uring_prep_connect(&sqe, fd, addr, addrLen);
+        }, [&](int32_t res, uint32_t) {
+            result = res;
+            event.set();
+        });
+
+        co_await event;
+        co_return result;
+    }
+
+    AsyncGenerator<int32_t> IoUringQueue::timeout(std::chrono::nanoseconds duration) {
+        int32_t result{};
+        AsyncManualResetEvent event{};
+        // read by the kernel when the operation is submitted
+        __kernel_timespec ts{};
+        ts.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(duration).count();
+        ts.tv_nsec = (duration - std::chrono::seconds{ts.tv_sec}).count();
+
+        submit([&](io_uring_sqe &sqe) {
+            io_uring_prep_timeout(&sqe, &ts, 0, 0);
+        }, [&](int32_t res, uint32_t) {
+            result = res;
+            event.set();
+        });
+
+        co_await event;
+        co_return result;
+    }
+
+    uint64_t IoUringQueue::multishotAccept(int fd, std::function<void(int32_t)> onAccept) {
+        if(!onAccept) {
+            throw std::runtime_error("No callback set.");
+        }
+
+        auto const id = _operations.insert(Operation{[onAccept = std::move(onAccept)](int32_t res, uint32_t) {
+            onAccept(res);
+        }, fd, OperationType::MULTISHOT_ACCEPT, false});
+        armMultishot(id, fd, OperationType::MULTISHOT_ACCEPT);
+
+        return id;
+    }
+
+    uint64_t IoUringQueue::multishotRecv(int fd, std::function<void(int32_t, std::span<uint8_t const>)> onRecv) {
+        if(!onRecv) {
+            throw std::runtime_error("No callback set.");
+        }
+
+        setupRecvBuffers();
+
+        auto const id = _operations.insert(Operation{[this, onRecv = std::move(onRecv)](int32_t res, uint32_t flags) {
+            if(res > 0 && (flags & IORING_CQE_F_BUFFER) != 0) {
+                auto const bufferId = flags >> IORING_CQE_BUFFER_SHIFT;
+                onRecv(res, std::span<uint8_t const>{_recvBuffers.data() + static_cast<uint64_t>(bufferId) * _recvBufferSize, static_cast<uint64_t>(res)});
+            } else {
+                onRecv(res, {});
+            }
+        }, fd, OperationType::MULTISHOT_RECV, false});
+        armMultishot(id, fd, OperationType::MULTISHOT_RECV);
+
+        return id;
+    }
+
+    void IoUringQueue::cancel(uint64_t id) {
+        auto *op = _operations.find(id);
+        if(op == nullptr || op->cancelled) {
+            return;
+        }
+
+        // the kernel may still use buffers owned by the callback, keep it until the operation completed
+        op->cancelled = true;
+
+        if(_ringInitialized) {
+            auto &sqe = getSqe();
+            io_uring_prep_cancel64(&sqe, id, 0);
+            io_uring_sqe_set_data64(&sqe, IGNORED_ID);
+        }
+    }
+
+    bool IoUringQueue::empty() const noexcept {
+        std::lock_guard const l(_eventQueueMutex);
+        return _eventQueue.empty() && mailboxSize() == 0;
+    }
+
+    uint64_t IoUringQueue::size() const noexcept {
+        std::lock_guard const l(_eventQueueMutex);
+        return _eventQueue.size() + mailboxSize();
+    }
+
+    void IoUringQueue::start(bool captureSigInt) {
+        if(!_dm) {
+            throw std::runtime_error("Please create a manager first!");
+        }
+
+        if(captureSigInt && !Ichor::Detail::registeredSignalHandler.exchange(true)) {
+            if (::signal(SIGINT, Ichor::Detail::on_sigint) == SIG_ERR) {
+                throw std::runtime_error("Couldn't set signal");
+            }
+        }
+
+        startDm();
+
+        while(!shouldQuit()) {
+            bool idle;
+            {
+                std::lock_guard const l(_eventQueueMutex);
+                moveMailboxAndTimerEvents();
+                shouldAddQuitEvent();
+                idle = _eventQueue.empty();
+            }
+
+            if(shouldQuit()) {
+                break;
+            }
+
+            if(idle) {
+                // seq_cst pairs with wakeSleepingConsumer(): either the producer sees us sleeping and wakes us through the eventfd, or we see its event here.
+                _consumerSleeping.store(true, std::memory_order_seq_cst);
+                bool stillIdle;
+                {
+                    std::lock_guard const l(_eventQueueMutex);
+                    stillIdle = _eventQueue.empty() && mailboxSize() == 0 && timerMailboxSize() == 0;
+                }
+                submitAndComplete(stillIdle ? timeUntilNextTimer(500ms) : std::chrono::nanoseconds{0});
+                _consumerSleeping.store(false, std::memory_order_relaxed);
+                if(!stillIdle) {
+                    // the mailboxes were just drained, a producer may be between counting and linking its event, let it finish instead of spinning
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+
+            // one submission for everything prepared by the previous batch of events
+            submitAndComplete(std::chrono::nanoseconds{0});
+
+            for(uint64_t i = 0; i < _maxEventsBetweenCompletions && !shouldQuit(); i++) {
+                std::unique_lock l(_eventQueueMutex);
+                if(i != 0) {
+                    moveMailboxAndTimerEvents();
+                }
+
+                if(_eventQueue.empty()) {
+                    break;
+                }
+
+                auto node = _eventQueue.extract(_eventQueue.begin());
+                l.unlock();
+                releaseCapacity(*node.mapped());
+                processEvent(std::move(node.mapped()));
+            }
+        }
+
+        stopDm();
+    }
+
+    io_uring_sqe& IoUringQueue::getSqe() {
+        auto *sqe = io_uring_get_sqe(&_ring);
+
+        if(sqe == nullptr) {
+            io_uring_submit(&_ring);
+            sqe = io_uring_get_sqe(&_ring);
+
+            if(sqe == nullptr) {
+                throw std::runtime_error("io_uring submission queue is full");
+            }
+        }
+
+        return *sqe;
+    }
+
+    void IoUringQueue::armEventFd() {
+        auto &sqe = getSqe();
+        io_uring_prep_read(&sqe, _eventFd, &_eventFdValue, sizeof(_eventFdValue), 0);
+        io_uring_sqe_set_data64(&sqe, EVENTFD_ID);
+    }
+
+    void IoUringQueue::armMultishot(uint64_t id, int fd, OperationType type) {
+        auto &sqe = getSqe();
+
+        if(type == OperationType::MULTISHOT_ACCEPT) {
+            io_uring_prep_multishot_accept(&sqe, fd, nullptr, nullptr, SOCK_CLOEXEC);
+        } else {
+            io_uring_prep_recv_multishot(&sqe, fd, nullptr, 0, 0);
+            sqe.flags |= IOSQE_BUFFER_SELECT;
+            sqe.buf_group = RECV_BUFFER_GROUP;
+        }
+
+        io_uring_sqe_set_data64(&sqe, id);
+    }
+
+    void IoUringQueue::setupRecvBuffers() {
+        if(_recvBufferRing != nullptr) {
+            return;
+        }
+
+        int ret{};
+        _recvBufferRing = io_uring_setup_buf_ring(&_ring, _recvBufferCount, RECV_BUFFER_GROUP, 0, &ret);
+        if(_recvBufferRing == nullptr) {
+            throw std::system_error(-ret, std::generic_category(), "io_uring_setup_buf_ring() failed");
+        }
+
+        _recvBuffers.resize(static_cast<uint64_t>(_recvBufferCount) * _recvBufferSize);
+        auto const mask = io_uring_buf_ring_mask(_recvBufferCount);
+        for(uint32_t i = 0; i < _recvBufferCount; i++) {
+            io_uring_buf_ring_add(_recvBufferRing, _recvBuffers.data() + static_cast<uint64_t>(i) * _recvBufferSize, _recvBufferSize, static_cast<unsigned short>(i), mask, static_cast<int>(i));
+        }
+        io_uring_buf_ring_advance(_recvBufferRing, static_cast<int>(_recvBufferCount));
+    }
+
+    void IoUringQueue::returnRecvBuffer(uint32_t cqeFlags) noexcept {
+        if((cqeFlags & IORING_CQE_F_BUFFER) == 0 || _recvBufferRing == nullptr) {
+            return;
+        }
+
+        auto const bufferId = cqeFlags >> IORING_CQE_BUFFER_SHIFT;
+        io_uring_buf_ring_add(_recvBufferRing, _recvBuffers.data() + static_cast<uint64_t>(bufferId) * _recvBufferSize, _recvBufferSize, static_cast<unsigned short>(bufferId), io_uring_buf_ring_mask(_recvBufferCount), 0);
+        io_uring_buf_ring_advance(_recvBufferRing, 1);
+    }
+
+    void IoUringQueue::submitAndComplete(std::chrono::nanoseconds timeout) {
+        if(timeout > std::chrono::nanoseconds::zero()) {
+            __kernel_timespec ts{};
+            ts.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(timeout).count();
+            ts.tv_nsec = (timeout - std::chrono::seconds{ts.tv_sec}).count();
+            io_uring_cqe *cqe{};
+
+            int const ret = io_uring_submit_and_wait_timeout(&_ring, &cqe, 1, &ts, nullptr);
+            if(ret < 0 && ret != -ETIME && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+                throw std::system_error(-ret, std::generic_category(), "io_uring_submit_and_wait_timeout() failed");
+            }
+        } else {
+            // does not enter the kernel if nothing was prepared
+            int const ret = io_uring_submit(&_ring);
+            if(ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+                throw std::system_error(-ret, std::generic_category(), "io_uring_submit() failed");
+            }
+        }
+
+        std::array<io_uring_cqe*, MAX_COMPLETIONS> cqes{};
+        unsigned completed;
+        // callbacks may prepare new operations, those are submitted with the next call
+        while((completed = io_uring_peek_batch_cqe(&_ring, cqes.data(), MAX_COMPLETIONS)) != 0) {
+            for(unsigned i = 0; i < completed; i++) {
+                complete(*cqes[i]);
+            }
+            io_uring_cq_advance(&_ring, completed);
+
+            if(completed < MAX_COMPLETIONS) {
+                break;
+            }
+        }
+    }
+
+    void IoUringQueue::complete(io_uring_cqe const &cqe) {
+        auto const id = io_uring_cqe_get_data64(&cqe);
+
+        if(id == EVENTFD_ID) {
+            _wakeupPending.store(false, std::memory_order_release);
+            if(cqe.res != -ECANCELED) {
+                armEventFd();
+            }
+            return;
+        }
+
+        if(id == IGNORED_ID) {
+            return;
+        }
+
+        auto *op = _operations.find(id);
+        if(op == nullptr) {
+            returnRecvBuffer(cqe.flags);
+            return;
+        }
+
+        bool const more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        auto const type = op->type;
+        auto const fd = op->fd;
+        bool finished{true};
+        bool skipCallback{};
+
+        switch(type) {
+            case OperationType::SINGLE:
+                finished = true;
+                break;
+            case OperationType::MULTISHOT_ACCEPT:
+                // the kernel may end a multishot without an error, keep it going
+                finished = !more && cqe.res < 0;
+                break;
+            case OperationType::MULTISHOT_RECV:
+                // out of buffers is not an error for the callback, the buffers are returned after handling this batch
+                skipCallback = cqe.res == -ENOBUFS;
+                finished = !more && cqe.res <= 0 && !skipCallback;
+                break;
+        }
+
+        if(op->cancelled) {
+            if(!more) {
+                _operations.erase(id);
+            }
+            returnRecvBuffer(cqe.flags);
+            return;
+        }
+
+        // the callback may insert or erase operations, which moves them around
+        auto onComplete = std::move(op->onComplete);
+
+        if(finished) {
+            _operations.erase(id);
+            onComplete(cqe.res, cqe.flags);
+            returnRecvBuffer(cqe.flags);
+            return;
+        }
+
+        if(!skipCallback) {
+            onComplete(cqe.res, cqe.flags);
+        }
+        returnRecvBuffer(cqe.flags);
+
+        op = _operations.find(id);
+        if(op == nullptr) {
+            return;
+        }
+
+        if(op->cancelled) {
+            // cancelled from within the callback, nothing follows if this was the last completion
+            if(more) {
+                op->onComplete = std::move(onComplete);
+            } else {
+                _operations.erase(id);
+            }
+            return;
+        }
+
+        op->onComplete = std::move(onComplete);
+        if(!more) {
+            armMultishot(id, fd, type);
+        }
+    }
+
+    void IoUringQueue::cancelAllOperations() noexcept {
+        if(!_ringInitialized) {
+            return;
+        }
+
+        for(auto &op : _operations) {
+            op.cancelled = true;
+        }
+
+        // also cancels the eventfd read
+        auto *sqe = io_uring_get_sqe(&_ring);
+        if(sqe == nullptr) {
+            io_uring_submit(&_ring);
+            sqe = io_uring_get_sqe(&_ring);
+        }
+        if(sqe != nullptr) {
+            io_uring_prep_cancel(sqe, nullptr, IORING_ASYNC_CANCEL_ANY);
+            io_uring_sqe_set_data64(sqe, IGNORED_ID);
+        }
+
+        // cancellation is usually immediate, but don't hang on operations that cannot be cancelled
+        auto const deadline = std::chrono::steady_clock::now() + 1s;
+        while(!_operations.empty() && std::chrono::steady_clock::now() < deadline) {
+            try {
+                submitAndComplete(10ms);
+            } catch(std::system_error const &) {
+                break;
+            }
+        }
+    }
+
+    void IoUringQueue::moveMailboxAndTimerEvents() {
+        auto insert = [this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            _eventQueue.emplace(priority, std::move(event));
+        };
+        drainMailbox(insert);
+        expireTimers(insert);
+    }
+
+    void IoUringQueue::wakeSleepingConsumer() {
+        // only the first producer to see the consumer sleeping pays for the write
+        if(_consumerSleeping.load(std::memory_order_seq_cst) && !_wakeupPending.exchange(true, std::memory_order_acq_rel)) {
+            uint64_t val = 1;
+            [[maybe_unused]] auto n = write(_eventFd, &val, sizeof(val));
+        }
+    }
+
+    bool IoUringQueue::shouldQuit() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if (shouldQuit && _quitEventSent && std::chrono::steady_clock::now() - _whenQuitEventWasSent >= 500ms) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        if (shutdownTimedOut()) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        return _quit.load(std::memory_order_acquire);
+    }
+
+    void IoUringQueue::shouldAddQuitEvent() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if(shouldQuit && !_quitEventSent) {
+            // assume _eventQueueMutex is locked
+            _eventQueue.emplace(INTERNAL_EVENT_PRIORITY, std::make_unique<QuitEvent>(_dm->getNextEventId(), 0, INTERNAL_EVENT_PRIORITY));
+            _quitEventSent = true;
+            _whenQuitEventWasSent = std::chrono::steady_clock::now();
+        }
+    }
+
+    void IoUringQueue::quit() {
+        _quit.store(true, std::memory_order_release);
+
+        uint64_t val = 1;
+        [[maybe_unused]] auto n = write(_eventFd, &val, sizeof(val));
+    }
+}
+
+#endif
@@ -3,6 +3,7 @@
 #include <condition_variable>
 #include <ichor/DependencyManager.h>
 #include <csignal>
+#include <thread>
 
 namespace Ichor::Detail {
     extern std::atomic<bool> sigintQuit;
@@ -11,6 +12,14 @@ namespace Ichor::Detail {
 }
 
 namespace Ichor {
+    MultimapQueue::MultimapQueue(uint64_t maxBatchSize, bool batchOnlyHighestPriority) : _maxBatchSize(maxBatchSize), _batchOnlyHighestPriority(batchOnlyHighestPriority) {
+        if(_maxBatchSize == 0) {
+            throw std::runtime_error("Batch size has to be at least 1");
+        }
+
+        _batch.reserve(_maxBatchSize == std::numeric_limits<uint64_t>::max() ? 0 : _maxBatchSize);
+    }
+
     MultimapQueue::~MultimapQueue() {
         stopDm();
 
@@ -21,26 +30,62 @@ namespace Ichor {
         }
     }
 
-    void MultimapQueue::pushEvent(uint64_t priority, std::unique_ptr<Event> &&event) {
+    PushResult MultimapQueue::pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
         if(!event) {
             throw std::runtime_error("Pushing nullptr");
         }
 
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
         {
             std::lock_guard const l(_eventQueueMutex);
             _eventQueue.emplace(priority, std::move(event));
+            if(priority < _lowestPushedPriority.load(std::memory_order_relaxed)) {
+                _lowestPushedPriority.store(priority, std::memory_order_release);
+            }
         }
         _wakeup.notify_all();
+
+        return PushResult::QUEUED;
+    }
+
+    PushResult MultimapQueue::pushMailboxEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        // A sleeping consumer has to be woken up under the lock anyway, insert directly instead of making it drain the mailbox after waking up.
+        // Only with an empty mailbox though, earlier events of this producer may still be in there.
+        if(_consumerSleeping.load(std::memory_order_seq_cst) && mailboxSize() == 0) {
+            return pushEvent(priority, std::move(event));
+        }
+
+        auto const result = pushToMailbox(priority, std::move(event));
+
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
+    }
+
+    PushResult MultimapQueue::pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        auto const result = pushToTimerMailbox(deadline, priority, std::move(event));
+
+        // the consumer may be sleeping until a later deadline
+        if(result == PushResult::QUEUED) {
+            wakeSleepingConsumer();
+        }
+
+        return result;
     }
 
     bool MultimapQueue::empty() const noexcept {
         std::shared_lock const l(_eventQueueMutex);
-        return _eventQueue.empty();
+        return _eventQueue.empty() && _batchRemaining.load(std::memory_order_acquire) == 0 && mailboxSize() == 0;
     }
 
     uint64_t MultimapQueue::size() const noexcept {
         std::shared_lock const l(_eventQueueMutex);
-        return _eventQueue.size();
+        return _eventQueue.size() + _batchRemaining.load(std::memory_order_acquire) + mailboxSize();
     }
 
     void MultimapQueue::start(bool captureSigInt) {
@@ -58,11 +103,23 @@ namespace Ichor {
 
         while(!shouldQuit()) {
             std::unique_lock l(_eventQueueMutex);
+            moveMailboxEvents();
+            moveExpiredTimers();
             while(!shouldQuit() && _eventQueue.empty()) {
-                _wakeup.wait_for(l, 500ms, [this]() {
+                _consumerSleeping.store(true, std::memory_order_seq_cst);
+                _wakeup.wait_for(l, timeUntilNextTimer(500ms), [this]() {
                     shouldAddQuitEvent();
-                    return shouldQuit() || !_eventQueue.empty();
+                    return shouldQuit() || !_eventQueue.empty() || mailboxSize() != 0 || timerMailboxSize() != 0;
                 });
+                _consumerSleeping.store(false, std::memory_order_relaxed);
+                moveExpiredTimers();
+                // the timer mailbox was just drained completely, so anything left in it is still being linked as well
+                if((moveMailboxEvents() == 0 && mailboxSize() != 0) || timerMailboxSize() != 0) {
+                    // a producer is between counting and linking its event, let it finish instead of spinning
+                    l.unlock();
+                    std::this_thread::yield();
+                    l.lock();
+                }
             }
 
             shouldAddQuitEvent();
@@ -71,14 +128,82 @@ namespace Ichor {
                 break;
             }
 
-            auto node = _eventQueue.extract(_eventQueue.begin());
+            if(_maxBatchSize == 1) {
+                auto node = _eventQueue.extract(_eventQueue.begin());
+                l.unlock();
+                releaseCapacity(*node.mapped());
+                processEvent(std::move(node.mapped()));
+                continue;
+            }
+
+            uint64_t const highestPriority = _eventQueue.begin()->first;
+            while(!_eventQueue.empty() && _batch.size() < _maxBatchSize && (!_batchOnlyHighestPriority || _eventQueue.begin()->first == highestPriority)) {
+                _batch.push_back(_eventQueue.extract(_eventQueue.begin()));
+            }
+            _batchRemaining.store(_batch.size(), std::memory_order_release);
+            _lowestPushedPriority.store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
             l.unlock();
-            processEvent(std::move(node.mapped()));
+
+            processBatch();
         }
 
         stopDm();
     }
 
+    void MultimapQueue::processBatch() {
+        for(uint64_t i = 0; i < _batch.size(); i++) {
+            auto &node = _batch[i];
+
+            // Events pushed with a higher priority than the rest of the batch have to be handled first, same goes for quitting.
+            if(i != 0 && (_lowestPushedPriority.load(std::memory_order_acquire) < node.key() || shouldQuit())) {
+                std::lock_guard const l(_eventQueueMutex);
+                // insert in reverse, in front of equal priorities, to keep the original order
+                for(uint64_t j = _batch.size(); j > i; j--) {
+                    auto &unprocessed = _batch[j - 1];
+                    auto hint = _eventQueue.lower_bound(unprocessed.key());
+                    _eventQueue.insert(hint, std::move(unprocessed));
+                }
+                _batchRemaining.store(0, std::memory_order_release);
+                break;
+            }
+
+            _batchRemaining.fetch_sub(1, std::memory_order_acq_rel);
+            releaseCapacity(*node.mapped());
+            processEvent(std::move(node.mapped()));
+        }
+
+        _batch.clear();
+    }
+
+    uint64_t MultimapQueue::moveMailboxEvents() {
+        return drainMailbox([this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            _eventQueue.emplace(priority, std::move(event));
+            if(priority < _lowestPushedPriority.load(std::memory_order_relaxed)) {
+                _lowestPushedPriority.store(priority, std::memory_order_release);
+            }
+        });
+    }
+
+    uint64_t MultimapQueue::moveExpiredTimers() {
+        return expireTimers([this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            _eventQueue.emplace(priority, std::move(event));
+            if(priority < _lowestPushedPriority.load(std::memory_order_relaxed)) {
+                _lowestPushedPriority.store(priority, std::memory_order_release);
+            }
+        });
+    }
+
+    void MultimapQueue::wakeSleepingConsumer() {
+        // seq_cst pairs with the store to _consumerSleeping in start(): either we see the consumer sleeping, or the consumer sees our event.
+        // Taking the lock once makes sure the consumer is not between checking for events and waiting, notifying after releasing it saves the consumer from waking up to a locked mutex.
+        if(_consumerSleeping.load(std::memory_order_seq_cst)) {
+            {
+                std::lock_guard const l(_eventQueueMutex);
+            }
+            _wakeup.notify_all();
+        }
+    }
+
     bool MultimapQueue::shouldQuit() {
         bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
 
@@ -87,6 +212,10 @@ namespace Ichor {
             _quit.store(true, std::memory_order_release);
         }
 
+        if (shutdownTimedOut()) {
+            _quit.store(true, std::memory_order_release);
+        }
+
         return _quit.load(std::memory_order_acquire);
     }
 
@@ -96,6 +225,9 @@ namespace Ichor {
         if(shouldQuit && !_quitEventSent) {
             // assume _eventQueueMutex is locked
             _eventQueue.emplace(INTERNAL_EVENT_PRIORITY, std::make_unique<QuitEvent>(_dm->getNextEventId(), 0, INTERNAL_EVENT_PRIORITY));
+            if(INTERNAL_EVENT_PRIORITY < _lowestPushedPriority.load(std::memory_order_relaxed)) {
+                _lowestPushedPriority.store(INTERNAL_EVENT_PRIORITY, std::memory_order_release);
+            }
             _quitEventSent = true;
             _whenQuitEventWasSent = std::chrono::steady_clock::now();
         }
@@ -0,0 +1,187 @@
+#include <ichor/event_queues/PriorityBandQueue.h>
+#include <ichor/DependencyManager.h>
+#include <algorithm>
+#include <csignal>
+
+namespace Ichor::Detail {
+    extern std::atomic<bool> sigintQuit;
+    extern std::atomic<bool> registeredSignalHandler;
+    void on_sigint([[maybe_unused]] int sig);
+}
+
+namespace Ichor {
+    PriorityBandQueue::PriorityBandQueue(std::vector<uint64_t> bandUpperBounds) : _bandUpperBounds(std::move(bandUpperBounds)) {
+        if(!std::is_sorted(_bandUpperBounds.begin(), _bandUpperBounds.end())) {
+            throw std::runtime_error("Priority bands have to be sorted");
+        }
+
+        if(_bandUpperBounds.empty() || _bandUpperBounds.back() != std::numeric_limits<uint64_t>::max()) {
+            _bandUpperBounds.push_back(std::numeric_limits<uint64_t>::max());
+        }
+
+        _bands = std::make_unique<MpscQueue<std::unique_ptr<Event, EventDeleter>>[]>(_bandUpperBounds.size());
+    }
+
+    PriorityBandQueue::~PriorityBandQueue() {
+        stopDm();
+
+        if(Detail::registeredSignalHandler) {
+            if (::signal(SIGINT, SIG_DFL) == SIG_ERR) {
+                fmt::print("Couldn't unset signal handler\n");
+            }
+        }
+    }
+
+    PushResult PriorityBandQueue::pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        if(!event) {
+            throw std::runtime_error("Pushing nullptr");
+        }
+
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        // Count before linking, so that the consumer never pops an event that isn't counted yet.
+        // seq_cst pairs with the store to _consumerSleeping in start(): either we see the consumer sleeping, or the consumer sees our event.
+        _size.fetch_add(1, std::memory_order_seq_cst);
+        _bands[bandFor(priority)].push(std::move(event));
+
+        if(_consumerSleeping.load(std::memory_order_seq_cst)) {
+            wakeConsumer();
+        }
+
+        return PushResult::QUEUED;
+    }
+
+    PushResult PriorityBandQueue::pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        auto const result = pushToTimerMailbox(deadline, priority, std::move(event));
+
+        // the consumer may be sleeping until a later deadline
+        if(result == PushResult::QUEUED && _consumerSleeping.load(std::memory_order_seq_cst)) {
+            wakeConsumer();
+        }
+
+        return result;
+    }
+
+    bool PriorityBandQueue::empty() const noexcept {
+        return _size.load(std::memory_order_acquire) == 0;
+    }
+
+    uint64_t PriorityBandQueue::size() const noexcept {
+        return _size.load(std::memory_order_acquire);
+    }
+
+    void PriorityBandQueue::start(bool captureSigInt) {
+        if(!_dm) {
+            throw std::runtime_error("Please create a manager first!");
+        }
+
+        if(captureSigInt && !Ichor::Detail::registeredSignalHandler.exchange(true)) {
+            if (::signal(SIGINT, Ichor::Detail::on_sigint) == SIG_ERR) {
+                throw std::runtime_error("Couldn't set signal");
+            }
+        }
+
+        startDm();
+
+        std::unique_ptr<Event, EventDeleter> event{};
+        while(!shouldQuit()) {
+            shouldAddQuitEvent();
+            moveExpiredTimers();
+
+            if(_size.load(std::memory_order_acquire) == 0) {
+                if(timerMailboxSize() != 0) {
+                    // A producer has counted a delayed event but not finished linking it yet, the timer mailbox was just drained.
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                std::unique_lock l(_wakeupMutex);
+                _consumerSleeping.store(true, std::memory_order_seq_cst);
+                _wakeup.wait_for(l, timeUntilNextTimer(500ms), [this]() {
+                    return shouldQuit() || (!_quitEventSent && Detail::sigintQuit.load(std::memory_order_acquire)) || _size.load(std::memory_order_seq_cst) != 0 || timerMailboxSize() != 0;
+                });
+                _consumerSleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+
+            if(shouldQuit()) {
+                break;
+            }
+
+            if(!popEvent(event)) {
+                // A producer has claimed a spot but not finished linking it yet.
+                std::this_thread::yield();
+                continue;
+            }
+
+            _size.fetch_sub(1, std::memory_order_acq_rel);
+            releaseCapacity(*event);
+            processEvent(std::move(event));
+        }
+
+        stopDm();
+    }
+
+    bool PriorityBandQueue::shouldQuit() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if (shouldQuit && _quitEventSent && std::chrono::steady_clock::now() - _whenQuitEventWasSent >= 500ms) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        if (shutdownTimedOut()) {
+            _quit.store(true, std::memory_order_release);
+        }
+
+        return _quit.load(std::memory_order_acquire);
+    }
+
+    void PriorityBandQueue::quit() {
+        _quit.store(true, std::memory_order_release);
+        wakeConsumer();
+    }
+
+    uint64_t PriorityBandQueue::bandFor(uint64_t priority) const noexcept {
+        // the amount of bands is small, a linear search beats a binary search here
+        uint64_t band = 0;
+        while(_bandUpperBounds[band] < priority) {
+            band++;
+        }
+        return band;
+    }
+
+    bool PriorityBandQueue::popEvent(std::unique_ptr<Event, EventDeleter> &event) {
+        for(uint64_t band = 0; band < _bandUpperBounds.size(); band++) {
+            if(_bands[band].pop(event)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void PriorityBandQueue::shouldAddQuitEvent() {
+        bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
+
+        if(shouldQuit && !_quitEventSent) {
+            pushEvent(INTERNAL_EVENT_PRIORITY, std::make_unique<QuitEvent>(_dm->getNextEventId(), 0, INTERNAL_EVENT_PRIORITY));
+            _quitEventSent = true;
+            _whenQuitEventWasSent = std::chrono::steady_clock::now();
+        }
+    }
+
+    uint64_t PriorityBandQueue::moveExpiredTimers() {
+        return expireTimers([this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            // capacity was reserved when the delayed event was pushed
+            _size.fetch_add(1, std::memory_order_seq_cst);
+            _bands[bandFor(priority)].push(std::move(event));
+        });
+    }
+
+    void PriorityBandQueue::wakeConsumer() {
+        std::lock_guard const l(_wakeupMutex);
+        _wakeup.notify_all();
+    }
+}
\ No newline at end of file
@@ -15,7 +15,7 @@ namespace Ichor::Detail {
 namespace Ichor {
     struct ProcessableEvent {
         SdeventQueue *queue;
-        std::unique_ptr<Event> event;
+        std::unique_ptr<Event, EventDeleter> event;
     };
 
     SdeventQueue::SdeventQueue() {
@@ -29,6 +29,7 @@ namespace Ichor {
             sd_event_unref(_eventQueue);
             sd_event_source_unref(_eventfdSource);
             sd_event_source_unref(_timerSource);
+            sd_event_source_unref(_timerWheelSource);
         } else {
             close(_eventfd);
         }
@@ -40,7 +41,7 @@ namespace Ichor {
         }
     }
 
-    void SdeventQueue::pushEvent(uint64_t priority, std::unique_ptr<Event> &&event) {
+    PushResult SdeventQueue::pushEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
         if(!_initializedSdevent.load(std::memory_order_acquire)) {
             throw std::runtime_error("sdevent not initialized. Call createEventLoop or useEventLoop first.");
         }
@@ -49,6 +50,40 @@ namespace Ichor {
             throw std::runtime_error("Pushing nullptr");
         }
 
+        if(!reserveCapacity(*event)) {
+            return PushResult::QUEUE_FULL;
+        }
+
+        insertEvent(priority, std::move(event));
+
+        return PushResult::QUEUED;
+    }
+
+    PushResult SdeventQueue::pushDelayedEvent(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        if(!_initializedSdevent.load(std::memory_order_acquire)) {
+            throw std::runtime_error("sdevent not initialized. Call createEventLoop or useEventLoop first.");
+        }
+
+        auto const result = pushToTimerMailbox(deadline, priority, std::move(event));
+
+        if(result == PushResult::QUEUE_FULL) {
+            return result;
+        }
+
+        if(std::this_thread::get_id() == _threadId) {
+            expireTimersAndRearm();
+        } else {
+            // the eventfd handler picks up the new deadline on the thread running the loop
+            uint64_t val = 1;
+            if (write(_eventfd, &val, sizeof(val)) < 0) {
+                throw std::system_error(-errno, std::generic_category(), "write() failed");
+            }
+        }
+
+        return result;
+    }
+
+    void SdeventQueue::insertEvent(uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
         {
             std::lock_guard const l(_eventQueueMutex);
             sd_event_source *src;
@@ -60,6 +95,8 @@ namespace Ichor {
                     e->queue->quit();
                 }
 
+                e->queue->releaseCapacity(*e->event);
+
                 try {
                     e->queue->processEvent(std::move(e->event));
                 } catch(const std::exception &ex) {
@@ -100,6 +137,33 @@ namespace Ichor {
         }
     }
 
+    void SdeventQueue::expireTimersAndRearm() {
+        expireTimers([this](uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+            insertEvent(priority, std::move(event));
+        });
+
+        auto const wait = timeUntilNextTimer(std::chrono::nanoseconds::max());
+
+        std::lock_guard const l(_eventQueueMutex);
+        if(wait == std::chrono::nanoseconds::max()) {
+            sd_event_source_set_enabled(_timerWheelSource, SD_EVENT_OFF);
+            return;
+        }
+
+        auto const usec = std::chrono::ceil<std::chrono::microseconds>((std::chrono::steady_clock::now() + wait).time_since_epoch()).count();
+        int ret = sd_event_source_set_time(_timerWheelSource, static_cast<uint64_t>(usec));
+
+        if (ret < 0) {
+            throw std::system_error(-ret, std::generic_category(), "sd_event_source_set_time() failed");
+        }
+
+        ret = sd_event_source_set_enabled(_timerWheelSource, SD_EVENT_ONESHOT);
+
+        if (ret < 0) {
+            throw std::system_error(-ret, std::generic_category(), "sd_event_source_set_enabled() failed");
+        }
+    }
+
     bool SdeventQueue::empty() const {
         if(!_initializedSdevent.load(std::memory_order_acquire)) {
             throw std::runtime_error("sdevent not initialized. Call createEventLoop or useEventLoop first.");
@@ -129,6 +193,7 @@ namespace Ichor {
 
         registerEventFd();
         registerTimer();
+        registerTimerWheel();
 
         _initializedSdevent.store(true, std::memory_order_release);
         return _eventQueue;
@@ -139,6 +204,7 @@ namespace Ichor {
         _eventQueue = event;
         registerEventFd();
         registerTimer();
+        registerTimerWheel();
         _initializedSdevent.store(true, std::memory_order_release);
     }
 
@@ -164,7 +230,7 @@ namespace Ichor {
     bool SdeventQueue::shouldQuit() {
         bool const shouldQuit = Detail::sigintQuit.load(std::memory_order_acquire);
 
-        if (shouldQuit) {
+        if (shouldQuit || shutdownTimedOut()) {
             _quit.store(true, std::memory_order_release);
         }
 
@@ -207,8 +273,13 @@ namespace Ichor {
                                           }
                                       }
 
+                                      auto *q = reinterpret_cast<SdeventQueue*>(userdata);
+                                      if(q->timerMailboxSize() != 0) {
+                                          q->expireTimersAndRearm();
+                                      }
+
                                       return static_cast<int>(n);
-                                  }, nullptr);
+                                  }, this);
 
         if (ret < 0) {
             throw std::system_error(-ret, std::generic_category(), "sd_event_add_io() failed");
@@ -238,6 +309,33 @@ namespace Ichor {
             throw std::system_error(-ret, std::generic_category(), "sd_event_add_io() failed");
         }
     }
+
+    void SdeventQueue::registerTimerWheel() {
+        // a single time source for all delayed events, armed for the earliest deadline in the timer wheel
+        int ret = sd_event_add_time(_eventQueue, &_timerWheelSource, CLOCK_MONOTONIC, 0, 0,
+                                  [](sd_event_source *s, uint64_t usec, void *userdata) {
+                                      auto *q = reinterpret_cast<SdeventQueue*>(userdata);
+                                      q->expireTimersAndRearm();
+                                      return 0;
+                                  }, this);
+
+        if (ret < 0) {
+            throw std::system_error(-ret, std::generic_category(), "sd_event_add_time() failed");
+        }
+
+        // sd-event coalesces time sources with a default accuracy of 250 ms, the wheel already coalesces per tick
+        ret = sd_event_source_set_time_accuracy(_timerWheelSource, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Detail::TimerWheel::TICK).count()));
+
+        if (ret < 0) {
+            throw std::system_error(-ret, std::generic_category(), "sd_event_source_set_time_accuracy() failed");
+        }
+
+        ret = sd_event_source_set_enabled(_timerWheelSource, SD_EVENT_OFF);
+
+        if (ret < 0) {
+            throw std::system_error(-ret, std::generic_category(), "sd_event_source_set_enabled() failed");
+        }
+    }
 }
 
 #endif
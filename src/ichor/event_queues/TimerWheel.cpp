@@ -0,0 +1,118 @@
+#include <ichor/event_queues/TimerWheel.h>
+
+namespace Ichor::Detail {
+    void TimerWheel::insert(std::chrono::steady_clock::time_point deadline, uint64_t priority, std::unique_ptr<Event, EventDeleter> &&event) {
+        uint64_t const tick = deadlineTick(deadline);
+        _size++;
+
+        if(tick <= _currentTick) {
+            _overdue.push_back(Entry{tick, priority, std::move(event)});
+            return;
+        }
+
+        place(Entry{tick, priority, std::move(event)});
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> TimerWheel::nextDeadline() const noexcept {
+        if(!_overdue.empty()) {
+            return _origin + _currentTick * TICK;
+        }
+
+        auto const nextTick = nextWorkTick();
+        if(!nextTick) {
+            return {};
+        }
+
+        return _origin + *nextTick * TICK;
+    }
+
+    void TimerWheel::clear() noexcept {
+        for(auto &level : _slots) {
+            for(auto &slot : level) {
+                slot.clear();
+            }
+        }
+        _overdue.clear();
+        _size = 0;
+    }
+
+    uint64_t TimerWheel::deadlineTick(std::chrono::steady_clock::time_point tp) const noexcept {
+        if(tp <= _origin) {
+            return 0;
+        }
+
+        auto const sinceOrigin = std::chrono::duration_cast<std::chrono::nanoseconds>(tp - _origin).count();
+        return static_cast<uint64_t>((sinceOrigin + TICK.count() - 1) / TICK.count());
+    }
+
+    uint64_t TimerWheel::tickAt(std::chrono::steady_clock::time_point tp) const noexcept {
+        if(tp <= _origin) {
+            return 0;
+        }
+
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(tp - _origin).count() / TICK.count());
+    }
+
+    std::optional<uint64_t> TimerWheel::nextWorkTick() const noexcept {
+        if(_size == _overdue.size()) {
+            return {};
+        }
+
+        // A level 0 slot expires at its tick, a higher level slot cascades at the first tick it covers.
+        // Cascaded timers may expire before later level 0 timers, so take the earliest non-empty slot over all levels.
+        std::optional<uint64_t> nextTick{};
+        for(uint64_t level = 0; level < LEVELS; level++) {
+            uint64_t const shift = level * SLOT_BITS;
+            uint64_t const position = _currentTick >> shift;
+
+            for(uint64_t i = 1; i <= SLOTS; i++) {
+                if(!_slots[level][(position + i) & (SLOTS - 1)].empty()) {
+                    uint64_t const tick = (position + i) << shift;
+                    if(!nextTick || tick < *nextTick) {
+                        nextTick = tick;
+                    }
+                    break;
+                }
+            }
+        }
+
+        return nextTick;
+    }
+
+    void TimerWheel::place(Entry &&entry) {
+        uint64_t const delta = entry.tick - _currentTick;
+
+        for(uint64_t level = 0; level < LEVELS; level++) {
+            uint64_t const shift = level * SLOT_BITS;
+            if(delta < (SLOTS << shift)) {
+                _slots[level][(entry.tick >> shift) & (SLOTS - 1)].push_back(std::move(entry));
+                return;
+            }
+        }
+
+        // Further away than the wheel spans, park it in the furthest top level slot. It gets placed again when that slot cascades.
+        uint64_t constexpr topShift = (LEVELS - 1) * SLOT_BITS;
+        _slots[LEVELS - 1][((_currentTick >> topShift) + SLOTS - 1) & (SLOTS - 1)].push_back(std::move(entry));
+    }
+
+    void TimerWheel::cascade() {
+        // Highest level first, so that its timers can cascade further down in the same tick.
+        uint64_t levels{};
+        while(levels + 1 < LEVELS && (_currentTick & ((uint64_t{1} << ((levels + 1) * SLOT_BITS)) - 1)) == 0) {
+            levels++;
+        }
+
+        for(uint64_t level = levels; level > 0; level--) {
+            auto &slot = _slots[level][(_currentTick >> (level * SLOT_BITS)) & (SLOTS - 1)];
+            if(slot.empty()) {
+                continue;
+            }
+
+            std::swap(slot, _expiring);
+            for(auto &entry : _expiring) {
+                place(std::move(entry));
+            }
+            _expiring.clear();
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include <ichor/events/EventTypeIndex.h>
+#include <ichor/stl/RealtimeReadWriteMutex.h>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace {
+    // function statics, so registration from other static initializers is safe
+    Ichor::RealtimeReadWriteMutex& registryMutex() {
+        static Ichor::RealtimeReadWriteMutex mutex{};
+        return mutex;
+    }
+
+    // only used when an event type is first pushed or handled, no need for the faster map of Common.h
+    std::unordered_map<uint64_t, uint32_t>& registry() {
+        static std::unordered_map<uint64_t, uint32_t> indices{};
+        return indices;
+    }
+}
+
+uint32_t Ichor::Detail::registerEventType(uint64_t type) {
+    std::unique_lock const l(registryMutex());
+    auto &indices = registry();
+    return indices.try_emplace(type, static_cast<uint32_t>(indices.size() + 1)).first->second;
+}
+
+uint32_t Ichor::Detail::findEventTypeIndex(uint64_t type) noexcept {
+    std::shared_lock const l(registryMutex());
+    auto &indices = registry();
+    auto it = indices.find(type);
+    if(it == indices.end()) {
+        return 0;
+    }
+    return it->second;
+}
@@ -23,6 +23,10 @@ Ichor::StartBehaviour Ichor::HttpHostService::start() {
         _tcpNoDelay = Ichor::any_cast<bool>(getProperties().operator[]("NoDelay"));
     }
 
+    if(getProperties().contains("ReusePort")) {
+        _reusePort = Ichor::any_cast<bool>(getProperties().operator[]("ReusePort"));
+    }
+
     auto address = net::ip::make_address(Ichor::any_cast<std::string&>(getProperties().operator[]("Address")));
     auto port = Ichor::any_cast<uint16_t>(getProperties().operator[]("Port"));
 
@@ -144,6 +148,13 @@ void Ichor::HttpHostService::listen(tcp::endpoint endpoint, net::yield_context y
         return fail(ec, "HttpHostService::listen set_option", true);
     }
 
+    if(_reusePort) {
+        _httpAcceptor->set_option(net::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true), ec);
+        if(ec) {
+            return fail(ec, "HttpHostService::listen set_option reuse port", true);
+        }
+    }
+
     _httpAcceptor->bind(endpoint, ec);
     if(ec) {
         return fail(ec, "HttpHostService::listen bind", true);
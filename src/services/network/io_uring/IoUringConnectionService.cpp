@@ -0,0 +1,255 @@
+#ifdef ICHOR_USE_LIBURING
+
+#include <ichor/DependencyManager.h>
+#include <ichor/event_queues/IoUringQueue.h>
+#include <ichor/services/network/io_uring/IoUringConnectionService.h>
+#include <ichor/services/network/NetworkEvents.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <cstring>
+
+Ichor::IoUringConnectionService::IoUringConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _attempts(), _priority(INTERNAL_EVENT_PRIORITY), _msgIdCounter(), _quit() {
+    reg.registerDependency<ILogger>(this, true);
+}
+
+Ichor::StartBehaviour Ichor::IoUringConnectionService::start() {
+    _queue = getManager().getEventQueue().getIoUringQueue();
+    if(_queue == nullptr) {
+        getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 5, "IoUringConnectionService requires an IoUringQueue");
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    if(getProperties().contains("Priority")) {
+        _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
+    }
+
+    if(getProperties().contains("BufferPool")) {
+        _bufferPool = Ichor::any_cast<std::shared_ptr<BufferPool>&>(getProperties().operator[]("BufferPool"));
+    } else if(_bufferPool == nullptr) {
+        _bufferPool = BufferPool::create(16 * 1024, 8);
+    }
+
+    if(getProperties().contains("Socket")) {
+        _socket = Ichor::any_cast<int>(getProperties().operator[]("Socket"));
+
+        ICHOR_LOG_TRACE(_logger, "Starting io_uring connection for existing socket");
+    } else {
+        if(!getProperties().contains("Address")) {
+            getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "Missing \"Address\" in properties");
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
+        if(!getProperties().contains("Port")) {
+            getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 1, "Missing \"Port\" in properties");
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
+        // The start function possibly gets called multiple times due to trying to recover from not being able to connect
+        if(_socket == -1) {
+            _socket = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (_socket == -1) {
+                getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "Couldn't create socket: errno = " + std::to_string(errno));
+                return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+            }
+        }
+
+        int setting = 1;
+        ::setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(Ichor::any_cast<uint16_t>((getProperties())["Port"]));
+
+        int ret = inet_pton(AF_INET, Ichor::any_cast<std::string&>((getProperties())["Address"]).c_str(), &address.sin_addr);
+        if(ret == 0)
+        {
+            getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 3, "inet_pton invalid address for given address family (has to be ipv4-valid address)");
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
+        // Services depending on this one expect to be able to send as soon as it started, so connect before that.
+        if(connect(_socket, (struct sockaddr *)&address, sizeof(address)) < 0)
+        {
+            ICHOR_LOG_ERROR(_logger, "connect error {}", errno);
+            if(_attempts < 5) {
+                _attempts++;
+                return Ichor::StartBehaviour::FAILED_AND_RETRY;
+            }
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+
+        auto ip = ::inet_ntoa(address.sin_addr);
+        ICHOR_LOG_TRACE(_logger, "Starting io_uring connection for {}:{}", ip, ::ntohs(address.sin_port));
+    }
+
+    _quit = false;
+    _highWaterMarkHandlerRegistration = getManager().registerEventHandler<QueueHighWaterMarkEvent>(this);
+    _lowWaterMarkHandlerRegistration = getManager().registerEventHandler<QueueLowWaterMarkEvent>(this);
+    _paused = getManager().getEventQueue().isAboveHighWaterMark();
+
+    if(!_paused) {
+        startReceiving();
+    }
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+Ichor::StartBehaviour Ichor::IoUringConnectionService::stop() {
+    _quit = true;
+    _highWaterMarkHandlerRegistration.reset();
+    _lowWaterMarkHandlerRegistration.reset();
+
+    // the operations own their buffers, the callbacks won't be called anymore
+    if(_recvOperation != 0) {
+        _queue->cancel(_recvOperation);
+        _recvOperation = 0;
+    }
+    failOutbox();
+    _recvBuffer.reset();
+    _recvEnd = 0;
+
+    if(_socket >= 0) {
+        ::shutdown(_socket, SHUT_RDWR);
+        ::close(_socket);
+        _socket = -1;
+    }
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+Ichor::AsyncGenerator<void> Ichor::IoUringConnectionService::handleEvent(QueueHighWaterMarkEvent const &) {
+    ICHOR_LOG_TRACE(_logger, "Event queue above high water mark, pausing receiving");
+    _paused = true;
+    if(_recvOperation != 0) {
+        _queue->cancel(_recvOperation);
+        _recvOperation = 0;
+    }
+    co_return;
+}
+
+Ichor::AsyncGenerator<void> Ichor::IoUringConnectionService::handleEvent(QueueLowWaterMarkEvent const &) {
+    ICHOR_LOG_TRACE(_logger, "Event queue below low water mark, resuming receiving");
+    _paused = false;
+    if(_recvOperation == 0 && !_quit) {
+        startReceiving();
+    }
+    co_return;
+}
+
+void Ichor::IoUringConnectionService::addDependencyInstance(ILogger *logger, IService *) {
+    _logger = logger;
+}
+
+void Ichor::IoUringConnectionService::removeDependencyInstance(ILogger *logger, IService *) {
+    _logger = nullptr;
+}
+
+void Ichor::IoUringConnectionService::startReceiving() {
+    _recvOperation = _queue->multishotRecv(_socket, [this](int32_t res, std::span<uint8_t const> data) {
+        if(res > 0) {
+            if(data.size() > _bufferPool->bufferSize()) {
+                getManager().pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, std::vector<uint8_t>{data.begin(), data.end()});
+                return;
+            }
+
+            // consecutive receives share a pooled buffer until it is full
+            if(!_recvBuffer || _recvBuffer.capacity() - _recvEnd < data.size()) {
+                _recvBuffer = _bufferPool->acquire();
+                _recvEnd = 0;
+            }
+
+            std::memcpy(_recvBuffer.data() + _recvEnd, data.data(), data.size());
+            getManager().pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, _recvBuffer.slice(_recvEnd, data.size()));
+            _recvEnd += data.size();
+            return;
+        }
+
+        _recvOperation = 0;
+
+        if(res == 0) {
+            ICHOR_LOG_TRACE(_logger, "Peer closed the connection");
+            return;
+        }
+
+        ICHOR_LOG_ERROR(_logger, "Error receiving from socket: {}", -res);
+        getManager().pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Error receiving from socket. errno = " + std::to_string(-res));
+    });
+}
+
+uint64_t Ichor::IoUringConnectionService::sendAsync(std::vector<uint8_t> &&msg) {
+    auto id = ++_msgIdCounter;
+
+    if(_quit) {
+        getManager().pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), id);
+        return id;
+    }
+
+    _outbox.emplace_back(id, std::move(msg));
+
+    if(_sendOperation == 0) {
+        sendNext();
+    }
+
+    return id;
+}
+
+void Ichor::IoUringConnectionService::sendNext() {
+    if(_outbox.empty()) {
+        return;
+    }
+
+    auto [msgId, msg] = std::move(_outbox.front());
+    _outbox.pop_front();
+    sendRemainder(std::move(msg), msgId, 0);
+}
+
+void Ichor::IoUringConnectionService::sendRemainder(std::vector<uint8_t> &&msg, uint64_t msgId, uint64_t sent) {
+    // moving the message into the callback keeps its data where it is
+    auto const *data = msg.data() + sent;
+    auto const len = msg.size() - sent;
+    _sendingMsgId = msgId;
+    _sendingMsg = std::span<uint8_t const>{msg.data(), msg.size()};
+
+    _sendOperation = _queue->submit([this, data, len](io_uring_sqe &sqe) {
+        io_uring_prep_send(&sqe, _socket, data, len, MSG_NOSIGNAL);
+    }, [this, msg = std::move(msg), msgId, sent](int32_t res, uint32_t) mutable {
+        _sendOperation = 0;
+
+        if(res < 0) {
+            ICHOR_LOG_ERROR(_logger, "Error sending to socket: {}", -res);
+            getManager().pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), msgId);
+        } else if(sent + static_cast<uint64_t>(res) < msg.size()) {
+            sendRemainder(std::move(msg), msgId, sent + static_cast<uint64_t>(res));
+            return;
+        }
+
+        sendNext();
+    });
+}
+
+void Ichor::IoUringConnectionService::failOutbox() {
+    if(_sendOperation != 0) {
+        // the cancelled operation keeps owning the message until the kernel is done with it, report a copy
+        _queue->cancel(_sendOperation);
+        _sendOperation = 0;
+        getManager().pushEvent<FailedSendMessageEvent>(getServiceId(), std::vector<uint8_t>{_sendingMsg.begin(), _sendingMsg.end()}, _sendingMsgId);
+    }
+    _sendingMsg = {};
+
+    for(auto &[msgId, msg] : _outbox) {
+        getManager().pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), msgId);
+    }
+    _outbox.clear();
+}
+
+void Ichor::IoUringConnectionService::setPriority(uint64_t priority) {
+    _priority = priority;
+}
+
+uint64_t Ichor::IoUringConnectionService::getPriority() {
+    return _priority;
+}
+
+#endif
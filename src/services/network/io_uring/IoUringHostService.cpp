@@ -0,0 +1,151 @@
+#ifdef ICHOR_USE_LIBURING
+
+#include <ichor/DependencyManager.h>
+#include <ichor/event_queues/IoUringQueue.h>
+#include <ichor/services/network/IConnectionService.h>
+#include <ichor/services/network/io_uring/IoUringHostService.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <cstring>
+
+Ichor::IoUringHostService::IoUringHostService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _priority(INTERNAL_EVENT_PRIORITY), _quit() {
+    reg.registerDependency<ILogger>(this, true);
+}
+
+Ichor::StartBehaviour Ichor::IoUringHostService::start() {
+    _queue = getManager().getEventQueue().getIoUringQueue();
+    if(_queue == nullptr) {
+        getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 5, "IoUringHostService requires an IoUringQueue");
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    if(getProperties().contains("Priority")) {
+        _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
+    }
+
+    if(getProperties().contains("BufferPool")) {
+        _bufferPool = Ichor::any_cast<std::shared_ptr<BufferPool>&>(getProperties().operator[]("BufferPool"));
+    } else if(_bufferPool == nullptr) {
+        _bufferPool = BufferPool::create();
+    }
+
+    _socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(_socket == -1) {
+        getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "Couldn't create socket: errno = " + std::to_string(errno));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    int setting = 1;
+    ::setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &setting, sizeof(setting));
+
+    if(getProperties().contains("ReusePort") && Ichor::any_cast<bool>(getProperties().operator[]("ReusePort"))) {
+        if(::setsockopt(_socket, SOL_SOCKET, SO_REUSEPORT, &setting, sizeof(setting)) != 0) {
+            auto const err = errno;
+            ::close(_socket);
+            _socket = -1;
+            getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 6, "Couldn't set SO_REUSEPORT: errno = " + std::to_string(err));
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+    }
+    ::setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+
+    auto const addressProp = getProperties().find("Address");
+
+    if(addressProp != cend(getProperties())) {
+        auto hostname = Ichor::any_cast<std::string>(addressProp->second);
+        if(::inet_aton(hostname.c_str(), &address.sin_addr) == 0) {
+            auto *hp = ::gethostbyname(hostname.c_str());
+            if (hp == nullptr) {
+                ::close(_socket);
+                _socket = -1;
+                getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "gethostbyname: errno = " + std::to_string(errno));
+                return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+            }
+
+            memcpy(&address.sin_addr, hp->h_addr, sizeof(address.sin_addr));
+        }
+    } else {
+        address.sin_addr.s_addr = INADDR_ANY;
+    }
+    address.sin_port = ::htons(Ichor::any_cast<uint16_t>((getProperties())["Port"]));
+
+    if(::bind(_socket, (sockaddr *)&address, sizeof(address)) == -1) {
+        auto const err = errno;
+        ::close(_socket);
+        _socket = -1;
+        getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 3, "Couldn't bind socket: errno = " + std::to_string(err));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    if(::listen(_socket, SOMAXCONN) != 0) {
+        auto const err = errno;
+        ::close(_socket);
+        _socket = -1;
+        getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Couldn't listen on socket: errno = " + std::to_string(err));
+        return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+
+    _quit = false;
+    _acceptOperation = _queue->multishotAccept(_socket, [this](int32_t res) {
+        if(res < 0) {
+            _acceptOperation = 0;
+            ICHOR_LOG_ERROR(_logger, "Accepting connections stopped, errno {}", -res);
+            getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Accept generated error. errno = " + std::to_string(-res));
+            return;
+        }
+
+        ICHOR_LOG_TRACE(_logger, "new connection {}", res);
+
+        int noDelay = 1;
+        ::setsockopt(res, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+        Properties props{};
+        props.emplace("Priority", Ichor::make_any<uint64_t>(_priority));
+        props.emplace("Socket", Ichor::make_any<int>(res));
+        props.emplace("BufferPool", Ichor::make_any<std::shared_ptr<BufferPool>>(_bufferPool));
+        _connections.emplace_back(getManager().template createServiceManager<IoUringConnectionService, IConnectionService>(std::move(props)));
+    });
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+Ichor::StartBehaviour Ichor::IoUringHostService::stop() {
+    _quit = true;
+
+    if(_acceptOperation != 0) {
+        _queue->cancel(_acceptOperation);
+        _acceptOperation = 0;
+    }
+
+    if(_socket >= 0) {
+        ::shutdown(_socket, SHUT_RDWR);
+        ::close(_socket);
+        _socket = -1;
+    }
+
+    return Ichor::StartBehaviour::SUCCEEDED;
+}
+
+void Ichor::IoUringHostService::addDependencyInstance(ILogger *logger, IService *) {
+    _logger = logger;
+}
+
+void Ichor::IoUringHostService::removeDependencyInstance(ILogger *logger, IService *) {
+    _logger = nullptr;
+}
+
+void Ichor::IoUringHostService::setPriority(uint64_t priority) {
+    _priority = priority;
+}
+
+uint64_t Ichor::IoUringHostService::getPriority() {
+    return _priority;
+}
+
+#endif
@@ -3,11 +3,23 @@
 #include <ichor/DependencyManager.h>
 #include <ichor/services/network/tcp/TcpConnectionService.h>
 #include <ichor/services/network/NetworkEvents.h>
+#include <ichor/events/RunFunctionEvent.h>
 #include <arpa/inet.h>
 #include <sys/socket.h>
 #include <netinet/tcp.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+#include <cerrno>
+
+namespace {
+    // messages gathered into a single sendmsg() call
+    constexpr uint64_t MAX_IOVECS_PER_SEND = 64;
+    // a receive buffer with less room left than this is replaced instead of reading only a few bytes into it
+    constexpr uint64_t MIN_RECV_SPACE = 1024;
+    // buffers filled per readiness callback, the rest is read after the events holding them were handled, bounding the buffers in use per connection
+    constexpr uint64_t MAX_BUFFERS_PER_DRAIN = 4;
+}
 
 Ichor::TcpConnectionService::TcpConnectionService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng), _socket(-1), _attempts(), _priority(INTERNAL_EVENT_PRIORITY),  _quit() {
     reg.registerDependency<ILogger>(this, true);
@@ -18,6 +30,23 @@ Ichor::StartBehaviour Ichor::TcpConnectionService::start() {
         _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
     }
 
+    if(getProperties().contains("BatchSends")) {
+        _batchSends = Ichor::any_cast<bool>(getProperties().operator[]("BatchSends"));
+    }
+
+    if(getProperties().contains("ReportSentMessages")) {
+        _reportSentMessages = Ichor::any_cast<bool>(getProperties().operator[]("ReportSentMessages"));
+    }
+
+    if(getProperties().contains("CoalesceReads")) {
+        _coalesceReads = Ichor::any_cast<bool>(getProperties().operator[]("CoalesceReads"));
+    }
+
+    if(getProperties().contains("BufferPool")) {
+        _bufferPool = Ichor::any_cast<std::shared_ptr<BufferPool>&>(getProperties().operator[]("BufferPool"));
+    } else if(_bufferPool == nullptr) {
+        _bufferPool = BufferPool::create(16 * 1024, 8);
+    }
 
     if(getProperties().contains("Socket")) {
         _socket = Ichor::any_cast<int>(getProperties().operator[]("Socket"));
@@ -45,8 +74,6 @@ Ichor::StartBehaviour Ichor::TcpConnectionService::start() {
 
         int setting = 1;
         ::setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
-        auto flags = ::fcntl(_socket, F_GETFL, 0);
-        ::fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
 
         sockaddr_in address{};
         address.sin_family = AF_INET;
@@ -73,42 +100,183 @@ Ichor::StartBehaviour Ichor::TcpConnectionService::start() {
         ICHOR_LOG_TRACE(_logger, "Starting TCP connection for {}:{}", ip, ::ntohs(address.sin_port));
     }
 
-    _timerManager = getManager().createServiceManager<Timer, ITimer>();
-    _timerManager->setChronoInterval(20ms);
-    _timerManager->setCallback(this, [this](DependencyManager &dm) -> AsyncGenerator<void> {
-        std::array<char, 1024> buf;
-        auto ret = recv(_socket, buf.data(), buf.size(), 0);
+    // connecting blocks, reading never does
+    auto flags = ::fcntl(_socket, F_GETFL, 0);
+    ::fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
 
-        if (ret == 0) {
-            co_return;
-        }
+    _quit = false;
+    _readClosed = false;
+    _waitingForWritable = false;
+    _scheduledFlush = nullptr;
+    _highWaterMarkHandlerRegistration = getManager().registerEventHandler<QueueHighWaterMarkEvent>(this);
+    _lowWaterMarkHandlerRegistration = getManager().registerEventHandler<QueueLowWaterMarkEvent>(this);
+    _paused = getManager().getEventQueue().isAboveHighWaterMark();
 
-        if(ret < 0) {
-            ICHOR_LOG_ERROR(_logger, "Error receiving from socket: {}", errno);
-            getManager().pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Error receiving from socket. errno = " + std::to_string(errno));
-            co_return;
-        }
+    if(getManager().getEventQueue().supportsFds()) {
+        updateWatch();
+    } else {
+        _timerManager = getManager().createServiceManager<Timer, ITimer>();
+        _timerManager->setChronoInterval(20ms);
+        _timerManager->setCallback(this, [this](DependencyManager &dm) -> AsyncGenerator<void> {
+            if(_quit) {
+                co_return;
+            }
 
-        getManager().pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, std::vector<uint8_t>{buf.data(), buf.data() + ret});
-        co_return;
-    });
-    _timerManager->startTimer();
+            if(!_outbox.empty()) {
+                flushOutbox();
+            }
+
+            if(!_paused && !_readClosed && !drainSocket()) {
+                _readClosed = true;
+            }
+            co_return;
+        });
+        _timerManager->startTimer();
+    }
 
     return Ichor::StartBehaviour::SUCCEEDED;
 }
 
 Ichor::StartBehaviour Ichor::TcpConnectionService::stop() {
     _quit = true;
+    updateWatch();
     _timerManager = nullptr;
+    _highWaterMarkHandlerRegistration.reset();
+    _lowWaterMarkHandlerRegistration.reset();
+    // the scheduled flush event may only be handled after this service is gone
+    if(_scheduledFlush) {
+        *_scheduledFlush = false;
+        _scheduledFlush = nullptr;
+    }
+    failOutbox();
+    // handlers may still hold slices of it, those keep it alive
+    _recvBuffer.reset();
+    _recvPushed = 0;
+    _recvEnd = 0;
 
     if(_socket >= 0) {
         ::shutdown(_socket, SHUT_RDWR);
         ::close(_socket);
+        _socket = -1;
     }
 
     return Ichor::StartBehaviour::SUCCEEDED;
 }
 
+Ichor::AsyncGenerator<void> Ichor::TcpConnectionService::handleEvent(QueueHighWaterMarkEvent const &) {
+    ICHOR_LOG_TRACE(_logger, "Event queue above high water mark, pausing reading");
+    _paused = true;
+    updateWatch();
+    co_return;
+}
+
+Ichor::AsyncGenerator<void> Ichor::TcpConnectionService::handleEvent(QueueLowWaterMarkEvent const &) {
+    ICHOR_LOG_TRACE(_logger, "Event queue below low water mark, resuming reading");
+    _paused = false;
+    updateWatch();
+    co_return;
+}
+
+void Ichor::TcpConnectionService::updateWatch() {
+    if(_timerManager != nullptr || _socket < 0) {
+        return;
+    }
+
+    bool const wantRead = !_paused && !_quit && !_readClosed;
+    bool const wantWrite = _waitingForWritable && !_quit;
+
+    if(!wantRead && !wantWrite) {
+        if(_fdWatch != 0) {
+            getManager().getEventQueue().removeFd(_fdWatch);
+            _fdWatch = 0;
+        }
+        return;
+    }
+
+    auto const interest = wantRead && wantWrite ? FdInterest::READ_WRITE : (wantRead ? FdInterest::READ : FdInterest::WRITE);
+
+    if(_fdWatch == 0) {
+        _fdWatch = getManager().getEventQueue().addFd(_socket, interest, [this](FdReadiness readiness) {
+            // errors are reported as hangups, the send fails and reports them
+            if(_waitingForWritable && (readiness.writable || readiness.hangup)) {
+                flushOutbox();
+            }
+
+            if(!_paused && !_readClosed && (readiness.readable || readiness.hangup) && !drainSocket()) {
+                _readClosed = true;
+            }
+
+            updateWatch();
+        });
+    } else if(interest != _watchInterest) {
+        getManager().getEventQueue().modifyFd(_fdWatch, interest);
+    }
+
+    _watchInterest = interest;
+}
+
+bool Ichor::TcpConnectionService::drainSocket() {
+    bool open = true;
+    uint64_t buffersAcquired{};
+
+    // stop early when the queue fills up, the water mark events only arrive after this returns
+    while(!getManager().getEventQueue().isAboveHighWaterMark()) {
+        if(!_recvBuffer || _recvBuffer.capacity() - _recvEnd < MIN_RECV_SPACE) {
+            // a watched socket stays readable, polling with a timer has to read everything
+            if(_fdWatch != 0 && buffersAcquired == MAX_BUFFERS_PER_DRAIN) {
+                break;
+            }
+            buffersAcquired++;
+            pushReceived();
+            _recvBuffer = _bufferPool->acquire();
+            _recvPushed = 0;
+            _recvEnd = 0;
+        }
+
+        // only bytes past the ones already pushed get written, so slices handed out earlier stay untouched
+        auto ret = ::recv(_socket, _recvBuffer.data() + _recvEnd, _recvBuffer.capacity() - _recvEnd, 0);
+
+        if(ret == 0) {
+            ICHOR_LOG_TRACE(_logger, "Peer closed the connection");
+            open = false;
+            break;
+        }
+
+        if(ret < 0) {
+            if(errno == EAGAIN) {
+                break;
+            }
+            if(errno == EINTR) {
+                continue;
+            }
+
+            ICHOR_LOG_ERROR(_logger, "Error receiving from socket: {}", errno);
+            getManager().pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Error receiving from socket. errno = " + std::to_string(errno));
+            open = false;
+            break;
+        }
+
+        _recvEnd += static_cast<uint64_t>(ret);
+
+        if(!_coalesceReads) {
+            pushReceived();
+        }
+    }
+
+    pushReceived();
+
+    return open;
+}
+
+void Ichor::TcpConnectionService::pushReceived() {
+    if(_recvEnd == _recvPushed) {
+        return;
+    }
+
+    getManager().pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, _recvBuffer.slice(_recvPushed, _recvEnd - _recvPushed));
+    _recvPushed = _recvEnd;
+}
+
 void Ichor::TcpConnectionService::addDependencyInstance(ILogger *logger, IService *) {
     _logger = logger;
 }
@@ -119,22 +287,106 @@ void Ichor::TcpConnectionService::removeDependencyInstance(ILogger *logger, ISer
 
 uint64_t Ichor::TcpConnectionService::sendAsync(std::vector<uint8_t> &&msg) {
     auto id = ++_msgIdCounter;
-    size_t sent_bytes = 0;
 
-    while(sent_bytes < msg.size()) {
-        auto ret = ::send(_socket, msg.data() + sent_bytes, msg.size() - sent_bytes, 0);
+    if(_quit || _socket < 0) {
+        getManager().pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), id);
+        return id;
+    }
 
-        if(ret == -1) {
-            getManager().pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg), id);
-            break;
-        }
+    _outbox.push_back(OutboxMessage{id, std::move(msg), 0});
+
+    // the message goes out with the rest of the outbox once the socket is writable or the scheduled flush runs
+    if(_waitingForWritable || _scheduledFlush) {
+        return id;
+    }
+
+    if(_batchSends) {
+        // everything sent until this event gets handled goes out in as few syscalls as possible
+        _scheduledFlush = std::make_shared<bool>(true);
+        getManager().pushPrioritisedEvent<RunFunctionEvent>(getServiceId(), _priority, [this, scheduled = _scheduledFlush](DependencyManager &) -> AsyncGenerator<void> {
+            // cleared by stop(), don't touch this service anymore
+            if(!*scheduled) {
+                co_return;
+            }
 
-        sent_bytes += ret;
+            _scheduledFlush = nullptr;
+            flushOutbox();
+            updateWatch();
+            co_return;
+        });
+        return id;
     }
 
+    flushOutbox();
+    updateWatch();
+
     return id;
 }
 
+void Ichor::TcpConnectionService::flushOutbox() {
+    std::array<iovec, MAX_IOVECS_PER_SEND> iovecs;
+
+    while(!_outbox.empty()) {
+        uint64_t count{};
+        for(auto it = _outbox.begin(); it != _outbox.end() && count < iovecs.size(); ++it, ++count) {
+            iovecs[count].iov_base = it->data.data() + it->sent;
+            iovecs[count].iov_len = it->data.size() - it->sent;
+        }
+
+        msghdr hdr{};
+        hdr.msg_iov = iovecs.data();
+        hdr.msg_iovlen = count;
+        int flags = MSG_NOSIGNAL | MSG_DONTWAIT;
+        // the rest of the outbox follows right away, so let the kernel wait for it to fill up segments
+        if(_batchSends && count < _outbox.size()) {
+            flags |= MSG_MORE;
+        }
+
+        auto ret = ::sendmsg(_socket, &hdr, flags);
+
+        if(ret < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            if(errno == EAGAIN) {
+                _waitingForWritable = true;
+                return;
+            }
+
+            ICHOR_LOG_ERROR(_logger, "Error sending to socket: {}", errno);
+            failOutbox();
+            return;
+        }
+
+        auto written = static_cast<uint64_t>(ret);
+        while(!_outbox.empty()) {
+            auto &msg = _outbox.front();
+            auto const remaining = msg.data.size() - msg.sent;
+
+            if(written < remaining) {
+                msg.sent += written;
+                break;
+            }
+
+            written -= remaining;
+            if(_reportSentMessages) {
+                getManager().pushPrioritisedEvent<SentMessageEvent>(getServiceId(), _priority, msg.id);
+            }
+            _outbox.pop_front();
+        }
+    }
+
+    _waitingForWritable = false;
+}
+
+void Ichor::TcpConnectionService::failOutbox() {
+    for(auto &msg : _outbox) {
+        getManager().pushEvent<FailedSendMessageEvent>(getServiceId(), std::move(msg.data), msg.id);
+    }
+    _outbox.clear();
+    _waitingForWritable = false;
+}
+
 void Ichor::TcpConnectionService::setPriority(uint64_t priority) {
     _priority = priority;
 }
@@ -20,9 +20,15 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
         _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
     }
 
+    if(getProperties().contains("BufferPool")) {
+        _bufferPool = Ichor::any_cast<std::shared_ptr<BufferPool>&>(getProperties().operator[]("BufferPool"));
+    } else if(_bufferPool == nullptr) {
+        _bufferPool = BufferPool::create();
+    }
+
     _newSocketEventHandlerRegistration = getManager().registerEventHandler<NewSocketEvent>(this);
 
-    _socket = ::socket(AF_INET, SOCK_STREAM, 0);
+    _socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
     if(_socket == -1) {
         getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 0, "Couldn't create socket: errno = " + std::to_string(errno));
         return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
@@ -30,6 +36,17 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
 
     int setting = 1;
     ::setsockopt(_socket, SOL_SOCKET, SO_REUSEADDR, &setting, sizeof(setting));
+
+    // every manager binds its own socket to the same address and port, the kernel distributes the connections over them
+    if(getProperties().contains("ReusePort") && Ichor::any_cast<bool>(getProperties().operator[]("ReusePort"))) {
+        if(::setsockopt(_socket, SOL_SOCKET, SO_REUSEPORT, &setting, sizeof(setting)) != 0) {
+            auto const err = errno;
+            ::close(_socket);
+            _socket = -1;
+            getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 5, "Couldn't set SO_REUSEPORT: errno = " + std::to_string(err));
+            return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
+        }
+    }
     ::setsockopt(_socket, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
     auto flags = ::fcntl(_socket, F_GETFL, 0);
     ::fcntl(_socket, F_SETFL, flags | O_NONBLOCK);
@@ -41,12 +58,11 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
 
     if(addressProp != cend(getProperties())) {
         auto hostname = Ichor::any_cast<std::string>(addressProp->second);
-        if(::inet_aton(hostname.c_str(), &address.sin_addr) != 0) {
-            getManager().pushEvent<RecoverableErrorEvent>(getServiceId(), 1, "inet_aton: errno = " + std::to_string(errno));
+        if(::inet_aton(hostname.c_str(), &address.sin_addr) == 0) {
             auto *hp = ::gethostbyname(hostname.c_str());
             if (hp == nullptr) {
+                ::close(_socket);
                 _socket = -1;
-                close(_socket);
                 getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 2, "gethostbyname: errno = " + std::to_string(errno));
                 return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
             }
@@ -61,43 +77,41 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
     _bindFd = ::bind(_socket, (sockaddr *)&address, sizeof(address));
 
     if(_bindFd == -1) {
+        ::close(_socket);
         _socket = -1;
-        close(_socket);
         getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 3, "Couldn't bind socket: errno = " + std::to_string(errno));
         return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
     }
 
-    if(::listen(_socket, 10) != 0) {
+    if(::listen(_socket, SOMAXCONN) != 0) {
+        ::close(_socket);
         _socket = -1;
-        close(_socket);
         getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Couldn't listen on socket: errno = " + std::to_string(errno));
         return Ichor::StartBehaviour::FAILED_DO_NOT_RETRY;
     }
 
-    _timerManager = getManager().createServiceManager<Timer, ITimer>();
-    _timerManager->setChronoInterval(20ms);
-    _timerManager->setCallback(this, [this](DependencyManager &dm) -> AsyncGenerator<void> {
-        sockaddr_in client_addr{};
-        socklen_t client_addr_size = sizeof(client_addr);
-        int newConnection = ::accept(_socket, (sockaddr *) &client_addr, &client_addr_size);
+    _quit = false;
 
-        if (newConnection == -1) {
-            ICHOR_LOG_ERROR(_logger, "New connection but accept() returned {} errno {}", newConnection, errno);
-            if(errno == EINVAL) {
-                getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(errno));
+    if(getManager().getEventQueue().supportsFds()) {
+        watchSocket();
+    } else {
+        _timerManager = getManager().createServiceManager<Timer, ITimer>();
+        _timerManager->setChronoInterval(20ms);
+        _timerManager->setCallback(this, [this](DependencyManager &dm) -> AsyncGenerator<void> {
+            if(_quit) {
                 co_return;
             }
-            getManager().pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(errno));
-            co_return;
-        }
-
-        auto *ip = ::inet_ntoa(client_addr.sin_addr);
-        ICHOR_LOG_TRACE(_logger, "new connection from {}:{}", ip, ::ntohs(client_addr.sin_port));
 
-        getManager().pushPrioritisedEvent<NewSocketEvent>(getServiceId(), _priority, newConnection);
-        co_return;
-    });
-    _timerManager->startTimer();
+            auto const result = acceptConnections();
+            if(result == AcceptResult::FAILED) {
+                _timerManager->stopTimer();
+            } else if(result == AcceptResult::BACK_OFF) {
+                backOff();
+            }
+            co_return;
+        });
+        _timerManager->startTimer();
+    }
 
     return Ichor::StartBehaviour::SUCCEEDED;
 }
@@ -105,11 +119,20 @@ Ichor::StartBehaviour Ichor::TcpHostService::start() {
 Ichor::StartBehaviour Ichor::TcpHostService::stop() {
     _quit = true;
 
+    if(_fdWatch != 0) {
+        getManager().getEventQueue().removeFd(_fdWatch);
+        _fdWatch = 0;
+    }
     _timerManager = nullptr;
+    if(_backoffTimer != nullptr) {
+        _backoffTimer->stopTimer();
+        _backoffTimer = nullptr;
+    }
 
     if(_socket >= 0) {
         ::shutdown(_socket, SHUT_RDWR);
         ::close(_socket);
+        _socket = -1;
     }
 
     _newSocketEventHandlerRegistration.reset();
@@ -117,6 +140,80 @@ Ichor::StartBehaviour Ichor::TcpHostService::stop() {
     return Ichor::StartBehaviour::SUCCEEDED;
 }
 
+void Ichor::TcpHostService::watchSocket() {
+    _fdWatch = getManager().getEventQueue().addFd(_socket, FdInterest::READ, [this](FdReadiness) {
+        auto const result = acceptConnections();
+        if(result == AcceptResult::WOULD_BLOCK) {
+            return;
+        }
+
+        getManager().getEventQueue().removeFd(_fdWatch);
+        _fdWatch = 0;
+        if(result == AcceptResult::BACK_OFF) {
+            backOff();
+        }
+    });
+}
+
+void Ichor::TcpHostService::backOff() {
+    if(_timerManager != nullptr) {
+        _timerManager->stopTimer();
+    }
+
+    if(_backoffTimer == nullptr) {
+        _backoffTimer = getManager().createServiceManager<Timer, ITimer>();
+        _backoffTimer->setChronoInterval(ACCEPT_BACKOFF);
+        _backoffTimer->setCallback(this, [this](DependencyManager &) -> AsyncGenerator<void> {
+            _backoffTimer->stopTimer();
+            if(_quit) {
+                co_return;
+            }
+
+            if(_timerManager != nullptr) {
+                _timerManager->startTimer();
+            } else {
+                watchSocket();
+            }
+            co_return;
+        });
+    }
+    _backoffTimer->startTimer();
+}
+
+Ichor::TcpHostService::AcceptResult Ichor::TcpHostService::acceptConnections() {
+    while(true) {
+        sockaddr_in client_addr{};
+        socklen_t client_addr_size = sizeof(client_addr);
+        int newConnection = ::accept4(_socket, (sockaddr *) &client_addr, &client_addr_size, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (newConnection == -1) {
+            // logging may overwrite errno
+            auto const err = errno;
+            if(err == EAGAIN) {
+                return AcceptResult::WOULD_BLOCK;
+            }
+            // the connection was reset before it could be accepted
+            if(err == EINTR || err == ECONNABORTED) {
+                continue;
+            }
+
+            ICHOR_LOG_ERROR(_logger, "New connection but accept() returned {} errno {}", newConnection, err);
+            if(err == EINVAL) {
+                getManager().pushEvent<UnrecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(err));
+                return AcceptResult::FAILED;
+            }
+            // EMFILE, ENFILE, ENOBUFS, ENOMEM and the like don't go away by accepting again right away
+            getManager().pushEvent<RecoverableErrorEvent>(getServiceId(), 4, "Accept() generated error. errno = " + std::to_string(err));
+            return AcceptResult::BACK_OFF;
+        }
+
+        auto *ip = ::inet_ntoa(client_addr.sin_addr);
+        ICHOR_LOG_TRACE(_logger, "new connection from {}:{}", ip, ::ntohs(client_addr.sin_port));
+
+        getManager().pushPrioritisedEvent<NewSocketEvent>(getServiceId(), _priority, newConnection);
+    }
+}
+
 void Ichor::TcpHostService::addDependencyInstance(ILogger *logger, IService *) {
     _logger = logger;
 }
@@ -137,6 +234,14 @@ Ichor::AsyncGenerator<void> Ichor::TcpHostService::handleEvent(NewSocketEvent co
     Properties props{};
     props.emplace("Priority", Ichor::make_any<uint64_t>(_priority));
     props.emplace("Socket", Ichor::make_any<int>(evt.socket));
+    // send options apply to every accepted connection
+    for(auto const &key : {"BatchSends", "ReportSentMessages", "CoalesceReads"}) {
+        auto const prop = getProperties().find(key);
+        if(prop != cend(getProperties())) {
+            props.emplace(key, prop->second);
+        }
+    }
+    props.emplace("BufferPool", Ichor::make_any<std::shared_ptr<BufferPool>>(_bufferPool));
     _connections.emplace_back(getManager().template createServiceManager<TcpConnectionService, IConnectionService>(std::move(props)));
 
     co_return;
@@ -6,6 +6,7 @@
 #include <ichor/services/network/ws/WsCopyIsMoveWorkaround.h>
 #include <ichor/services/network/NetworkEvents.h>
 #include <ichor/services/network/IHostService.h>
+#include <cstring>
 
 template<class NextLayer>
 void setup_stream(std::unique_ptr<websocket::stream<NextLayer>>& ws)
@@ -41,6 +42,12 @@ Ichor::StartBehaviour Ichor::WsConnectionService::start() {
             _priority = Ichor::any_cast<uint64_t>(getProperties().operator[]("Priority"));
         }
 
+        if (getProperties().contains("BufferPool")) {
+            _bufferPool = Ichor::any_cast<std::shared_ptr<BufferPool>&>(getProperties().operator[]("BufferPool"));
+        } else if (!_bufferPool) {
+            _bufferPool = BufferPool::create(16 * 1024, 8);
+        }
+
         if (getProperties().contains("Socket")) {
             net::spawn(*_httpContextService->getContext(), [this](net::yield_context yield) {
                 accept(std::move(yield));
@@ -261,8 +268,11 @@ void Ichor::WsConnectionService::connect(net::yield_context yield) {
 void Ichor::WsConnectionService::read(net::yield_context &yield) {
     beast::error_code ec;
 
+    // reused for every message, so it only allocates while growing to the largest message received
+    beast::basic_flat_buffer buffer{std::allocator<uint8_t>{}};
+
     while(!_quit && !_httpContextService->fibersShouldStop()) {
-        beast::basic_flat_buffer buffer{std::allocator<uint8_t>{}};
+        buffer.consume(buffer.size());
 
         _ws->async_read(buffer, yield[ec]);
 
@@ -280,7 +290,16 @@ void Ichor::WsConnectionService::read(net::yield_context &yield) {
 
         if(_ws->got_text()) {
             auto data = buffer.data();
-            getManager().pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority,  std::vector<uint8_t>{static_cast<char*>(data.data()), static_cast<char*>(data.data()) + data.size()});
+            auto const *bytes = static_cast<uint8_t const*>(data.data());
+
+            // messages that don't fit in a pooled buffer get their own allocation
+            if(data.size() <= _bufferPool->bufferSize()) {
+                auto pooled = _bufferPool->acquire();
+                std::memcpy(pooled.data(), bytes, data.size());
+                getManager().pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, pooled.slice(0, data.size()));
+            } else {
+                getManager().pushPrioritisedEvent<NetworkDataEvent>(getServiceId(), _priority, std::vector<uint8_t>{bytes, bytes + data.size()});
+            }
         }
     }
 
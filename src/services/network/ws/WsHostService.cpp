@@ -97,7 +97,8 @@ void Ichor::WsHostService::removeDependencyInstance(IHttpContextService *logger,
 Ichor::AsyncGenerator<void> Ichor::WsHostService::handleEvent(Ichor::NewWsConnectionEvent const &evt) {
     auto connection = getManager().createServiceManager<WsConnectionService, IConnectionService>(Ichor::make_properties(
         IchorProperty{"WsHostServiceId", Ichor::make_any<uint64_t>(getServiceId())},
-        IchorProperty{"Socket", Ichor::make_any<decltype(evt._socket)>(std::move(evt._socket))}
+        IchorProperty{"Socket", Ichor::make_any<decltype(evt._socket)>(std::move(evt._socket))},
+        IchorProperty{"BufferPool", Ichor::make_any<std::shared_ptr<BufferPool>>(_bufferPool)}
         ));
     _connections.push_back(connection);
 
@@ -24,18 +24,19 @@ void Ichor::Timer::startTimer(bool fireImmediately) {
 
     bool expected = true;
     if(_quit.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) {
-        _eventInsertionThread = std::make_unique<std::thread>([this, fireImmediately]() { this->insertEventLoop(fireImmediately); });
-#ifdef __linux__
-        pthread_setname_np(_eventInsertionThread->native_handle(), fmt::format("Tmr #{}", getServiceId()).c_str());
-#endif
+        _nextTick = std::chrono::steady_clock::now();
+        if(!fireImmediately) {
+            _nextTick += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
+        }
+        scheduleTick(_generation->fetch_add(1, std::memory_order_acq_rel) + 1);
     }
 }
 
 void Ichor::Timer::stopTimer() {
     bool expected = false;
     if(_quit.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
-        _eventInsertionThread->join();
-        _eventInsertionThread = nullptr;
+        // invalidates the pending tick
+        _generation->fetch_add(1, std::memory_order_acq_rel);
     }
 }
 
@@ -61,24 +62,19 @@ uint64_t Ichor::Timer::getPriority() const noexcept {
     return _priority.load(std::memory_order_acquire);
 }
 
-void Ichor::Timer::insertEventLoop(bool fireImmediately) {
-    auto now = std::chrono::steady_clock::now();
-    auto next = now;
-    if(!fireImmediately) {
-        next += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
-    }
-    while(!_quit.load(std::memory_order_acquire)) {
-        while(now < next) {
-            std::this_thread::sleep_for(std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire)/10));
-            now = std::chrono::steady_clock::now();
-
-            if(_quit.load(std::memory_order_acquire)) {
-                return;
-            }
+void Ichor::Timer::scheduleTick(uint64_t generation) {
+    getManager().pushEventAt<RunFunctionEvent>(getServiceId(), _priority.load(std::memory_order_acquire), _nextTick, [this, generation, currentGeneration = _generation](DependencyManager &dm) -> AsyncGenerator<void> {
+        // the timer has been stopped, restarted or destroyed since this tick was scheduled
+        if(currentGeneration->load(std::memory_order_acquire) != generation) {
+            co_return;
         }
+
         // Make copy of function, in case setCallback() gets called during async stuff.
-        getManager().pushPrioritisedEvent<RunFunctionEvent>(_requestingServiceId, _priority.load(std::memory_order_acquire), _fn);
+        dm.pushPrioritisedEvent<RunFunctionEvent>(_requestingServiceId, _priority.load(std::memory_order_acquire), _fn);
 
-        next += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
-    }
-}
\ No newline at end of file
+        // based on the previous deadline instead of now, so the timer does not drift
+        _nextTick += std::chrono::nanoseconds(_intervalNanosec.load(std::memory_order_acquire));
+        scheduleTick(generation);
+        co_return;
+    });
+}
@@ -237,5 +237,52 @@ TEST_CASE("CoroutineTests") {
         REQUIRE_FALSE(dm.isRunning());
     }
 
+    SECTION("stopping service waits for its coroutines") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        _evt = std::make_unique<Ichor::AsyncManualResetEvent>();
+        AwaitService *svc{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            svc = dm.createServiceManager<AwaitService, IAwaitService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.runForOrQueueEmpty();
+
+        dm.pushEvent<RunFunctionEvent>(svc->getServiceId(), [&](DependencyManager& mng) -> AsyncGenerator<void> {
+            co_await svc->await_something().begin();
+            co_return;
+        });
+
+        dm.runForOrQueueEmpty();
+
+        dm.pushEvent<StopServiceEvent>(0, svc->getServiceId());
+
+        dm.runForOrQueueEmpty();
+
+        // the stop waits for the coroutine without being pushed again
+        REQUIRE(queue->empty());
+        REQUIRE(svc->isStarted());
+
+        dm.pushEvent<RunFunctionEvent>(0, [](DependencyManager& mng) -> AsyncGenerator<void> {
+            _evt->set();
+            co_return;
+        });
+
+        dm.runForOrQueueEmpty();
+
+        REQUIRE_FALSE(svc->isStarted());
+
+        dm.pushEvent<QuitEvent>(0);
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
     _evt.reset();
 }
\ No newline at end of file
@@ -1,8 +1,17 @@
 #include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/event_queues/InlineEventQueue.h>
+#include <ichor/CommunicationChannel.h>
+#include <ichor/RemoteService.h>
 #include <ichor/events/RunFunctionEvent.h>
 #include <ichor/coroutines/AsyncManualResetEvent.h>
 #include "TestServices/UselessService.h"
 #include "TestServices/RegistrationCheckerService.h"
+#include "TestServices/DependencyService.h"
+#include "TestServices/NeverStopsService.h"
+#include "TestServices/WorkerEventHandlerService.h"
+#include "TestServices/ValueCollectorService.h"
+#include "TestServices/AdderService.h"
+#include "TestEvents.h"
 #include "Common.h"
 
 TEST_CASE("DependencyManager") {
@@ -68,6 +77,71 @@ TEST_CASE("DependencyManager") {
         REQUIRE_FALSE(dm.isRunning());
     }
 
+    SECTION("DependencyManager", "Shutdown timeout reports blocking services") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t neverStopsId{};
+        std::optional<ShutdownProgress> progress{};
+        dm.setShutdownTimeout(100ms, [&progress](ShutdownProgress const &p) {
+            progress = p;
+        });
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            neverStopsId = dm.createServiceManager<NeverStopsService, IUselessService>()->getServiceId();
+            dm.createServiceManager<DependencyService<true>, ICountService>();
+            queue->start(CaptureSigInt);
+        });
+
+        dm.runForOrQueueEmpty();
+
+        REQUIRE(dm.isRunning());
+
+        dm.pushEvent<QuitEvent>(0);
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+        REQUIRE(progress.has_value());
+        // the service depending on the blocking one stopped first, it only blocks itself
+        REQUIRE(progress->servicesToStop == 3);
+        REQUIRE(progress->servicesStopped == 2);
+        REQUIRE(progress->blockingServices == std::vector<uint64_t>{neverStopsId});
+    }
+
+    SECTION("DependencyManager", "Create services in bulk") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        std::vector<DependencyService<true>*> dependents{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            // the dependents can only start once the services created after them come online
+            dependents = dm.createServiceManagers<DependencyService<true>, ICountService>(std::vector<Properties>(2));
+            auto dependencies = dm.createServiceManagers<UselessService, IUselessService>(std::vector<Properties>(3));
+            REQUIRE(dependencies.size() == 3);
+            queue->start(CaptureSigInt);
+        });
+
+        dm.runForOrQueueEmpty();
+
+        REQUIRE(dependents.size() == 2);
+
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &_dm) -> AsyncGenerator<void> {
+            REQUIRE(_dm.getServiceCount() == 6);
+            for(auto *dependent : dependents) {
+                REQUIRE(dependent->isRunning());
+                REQUIRE(dependent->getSvcCount() == 3);
+            }
+            _dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
     SECTION("DependencyManager", "Check Registrations") {
         auto queue = std::make_unique<MultimapQueue>();
         auto &dm = queue->createManager();
@@ -139,4 +213,372 @@ TEST_CASE("DependencyManager") {
 
         REQUIRE_FALSE(dm.isRunning());
     }
+
+    SECTION("DependencyManager", "Pooled events") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        constexpr uint64_t eventCount = 1'000;
+        uint64_t allocations{};
+        uint64_t heapAllocations{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            queue->start(CaptureSigInt);
+        });
+
+        dm.runForOrQueueEmpty();
+
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &_dm) -> AsyncGenerator<void> {
+            auto const &allocator = _dm.getEventAllocator();
+            uint64_t const allocationsBefore = allocator.allocations();
+            uint64_t const heapAllocationsBefore = allocator.heapAllocations();
+
+            for(uint64_t i = 0; i < eventCount; i++) {
+                _dm.pushEvent<DoWorkEvent>(0);
+            }
+
+            allocations = allocator.allocations() - allocationsBefore;
+            heapAllocations = allocator.heapAllocations() - heapAllocationsBefore;
+            _dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        t.join();
+
+        REQUIRE(allocations == eventCount);
+        REQUIRE(heapAllocations <= eventCount / EventAllocator::EVENTS_PER_SLAB + 1);
+    }
+
+    SECTION("DependencyManager", "Event type indices") {
+        auto const doWorkIndex = eventTypeIndex<DoWorkEvent>();
+        auto const quitIndex = eventTypeIndex<QuitEvent>();
+
+        REQUIRE(doWorkIndex != 0);
+        REQUIRE(quitIndex != 0);
+        REQUIRE(doWorkIndex != quitIndex);
+        REQUIRE(eventTypeIndex<DoWorkEvent>() == doWorkIndex);
+        REQUIRE(Detail::registerEventType(DoWorkEvent::TYPE) == doWorkIndex);
+        REQUIRE(Detail::findEventTypeIndex(QuitEvent::TYPE) == quitIndex);
+        REQUIRE(Detail::findEventTypeIndex(0) == 0);
+    }
+    SECTION("DependencyManager", "Filter required service id") {
+        Filter byId{ServiceIdFilterEntry{5}};
+        REQUIRE(byId.requiredServiceId() == 5u);
+
+        Filter byProperty{PropertiesFilterEntry<uint64_t>{"Iteration", 5}};
+        REQUIRE_FALSE(byProperty.requiredServiceId().has_value());
+
+        Filter byBoth{PropertiesFilterEntry<uint64_t>{"Iteration", 5}, ServiceIdFilterEntry{6}};
+        REQUIRE(byBoth.requiredServiceId() == 6u);
+    }
+
+    SECTION("DependencyManager", "Worker event handlers") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        constexpr uint64_t eventCount = 1'000;
+        std::vector<WorkerEventHandlerService<TestEvent>*> services{};
+        std::thread::id managerThreadId{};
+        dm.setWorkerThreadCount(4);
+
+        std::thread t([&]() {
+            managerThreadId = std::this_thread::get_id();
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            for(uint32_t i = 0; i < 4; i++) {
+                services.push_back(dm.createServiceManager<WorkerEventHandlerService<TestEvent>>());
+            }
+            queue->start(CaptureSigInt);
+        });
+
+        dm.runForOrQueueEmpty();
+
+        for(uint64_t i = 0; i < eventCount; i++) {
+            dm.pushEvent<TestEvent>(0);
+        }
+
+        // waits for the worker handlers before running
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &_dm) -> AsyncGenerator<void> {
+            for(auto *svc : services) {
+                REQUIRE(svc->handledEvents == eventCount);
+                REQUIRE_FALSE(svc->handledConcurrently);
+                REQUIRE_FALSE(svc->handledOutOfOrder);
+                REQUIRE(svc->lastThreadId != managerThreadId);
+            }
+            _dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+
+    SECTION("DependencyManager", "Throwing worker event handlers") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        constexpr uint64_t eventCount = 10;
+        WorkerEventHandlerService<TestEvent> *svc{};
+        dm.setWorkerThreadCount(2);
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            svc = dm.createServiceManager<WorkerEventHandlerService<TestEvent>>();
+            svc->throwOnEvent = true;
+            queue->start(CaptureSigInt);
+        });
+
+        dm.runForOrQueueEmpty();
+
+        for(uint64_t i = 0; i < eventCount; i++) {
+            dm.pushEvent<TestEvent>(0);
+        }
+
+        // would never run if a throwing handler left its task unfinished
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &_dm) -> AsyncGenerator<void> {
+            REQUIRE(svc->handledEvents == eventCount);
+            _dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        t.join();
+
+        REQUIRE_FALSE(dm.isRunning());
+    }
+    SECTION("DependencyManager", "Events between managers") {
+        CommunicationChannel channel{};
+        auto multimapQueue = std::make_unique<MultimapQueue>();
+        auto &multimapDm = multimapQueue->createManager();
+        auto inlineQueue = std::make_unique<InlineEventQueue>();
+        auto &inlineDm = inlineQueue->createManager();
+        constexpr uint64_t eventCount = 1'000;
+        ValueCollectorService *multimapSvc{};
+        ValueCollectorService *inlineSvc{};
+        channel.addManager(&multimapDm);
+        channel.addManager(&inlineDm);
+
+        std::thread t1([&]() {
+            multimapDm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            multimapSvc = multimapDm.createServiceManager<ValueCollectorService>();
+            multimapQueue->start(CaptureSigInt);
+        });
+
+        std::thread t2([&]() {
+            inlineDm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            inlineSvc = inlineDm.createServiceManager<ValueCollectorService>();
+            inlineQueue->start(CaptureSigInt);
+        });
+
+        multimapDm.runForOrQueueEmpty();
+        inlineDm.runForOrQueueEmpty();
+
+        std::vector<uint64_t> payloads{};
+        for(uint64_t i = 0; i < eventCount; i++) {
+            payloads.push_back(i);
+        }
+
+        // sent from another thread, in order
+        std::thread sender([&]() {
+            channel.sendEventsTo<ValueEvent>(multimapDm.getId(), 0, payloads);
+            for(uint64_t i = 0; i < eventCount; i++) {
+                channel.sendEventTo<ValueEvent>(inlineDm.getId(), 0, eventCount + i);
+            }
+        });
+        sender.join();
+
+        // services are gone once their manager quits
+        std::vector<uint64_t> multimapValues{};
+        std::vector<uint64_t> inlineValues{};
+        channel.sendEventTo<RunFunctionEvent>(multimapDm.getId(), 0, [&](DependencyManager &_dm) -> AsyncGenerator<void> {
+            multimapValues = multimapSvc->values;
+            _dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+        channel.sendEventTo<RunFunctionEvent>(inlineDm.getId(), 0, [&](DependencyManager &_dm) -> AsyncGenerator<void> {
+            inlineValues = inlineSvc->values;
+            _dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        t1.join();
+        t2.join();
+
+        REQUIRE(multimapValues == payloads);
+        REQUIRE(inlineValues.size() == eventCount);
+        for(uint64_t i = 0; i < eventCount; i++) {
+            REQUIRE(inlineValues[i] == eventCount + i);
+        }
+
+        channel.removeManager(&multimapDm);
+        channel.removeManager(&inlineDm);
+    }
+    SECTION("DependencyManager", "Broadcast shared payload") {
+        CommunicationChannel channel{};
+        std::array<std::unique_ptr<MultimapQueue>, 3> queues{};
+        std::array<DependencyManager*, 3> dms{};
+        std::array<ValueCollectorService*, 3> services{};
+        std::array<std::thread, 3> threads{};
+        for(uint32_t i = 0; i < 3; i++) {
+            queues[i] = std::make_unique<MultimapQueue>();
+            dms[i] = &queues[i]->createManager();
+            channel.addManager(dms[i]);
+        }
+        for(uint32_t i = 0; i < 3; i++) {
+            threads[i] = std::thread([&, i]() {
+                dms[i]->createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+                services[i] = dms[i]->createServiceManager<ValueCollectorService>();
+                queues[i]->start(CaptureSigInt);
+            });
+        }
+        for(auto *dm : dms) {
+            dm->runForOrQueueEmpty();
+        }
+
+        auto payload = std::make_shared<std::vector<uint64_t>>(std::vector<uint64_t>{1, 2, 3});
+        auto const *payloadPtr = payload.get();
+        channel.broadcastSharedPayload(*dms[0], 0, std::move(payload));
+
+        // services are gone once their manager quits
+        std::array<std::vector<std::shared_ptr<std::vector<uint64_t> const>>, 3> received{};
+        for(uint32_t i = 0; i < 3; i++) {
+            channel.sendEventTo<RunFunctionEvent>(dms[i]->getId(), 0, [&, i](DependencyManager &_dm) -> AsyncGenerator<void> {
+                received[i] = services[i]->payloads;
+                _dm.pushEvent<QuitEvent>(0);
+                co_return;
+            });
+        }
+        for(auto &t : threads) {
+            t.join();
+        }
+
+        REQUIRE(received[0].empty());
+        for(uint32_t i = 1; i < 3; i++) {
+            REQUIRE(received[i].size() == 1);
+            REQUIRE(received[i][0].get() == payloadPtr);
+            REQUIRE(*received[i][0] == std::vector<uint64_t>{1, 2, 3});
+        }
+
+        for(auto *dm : dms) {
+            channel.removeManager(dm);
+        }
+    }
+    SECTION("DependencyManager", "Remote service calls") {
+        CommunicationChannel channel{};
+        auto callingQueue = std::make_unique<MultimapQueue>();
+        auto &callingDm = callingQueue->createManager();
+        auto owningQueue = std::make_unique<MultimapQueue>();
+        auto &owningDm = owningQueue->createManager();
+        channel.addManager(&callingDm);
+        channel.addManager(&owningDm);
+        std::thread::id callingThreadId{};
+        std::thread::id owningThreadId{};
+
+        std::thread t1([&]() {
+            callingThreadId = std::this_thread::get_id();
+            callingDm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            callingDm.createServiceManager<UselessService>();
+            callingQueue->start(CaptureSigInt);
+        });
+
+        std::thread t2([&]() {
+            owningThreadId = std::this_thread::get_id();
+            owningDm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            owningDm.createServiceManager<AdderService, IAdderService>();
+            owningQueue->start(CaptureSigInt);
+        });
+
+        callingDm.runForOrQueueEmpty();
+        owningDm.runForOrQueueEmpty();
+
+        std::vector<uint64_t> totals{};
+        bool resetRan{};
+        std::thread::id serviceThreadId{};
+        std::thread::id resumedThreadId{};
+        bool missingServiceResult{true};
+        bool exceptionPassedBack{};
+
+        callingDm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &dm) -> AsyncGenerator<void> {
+            RemoteService<IAdderService> adder{dm, owningDm.getId()};
+            for(uint64_t i = 1; i <= 3; i++) {
+                auto total = *co_await adder.call([i](IAdderService &svc) { return svc.add(i); }).begin();
+                REQUIRE(total.has_value());
+                totals.push_back(*total);
+            }
+            // references are copied into the result
+            totals.push_back(**co_await adder.call([](IAdderService &svc) -> uint64_t const& { return svc.total(); }).begin());
+            resetRan = *co_await adder.call([](IAdderService &svc) { svc.reset(); }).begin();
+            serviceThreadId = **co_await adder.call([](IAdderService &svc) { return svc.lastThreadId(); }).begin();
+            resumedThreadId = std::this_thread::get_id();
+
+            // the calling manager has no IAdderService
+            RemoteService<IAdderService> missing{dm, dm.getId()};
+            missingServiceResult = (*co_await missing.call([](IAdderService &svc) { return svc.add(1); }).begin()).has_value();
+
+            try {
+                co_await adder.call([](IAdderService &) -> uint64_t { throw std::runtime_error("remote failure"); }).begin();
+            } catch(std::runtime_error const &) {
+                exceptionPassedBack = true;
+            }
+
+            dm.getCommunicationChannel()->broadcastEvent<QuitEvent>(dm, uint64_t{0});
+            dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        t1.join();
+        t2.join();
+
+        REQUIRE(totals == std::vector<uint64_t>{1, 3, 6, 6});
+        REQUIRE(resetRan);
+        REQUIRE(serviceThreadId == owningThreadId);
+        REQUIRE(resumedThreadId == callingThreadId);
+        REQUIRE_FALSE(missingServiceResult);
+        REQUIRE(exceptionPassedBack);
+
+        channel.removeManager(&callingDm);
+        channel.removeManager(&owningDm);
+    }
+
+    SECTION("DependencyManager", "Remote service calls dropped by the owning manager") {
+        CommunicationChannel channel{};
+        auto callingQueue = std::make_unique<MultimapQueue>();
+        auto &callingDm = callingQueue->createManager();
+        // never started, so it destroys the call without running it
+        auto owningQueue = std::make_unique<MultimapQueue>();
+        auto &owningDm = owningQueue->createManager();
+        channel.addManager(&callingDm);
+        channel.addManager(&owningDm);
+        std::atomic<bool> resumed{};
+        bool droppedResult{true};
+
+        std::thread t([&]() {
+            callingDm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            callingDm.createServiceManager<UselessService>();
+            callingQueue->start(CaptureSigInt);
+        });
+
+        callingDm.runForOrQueueEmpty();
+
+        callingDm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &dm) -> AsyncGenerator<void> {
+            RemoteService<IAdderService> adder{dm, owningDm.getId()};
+            droppedResult = (*co_await adder.call([](IAdderService &svc) { return svc.add(1); }).begin()).has_value();
+            resumed = true;
+            dm.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        while(owningQueue->empty()) {
+            std::this_thread::sleep_for(1ms);
+        }
+        REQUIRE_FALSE(resumed);
+
+        channel.removeManager(&owningDm);
+        owningQueue.reset();
+
+        t.join();
+
+        REQUIRE(resumed);
+        REQUIRE_FALSE(droppedResult);
+
+        channel.removeManager(&callingDm);
+    }
 }
\ No newline at end of file
@@ -2,9 +2,21 @@
 #include "TestEvents.h"
 #include "TestServices/UselessService.h"
 #include <ichor/event_queues/MultimapQueue.h>
+#include <ichor/event_queues/PriorityBandQueue.h>
+#include <ichor/event_queues/InlineEventQueue.h>
+#include <ichor/event_queues/EpollQueue.h>
+#include <ichor/events/RunFunctionEvent.h>
 #ifdef ICHOR_USE_SDEVENT
 #include <ichor/event_queues/SdeventQueue.h>
 #endif
+#ifdef ICHOR_USE_LIBURING
+#include <ichor/event_queues/IoUringQueue.h>
+#include <arpa/inet.h>
+#endif
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 TEST_CASE("QueueTests") {
 
@@ -30,6 +42,759 @@ TEST_CASE("QueueTests") {
         REQUIRE(queue->shouldQuit());
     }
 
+    SECTION("MultimapQueue batching") {
+        REQUIRE_THROWS(std::make_unique<MultimapQueue>(0));
+
+        for(bool onlyHighestPriority : {false, true}) {
+            auto queue = std::make_unique<MultimapQueue>(4, onlyHighestPriority);
+            auto &dm = queue->createManager();
+            std::vector<uint64_t> order{};
+
+            std::thread t([&]() {
+                dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+                dm.createServiceManager<UselessService>();
+                dm.pushPrioritisedEvent<RunFunctionEvent>(0, 2000, [&order](DependencyManager &mng) -> AsyncGenerator<void> {
+                    order.push_back(1);
+                    // has to preempt the rest of the batch
+                    mng.pushPrioritisedEvent<RunFunctionEvent>(0, 1500, [&order](DependencyManager &) -> AsyncGenerator<void> {
+                        order.push_back(2);
+                        co_return;
+                    });
+                    // has to run after the rest of the batch
+                    mng.pushPrioritisedEvent<RunFunctionEvent>(0, 2000, [&order](DependencyManager &) -> AsyncGenerator<void> {
+                        order.push_back(6);
+                        co_return;
+                    });
+                    co_return;
+                });
+                for(uint64_t i = 3; i < 6; i++) {
+                    dm.pushPrioritisedEvent<RunFunctionEvent>(0, 2000, [&order, i](DependencyManager &) -> AsyncGenerator<void> {
+                        order.push_back(i);
+                        co_return;
+                    });
+                }
+                dm.pushPrioritisedEvent<QuitEvent>(0, 3000);
+                queue->start(CaptureSigInt);
+            });
+
+            t.join();
+
+            REQUIRE(order == std::vector<uint64_t>{1, 2, 3, 4, 5, 6});
+        }
+    }
+
+    SECTION("PriorityBandQueue") {
+        auto queue = std::make_unique<PriorityBandQueue>();
+        auto &dm = queue->createManager();
+
+        REQUIRE_THROWS(queue->pushEvent(0, nullptr));
+
+        REQUIRE(queue->empty());
+        REQUIRE(queue->size() == 0);
+        REQUIRE(!queue->shouldQuit());
+
+        REQUIRE_NOTHROW(queue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)));
+
+        REQUIRE(!queue->empty());
+        REQUIRE(queue->size() == 1);
+
+        queue->quit();
+
+        REQUIRE(!queue->empty());
+        REQUIRE(queue->size() == 1);
+        REQUIRE(queue->shouldQuit());
+
+        REQUIRE_THROWS(std::make_unique<PriorityBandQueue>(std::vector<uint64_t>{100, 10}));
+    }
+
+    SECTION("Queue ordering") {
+        auto runQueue = []<typename QueueT>(std::unique_ptr<QueueT> queue) {
+            DependencyManager &dm = queue->createManager();
+            std::vector<uint64_t> order{};
+
+            std::thread t([&]() {
+                dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+                dm.createServiceManager<UselessService>();
+                for(uint64_t prio : {1000, 10, 1000, 100, 5000, 10}) {
+                    dm.pushPrioritisedEvent<RunFunctionEvent>(0, prio, [&order, prio](DependencyManager &) -> AsyncGenerator<void> {
+                        order.push_back(prio);
+                        co_return;
+                    });
+                }
+                dm.pushPrioritisedEvent<QuitEvent>(0, 6000);
+                queue->start(CaptureSigInt);
+            });
+
+            t.join();
+
+            REQUIRE(order == std::vector<uint64_t>{10, 10, 100, 1000, 1000, 5000});
+        };
+
+        runQueue(std::make_unique<MultimapQueue>());
+        runQueue(std::make_unique<PriorityBandQueue>());
+    }
+
+    SECTION("Queue multiple producers") {
+        auto runQueue = []<typename QueueT>(std::unique_ptr<QueueT> queue) {
+            DependencyManager &dm = queue->createManager();
+            constexpr uint64_t producers = 4;
+            constexpr uint64_t eventsPerProducer = 2'000;
+            std::array<std::vector<uint64_t>, producers> received{};
+
+            std::thread t([&]() {
+                dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+                dm.createServiceManager<UselessService>();
+                queue->start(CaptureSigInt);
+            });
+
+            waitForRunning(dm);
+
+            std::array<std::thread, producers> producerThreads{};
+            for(uint64_t i = 0; i < producers; i++) {
+                producerThreads[i] = std::thread([&dm, &received, i]() {
+                    for(uint64_t j = 0; j < eventsPerProducer; j++) {
+                        dm.pushEvent<RunFunctionEvent>(0, [&received, i, j](DependencyManager &) -> AsyncGenerator<void> {
+                            received[i].push_back(j);
+                            co_return;
+                        });
+                    }
+                });
+            }
+
+            for(auto &producer : producerThreads) {
+                producer.join();
+            }
+
+            dm.pushPrioritisedEvent<QuitEvent>(0, INTERNAL_EVENT_PRIORITY + 1);
+
+            t.join();
+
+            for(auto &r : received) {
+                REQUIRE(r.size() == eventsPerProducer);
+                REQUIRE(std::is_sorted(r.begin(), r.end()));
+            }
+        };
+
+        runQueue(std::make_unique<MultimapQueue>());
+        runQueue(std::make_unique<PriorityBandQueue>());
+    }
+
+    SECTION("InlineEventQueue") {
+        auto queue = std::make_unique<InlineEventQueue>();
+        auto &dm = queue->createManager();
+
+        REQUIRE_THROWS(queue->pushEvent(0, nullptr));
+        REQUIRE_THROWS(queue->pushInlineEvent(0, EventStackUniquePtr{}));
+        REQUIRE_THROWS(std::make_unique<InlineEventQueue>(0));
+
+        REQUIRE(queue->empty());
+        REQUIRE(queue->size() == 0);
+        REQUIRE(!queue->shouldQuit());
+
+        REQUIRE_NOTHROW(queue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)));
+        REQUIRE_NOTHROW(queue->pushInlineEvent(10, EventStackUniquePtr::create<TestEvent>(0, 0, 10)));
+        REQUIRE(dm.getEventAllocator().allocations() == 0);
+
+        REQUIRE(!queue->empty());
+        REQUIRE(queue->size() == 2);
+
+        queue->quit();
+
+        REQUIRE(queue->size() == 2);
+        REQUIRE(queue->shouldQuit());
+    }
+
+    SECTION("InlineEventQueue ordering") {
+        // a single slot per chunk forces a new chunk for every event in flight
+        auto queue = std::make_unique<InlineEventQueue>(1);
+        auto &dm = queue->createManager();
+        std::vector<uint64_t> order{};
+        uint64_t allocations{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            for(uint64_t prio : {1000, 10, 1000, 100, 5000, 10}) {
+                dm.pushPrioritisedEvent<RunFunctionEvent>(0, prio, [&order, prio](DependencyManager &) -> AsyncGenerator<void> {
+                    order.push_back(prio);
+                    co_return;
+                });
+            }
+            dm.pushPrioritisedEvent<QuitEvent>(0, 6000);
+            // only the RunFunctionEvents do not fit inline
+            allocations = dm.getEventAllocator().allocations();
+            queue->start(CaptureSigInt);
+        });
+
+        t.join();
+
+        REQUIRE(allocations == 6);
+        REQUIRE(order == std::vector<uint64_t>{10, 10, 100, 1000, 1000, 5000});
+    }
+
+    SECTION("Queue capacity") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+
+        REQUIRE_THROWS(queue->setCapacity(EventQueueCapacity{.highWaterMark = 10, .lowWaterMark = 10}));
+
+        queue->setCapacity(EventQueueCapacity{.maxEventsPerPriority = {{10, 2}}, .whenFull = QueueFullBehaviour::FAIL});
+
+        REQUIRE(queue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)) == PushResult::QUEUED);
+        REQUIRE(queue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)) == PushResult::QUEUED);
+        REQUIRE(queue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)) == PushResult::QUEUE_FULL);
+        REQUIRE(queue->pushEvent(20, std::make_unique<TestEvent>(0, 0, 20)) == PushResult::QUEUED);
+        REQUIRE(queue->pushEvent(10, std::make_unique<QuitEvent>(0, 0, 10)) == PushResult::QUEUED);
+        REQUIRE(!dm.tryPushPrioritisedEvent<TestEvent>(0, 10).has_value());
+        REQUIRE(dm.tryPushPrioritisedEvent<TestEvent>(0, 20).has_value());
+        REQUIRE(dm.getDroppedEventCount() == 0);
+        REQUIRE_NOTHROW(dm.pushPrioritisedEvent<TestEvent>(0, 10));
+        REQUIRE(dm.getDroppedEventCount() == 1);
+        // events of the framework itself are never limited
+        REQUIRE(queue->pushEvent(10, std::make_unique<DoWorkEvent>(0, 0, 10)) == PushResult::QUEUED);
+        REQUIRE(queue->size() == 6);
+
+        // queued events reserved capacity with the current limits
+        REQUIRE_THROWS(queue->setCapacity(EventQueueCapacity{.maxEventsPerPriority = {{10, 1}}}));
+
+        auto policyQueue = std::make_unique<MultimapQueue>();
+        policyQueue->createManager();
+        uint64_t overflowCalls{};
+        policyQueue->setCapacity(EventQueueCapacity{.maxEventsPerPriority = {{10, 1}}, .whenFull = QueueFullBehaviour::FAIL, .overflowPolicy = [&overflowCalls](Event const &evt) {
+            overflowCalls++;
+            return evt.type == TestEvent::TYPE ? QueueFullBehaviour::INSERT : QueueFullBehaviour::FAIL;
+        }});
+
+        REQUIRE(policyQueue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)) == PushResult::QUEUED);
+        REQUIRE(policyQueue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)) == PushResult::QUEUED);
+        REQUIRE(policyQueue->pushEvent(10, std::make_unique<ValueEvent>(0, 0, 10, 1)) == PushResult::QUEUE_FULL);
+        REQUIRE(overflowCalls == 2);
+    }
+
+    SECTION("Queue capacity never fails the event loop") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        uint64_t received{};
+        queue->setCapacity(EventQueueCapacity{.maxEventsPerPriority = {{2000, 1}, {INTERNAL_EVENT_PRIORITY, 1}}, .whenFull = QueueFullBehaviour::FAIL});
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            dm.pushPrioritisedEvent<RunFunctionEvent>(0, 2000, [&received](DependencyManager &mng) -> AsyncGenerator<void> {
+                // pushed by the thread running the event loop, over the limit
+                for(uint64_t i = 0; i < 3; i++) {
+                    mng.pushPrioritisedEvent<RunFunctionEvent>(0, 2000, [&received](DependencyManager &innerMng) -> AsyncGenerator<void> {
+                        received++;
+                        if(received == 3) {
+                            innerMng.pushPrioritisedEvent<QuitEvent>(0, 3000);
+                        }
+                        co_return;
+                    });
+                }
+                co_return;
+            });
+            queue->start(CaptureSigInt);
+        });
+
+        t.join();
+
+        REQUIRE(received == 3);
+    }
+
+    SECTION("Queue water marks") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        std::vector<bool> aboveHighWaterMark{};
+        bool aboveHighWaterMarkBeforeStart{};
+        queue->setCapacity(EventQueueCapacity{.highWaterMark = 4, .lowWaterMark = 1});
+
+        std::thread t([&]() {
+            for(uint64_t i = 0; i < 5; i++) {
+                dm.pushPrioritisedEvent<RunFunctionEvent>(0, 2000, [&aboveHighWaterMark](DependencyManager &mng) -> AsyncGenerator<void> {
+                    aboveHighWaterMark.push_back(mng.getEventQueue().isAboveHighWaterMark());
+                    co_return;
+                });
+            }
+            aboveHighWaterMarkBeforeStart = queue->isAboveHighWaterMark();
+            // the events of these services all have a higher priority than the functions and get processed first
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            dm.pushPrioritisedEvent<QuitEvent>(0, 3000);
+            queue->start(CaptureSigInt);
+        });
+
+        t.join();
+
+        REQUIRE(aboveHighWaterMarkBeforeStart);
+        REQUIRE(aboveHighWaterMark == std::vector<bool>{true, true, true, false, false});
+    }
+
+    SECTION("Queue capacity blocks producers") {
+        auto queue = std::make_unique<PriorityBandQueue>();
+        auto &dm = queue->createManager();
+        constexpr uint64_t limit = 10;
+        constexpr uint64_t events = 1'000;
+        uint64_t received{};
+        uint64_t maxSize{};
+        queue->setCapacity(EventQueueCapacity{.maxEventsPerPriority = {{2000, limit}}, .whenFull = QueueFullBehaviour::BLOCK});
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        std::thread producer([&]() {
+            for(uint64_t i = 0; i < events; i++) {
+                dm.pushPrioritisedEvent<RunFunctionEvent>(0, 2000, [&](DependencyManager &mng) -> AsyncGenerator<void> {
+                    received++;
+                    maxSize = std::max(maxSize, mng.getEventQueue().size());
+                    // quit from the last event, a quit event pushed by the test could be counted alongside a full queue
+                    if(received == events) {
+                        mng.pushPrioritisedEvent<QuitEvent>(0, 3000);
+                    }
+                    co_return;
+                });
+            }
+        });
+
+        producer.join();
+        t.join();
+
+        REQUIRE(received == events);
+        REQUIRE(maxSize <= limit);
+    }
+
+    SECTION("TimerWheel") {
+        auto const origin = std::chrono::steady_clock::now();
+        Detail::TimerWheel wheel{origin};
+        std::vector<uint64_t> expired{};
+        auto expire = [&expired](uint64_t, std::unique_ptr<Event, EventDeleter> &&evt) {
+            expired.push_back(evt->id);
+        };
+
+        REQUIRE(wheel.empty());
+        REQUIRE(!wheel.nextDeadline());
+
+        // 1 and 2 share a tick, 3 to 5 start out on the higher levels and 6 lies beyond the span of the wheel
+        wheel.insert(origin + 5ms, 0, std::make_unique<TestEvent>(1, 0, 0));
+        wheel.insert(origin + 4500us, 0, std::make_unique<TestEvent>(2, 0, 0));
+        wheel.insert(origin + 70ms, 0, std::make_unique<TestEvent>(3, 0, 0));
+        wheel.insert(origin + 5s, 0, std::make_unique<TestEvent>(4, 0, 0));
+        wheel.insert(origin + 300s, 0, std::make_unique<TestEvent>(5, 0, 0));
+        wheel.insert(origin + 20'000s, 0, std::make_unique<TestEvent>(6, 0, 0));
+        wheel.insert(origin, 0, std::make_unique<TestEvent>(7, 0, 0));
+
+        REQUIRE(wheel.size() == 7);
+        REQUIRE(wheel.nextDeadline() == origin);
+        REQUIRE(wheel.advance(origin, expire) == 1);
+        REQUIRE(expired == std::vector<uint64_t>{7});
+
+        REQUIRE(wheel.nextDeadline() == origin + 5ms);
+        REQUIRE(wheel.advance(origin + 4ms, expire) == 0);
+        REQUIRE(wheel.advance(origin + 5ms, expire) == 2);
+        REQUIRE(expired == std::vector<uint64_t>{7, 1, 2});
+
+        // 3 cascades down to level 0 first
+        REQUIRE(wheel.nextDeadline() == origin + 64ms);
+        REQUIRE(wheel.advance(origin + 69ms, expire) == 0);
+        REQUIRE(wheel.advance(origin + 70ms, expire) == 1);
+        REQUIRE(wheel.advance(origin + 4999ms, expire) == 0);
+        REQUIRE(wheel.advance(origin + 5s, expire) == 1);
+        REQUIRE(wheel.advance(origin + 300s - 1ms, expire) == 0);
+        REQUIRE(wheel.advance(origin + 300s, expire) == 1);
+        REQUIRE(wheel.advance(origin + 20'000s - 1ms, expire) == 0);
+        REQUIRE(wheel.advance(origin + 20'000s, expire) == 1);
+        REQUIRE(expired == std::vector<uint64_t>{7, 1, 2, 3, 4, 5, 6});
+
+        REQUIRE(wheel.empty());
+        REQUIRE(!wheel.nextDeadline());
+
+        wheel.insert(origin + 20'001s, 0, std::make_unique<TestEvent>(8, 0, 0));
+        wheel.clear();
+        REQUIRE(wheel.empty());
+    }
+
+    SECTION("Delayed events") {
+        auto runQueue = []<typename QueueT>(std::unique_ptr<QueueT> queue) {
+            DependencyManager &dm = queue->createManager();
+            std::vector<uint64_t> order{};
+            std::chrono::steady_clock::time_point pushed{};
+            std::chrono::steady_clock::time_point fired{};
+
+            std::thread t([&]() {
+                dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+                dm.createServiceManager<UselessService>();
+                queue->start(CaptureSigInt);
+            });
+
+            waitForRunning(dm);
+
+            pushed = std::chrono::steady_clock::now();
+            // pushed in reverse order of their deadline, from another thread than the one running the loop
+            for(uint64_t delay : {30, 20, 10}) {
+                dm.pushEventAfter<RunFunctionEvent>(0, INTERNAL_EVENT_PRIORITY, std::chrono::milliseconds(delay), [&order, &fired, delay](DependencyManager &mng) -> AsyncGenerator<void> {
+                    order.push_back(delay);
+                    if(order.size() == 3) {
+                        fired = std::chrono::steady_clock::now();
+                        mng.pushEvent<QuitEvent>(0);
+                    }
+                    co_return;
+                });
+            }
+
+            t.join();
+
+            REQUIRE(order == std::vector<uint64_t>{10, 20, 30});
+            REQUIRE(fired - pushed >= 30ms);
+        };
+
+        runQueue(std::make_unique<MultimapQueue>());
+        runQueue(std::make_unique<PriorityBandQueue>());
+        runQueue(std::make_unique<InlineEventQueue>());
+#ifdef __linux__
+        runQueue(std::make_unique<EpollQueue>());
+#endif
+#ifdef ICHOR_USE_LIBURING
+        runQueue(std::make_unique<IoUringQueue>());
+#endif
+    }
+
+#ifdef __linux__
+    SECTION("EpollQueue") {
+        REQUIRE_THROWS(std::make_unique<EpollQueue>(0));
+
+        auto queue = std::make_unique<EpollQueue>();
+        auto &dm = queue->createManager();
+
+        REQUIRE_THROWS(queue->pushEvent(0, nullptr));
+        REQUIRE(queue->supportsFds());
+
+        REQUIRE(queue->empty());
+        REQUIRE(queue->size() == 0);
+        REQUIRE(!queue->shouldQuit());
+
+        REQUIRE_NOTHROW(queue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)));
+
+        REQUIRE(!queue->empty());
+        REQUIRE(queue->size() == 1);
+
+        queue->quit();
+
+        REQUIRE(queue->shouldQuit());
+    }
+
+    SECTION("EpollQueue multiple producers") {
+        auto queue = std::make_unique<EpollQueue>();
+        auto &dm = queue->createManager();
+        constexpr uint64_t producers = 4;
+        constexpr uint64_t eventsPerProducer = 2'000;
+        std::array<std::vector<uint64_t>, producers> received{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        std::array<std::thread, producers> producerThreads{};
+        for(uint64_t i = 0; i < producers; i++) {
+            producerThreads[i] = std::thread([&dm, &received, i]() {
+                for(uint64_t j = 0; j < eventsPerProducer; j++) {
+                    dm.pushEvent<RunFunctionEvent>(0, [&received, i, j](DependencyManager &) -> AsyncGenerator<void> {
+                        received[i].push_back(j);
+                        co_return;
+                    });
+                    if(j % 500 == 0) {
+                        // let the event loop go back to sleep, so that pushing has to wake it up
+                        std::this_thread::sleep_for(1ms);
+                    }
+                }
+            });
+        }
+
+        for(auto &producer : producerThreads) {
+            producer.join();
+        }
+
+        dm.pushPrioritisedEvent<QuitEvent>(0, INTERNAL_EVENT_PRIORITY + 1);
+
+        t.join();
+
+        for(auto &r : received) {
+            REQUIRE(r.size() == eventsPerProducer);
+            REQUIRE(std::is_sorted(r.begin(), r.end()));
+        }
+    }
+
+    SECTION("EpollQueue file descriptors") {
+        auto queue = std::make_unique<EpollQueue>();
+        auto &dm = queue->createManager();
+        std::array<int, 2> fds{};
+        REQUIRE(::pipe2(fds.data(), O_NONBLOCK) == 0);
+        std::string received{};
+        std::thread::id loopThread{};
+        std::thread::id readyThread{};
+        bool sawHangup{};
+        bool threwWithoutCallback{};
+        uint64_t watchId{};
+
+        std::thread t([&]() {
+            loopThread = std::this_thread::get_id();
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        // watches are added from the thread running the event loop
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &) -> AsyncGenerator<void> {
+            try {
+                queue->addFd(fds[0], FdInterest::READ, {});
+            } catch(std::runtime_error const &) {
+                threwWithoutCallback = true;
+            }
+
+            watchId = queue->addFd(fds[0], FdInterest::READ, [&, readFd = fds[0]](FdReadiness readiness) {
+                readyThread = std::this_thread::get_id();
+                std::array<char, 16> buf{};
+                ssize_t n;
+                while((n = ::read(readFd, buf.data(), buf.size())) > 0) {
+                    received.append(buf.data(), static_cast<uint64_t>(n));
+                }
+
+                if(n == 0 || readiness.hangup) {
+                    sawHangup = true;
+                    // removing the watch from within its own callback
+                    queue->removeFd(watchId);
+                    dm.pushEvent<QuitEvent>(0);
+                }
+            });
+            co_return;
+        });
+
+        // the loop sleeps in epoll_wait and is woken by the pipe
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(::write(fds[1], "hello ", 6) == 6);
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(::write(fds[1], "world", 5) == 5);
+        ::close(fds[1]);
+
+        t.join();
+        ::close(fds[0]);
+
+        REQUIRE(threwWithoutCallback);
+        REQUIRE(received == "hello world");
+        REQUIRE(sawHangup);
+        REQUIRE(readyThread == loopThread);
+    }
+#endif
+
+#ifdef ICHOR_USE_LIBURING
+    SECTION("IoUringQueue") {
+        REQUIRE_THROWS(std::make_unique<IoUringQueue>(256, 0));
+        REQUIRE_THROWS(std::make_unique<IoUringQueue>(256, 64, 100));
+
+        auto queue = std::make_unique<IoUringQueue>();
+        auto &dm = queue->createManager();
+
+        REQUIRE_THROWS(queue->pushEvent(0, nullptr));
+        REQUIRE(queue->getIoUringQueue() == queue.get());
+
+        REQUIRE(queue->empty());
+        REQUIRE(queue->size() == 0);
+        REQUIRE(!queue->shouldQuit());
+
+        REQUIRE_NOTHROW(queue->pushEvent(10, std::make_unique<TestEvent>(0, 0, 10)));
+
+        REQUIRE(!queue->empty());
+        REQUIRE(queue->size() == 1);
+
+        queue->quit();
+
+        REQUIRE(queue->shouldQuit());
+    }
+
+    SECTION("IoUringQueue multiple producers") {
+        auto queue = std::make_unique<IoUringQueue>();
+        auto &dm = queue->createManager();
+        constexpr uint64_t producers = 4;
+        constexpr uint64_t eventsPerProducer = 2'000;
+        std::array<std::vector<uint64_t>, producers> received{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        std::array<std::thread, producers> producerThreads{};
+        for(uint64_t i = 0; i < producers; i++) {
+            producerThreads[i] = std::thread([&dm, &received, i]() {
+                for(uint64_t j = 0; j < eventsPerProducer; j++) {
+                    dm.pushEvent<RunFunctionEvent>(0, [&received, i, j](DependencyManager &) -> AsyncGenerator<void> {
+                        received[i].push_back(j);
+                        co_return;
+                    });
+                    if(j % 500 == 0) {
+                        // let the event loop go back to sleep, so that pushing has to wake it up
+                        std::this_thread::sleep_for(1ms);
+                    }
+                }
+            });
+        }
+
+        for(auto &producer : producerThreads) {
+            producer.join();
+        }
+
+        dm.pushPrioritisedEvent<QuitEvent>(0, INTERNAL_EVENT_PRIORITY + 1);
+
+        t.join();
+
+        for(auto &r : received) {
+            REQUIRE(r.size() == eventsPerProducer);
+            REQUIRE(std::is_sorted(r.begin(), r.end()));
+        }
+    }
+
+    SECTION("IoUringQueue awaitable operations") {
+        auto queue = std::make_unique<IoUringQueue>();
+        auto &dm = queue->createManager();
+        std::array<int, 2> fds{};
+        REQUIRE(::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds.data()) == 0);
+        std::string received{};
+        int32_t sent{};
+        int32_t timedOut{};
+        std::thread::id loopThread{};
+        std::thread::id resumedThread{};
+
+        std::thread t([&]() {
+            loopThread = std::this_thread::get_id();
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &mng) -> AsyncGenerator<void> {
+            std::array<uint8_t, 16> buf{};
+            // nothing has been written yet, suspends until the test writes
+            auto const res = *co_await queue->recv(fds[0], buf).begin();
+            resumedThread = std::this_thread::get_id();
+            received.assign(reinterpret_cast<char const *>(buf.data()), static_cast<uint64_t>(std::max(res, 0)));
+
+            std::string_view const reply = "pong";
+            sent = *co_await queue->send(fds[0], std::span<uint8_t const>{reinterpret_cast<uint8_t const *>(reply.data()), reply.size()}).begin();
+            timedOut = *co_await queue->timeout(1ms).begin();
+
+            mng.pushEvent<QuitEvent>(0);
+            co_return;
+        });
+
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(::write(fds[1], "ping", 4) == 4);
+
+        t.join();
+
+        std::array<char, 16> reply{};
+        REQUIRE(::read(fds[1], reply.data(), reply.size()) == 4);
+        ::close(fds[0]);
+        ::close(fds[1]);
+
+        REQUIRE(received == "ping");
+        REQUIRE(resumedThread == loopThread);
+        REQUIRE(sent == 4);
+        REQUIRE(std::string_view{reply.data()} == "pong");
+        REQUIRE(timedOut == -ETIME);
+    }
+
+    SECTION("IoUringQueue multishot operations") {
+        // two small receive buffers, so that they have to be reused and the receive re-armed when they run out
+        auto queue = std::make_unique<IoUringQueue>(256, 64, 2, 4);
+        auto &dm = queue->createManager();
+        int listenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        REQUIRE(listenFd >= 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLen = sizeof(address);
+        REQUIRE(::bind(listenFd, (sockaddr *)&address, sizeof(address)) == 0);
+        REQUIRE(::listen(listenFd, 10) == 0);
+        REQUIRE(::getsockname(listenFd, (sockaddr *)&address, &addressLen) == 0);
+        std::vector<int32_t> accepted{};
+        std::string received{};
+        bool unexpectedRecv{};
+        uint64_t acceptId{};
+        uint64_t recvId{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            dm.createServiceManager<UselessService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager &mng) -> AsyncGenerator<void> {
+            acceptId = queue->multishotAccept(listenFd, [&](int32_t fd) {
+                accepted.push_back(fd);
+                if(accepted.size() != 1) {
+                    return;
+                }
+
+                recvId = queue->multishotRecv(fd, [&](int32_t res, std::span<uint8_t const> data) {
+                    if(res <= 0 || data.size() > 4) {
+                        unexpectedRecv = true;
+                        return;
+                    }
+                    received.append(reinterpret_cast<char const *>(data.data()), data.size());
+                    if(received == "hello world") {
+                        // cancelling from within the callback
+                        queue->cancel(recvId);
+                        queue->cancel(acceptId);
+                        mng.pushEvent<QuitEvent>(0);
+                    }
+                });
+            });
+            co_return;
+        });
+
+        std::array<int, 2> clients{};
+        for(auto &client : clients) {
+            client = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            REQUIRE(::connect(client, (sockaddr *)&address, sizeof(address)) == 0);
+        }
+
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(::send(clients[0], "hello ", 6, 0) == 6);
+        std::this_thread::sleep_for(20ms);
+        REQUIRE(::send(clients[0], "world", 5, 0) == 5);
+
+        t.join();
+
+        REQUIRE(!unexpectedRecv);
+        REQUIRE(received == "hello world");
+        REQUIRE(accepted.size() == 2);
+        for(auto fd : accepted) {
+            REQUIRE(fd >= 0);
+            ::close(fd);
+        }
+        for(auto client : clients) {
+            ::close(client);
+        }
+        ::close(listenFd);
+    }
+#endif
+
 #ifdef ICHOR_USE_SDEVENT
     SECTION("SdeventQueue") {
         auto queue = std::make_unique<SdeventQueue>();
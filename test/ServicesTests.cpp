@@ -5,6 +5,7 @@
 #include "TestServices/MixingInterfacesService.h"
 #include "TestServices/StartStopOnSecondAttemptService.h"
 #include "TestServices/TimerRunsOnceService.h"
+#include "TestServices/ManyTimersService.h"
 #include "TestServices/AddEventHandlerDuringEventHandlingService.h"
 #include <ichor/event_queues/MultimapQueue.h>
 #include <ichor/events/RunFunctionEvent.h>
@@ -208,6 +209,34 @@ TEST_CASE("ServicesTests") {
         t.join();
     }
 
+    SECTION("Many timers share the event loop") {
+        auto queue = std::make_unique<MultimapQueue>();
+        auto &dm = queue->createManager();
+        ManyTimersService *svc{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<CoutFrameworkLogger, IFrameworkLogger>();
+            svc = dm.createServiceManager<ManyTimersService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        // the slowest timers are done after 30 ms
+        std::this_thread::sleep_for(500ms);
+        dm.runForOrQueueEmpty();
+
+        dm.pushEvent<RunFunctionEvent>(0, [&](DependencyManager& mng) -> AsyncGenerator<void> {
+            REQUIRE(svc->count == ManyTimersService::TIMERS * ManyTimersService::FIRES_PER_TIMER);
+
+            mng.pushEvent<QuitEvent>(svc->getServiceId());
+
+            co_return;
+        });
+
+        t.join();
+    }
+
     SECTION("Add event handler during event handling") {
         auto queue = std::make_unique<MultimapQueue>();
         auto &dm = queue->createManager();
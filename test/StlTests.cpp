@@ -1,6 +1,11 @@
 #include "Common.h"
 #include <ichor/stl/RealtimeMutex.h>
 #include <ichor/stl/RealtimeReadWriteMutex.h>
+#include <ichor/stl/CopyOnWriteVector.h>
+#include <ichor/stl/SlotMap.h>
+#include <ichor/stl/BufferPool.h>
+#include <ichor/stl/MpscQueue.h>
+#include <ichor/services/network/NetworkEvents.h>
 #include "TestServices/UselessService.h"
 
 using namespace Ichor;
@@ -106,6 +111,146 @@ TEST_CASE("STL Tests") {
         m.unlock_shared();
     }
 
+    SECTION("CopyOnWriteVector basics") {
+        CopyOnWriteVector<uint64_t> v;
+        REQUIRE(v.empty());
+
+        v.emplace_back(1u);
+        v.emplace_back(2u);
+        REQUIRE(v.size() == 2);
+
+        auto const *elementsBefore = v.snapshot().get();
+        v.emplace_back(3u);
+        // no live snapshot, modified in place
+        REQUIRE(v.snapshot().get() == elementsBefore);
+
+        auto snapshot = v.snapshot();
+        v.emplace_back(4u);
+        REQUIRE(v.erase_if([](uint64_t i) { return i == 1; }) == 1);
+        REQUIRE(v.erase_if([](uint64_t i) { return i == 1; }) == 0);
+
+        REQUIRE(*snapshot == std::vector<uint64_t>{1, 2, 3});
+        REQUIRE(*v.snapshot() == std::vector<uint64_t>{2, 3, 4});
+    }
+
+    SECTION("SlotMap basics") {
+        SlotMap<uint64_t> map;
+        REQUIRE(map.empty());
+        REQUIRE(map.find(SlotMap<uint64_t>::INVALID_HANDLE) == nullptr);
+
+        auto const one = map.insert(1u);
+        auto const two = map.insert(2u);
+        auto const three = map.insert(3u);
+        REQUIRE(map.size() == 3);
+        REQUIRE(*map.find(two) == 2);
+
+        REQUIRE(map.erase(one));
+        REQUIRE_FALSE(map.erase(one));
+        REQUIRE(map.find(one) == nullptr);
+        REQUIRE(*map.find(two) == 2);
+        REQUIRE(*map.find(three) == 3);
+
+        // reuses the slot of one, but with a new generation
+        auto const four = map.insert(4u);
+        REQUIRE(four != one);
+        REQUIRE(map.find(one) == nullptr);
+        REQUIRE(*map.find(four) == 4);
+
+        uint64_t sum{};
+        for(auto i : map) {
+            sum += i;
+        }
+        REQUIRE(sum == 9);
+
+        map.clear();
+        REQUIRE(map.empty());
+        REQUIRE(map.find(two) == nullptr);
+    }
+
+    SECTION("BufferPool basics") {
+        auto pool = BufferPool::create(64, 1);
+        BufferSlice slice;
+        {
+            auto buf = pool->acquire();
+            REQUIRE(buf.capacity() == 64);
+            for(uint8_t i = 0; i < 8; i++) {
+                buf.data()[i] = i;
+            }
+            slice = buf.slice(2, 4);
+            REQUIRE(buf.slice(60, 10).size() == 4);
+        }
+        REQUIRE(pool->allocatedBuffers() == 1);
+
+        // the slice keeps the buffer out of the pool
+        REQUIRE(slice.size() == 4);
+        REQUIRE(slice.data()[0] == 2);
+        auto sub = slice.subSlice(1, 10);
+        REQUIRE(sub.size() == 3);
+        REQUIRE(sub.data()[0] == 3);
+        auto other = pool->acquire();
+        REQUIRE(pool->allocatedBuffers() == 2);
+
+        // returned buffers get reused, buffers beyond maxFreeBuffers are freed
+        slice.reset();
+        sub.reset();
+        other.reset();
+        REQUIRE(slice.empty());
+        auto reused = pool->acquire();
+        REQUIRE(pool->allocatedBuffers() == 2);
+
+        // outstanding buffers keep the pool alive
+        auto kept = reused.slice(0, 1);
+        reused.reset();
+        pool.reset();
+        REQUIRE(kept.size() == 1);
+    }
+
+    SECTION("MpscQueue reuses popped nodes") {
+        MpscQueue<uint64_t> queue{};
+        uint64_t out{};
+        for(uint64_t i = 0; i < 10'000; i++) {
+            queue.push(uint64_t{i});
+            REQUIRE(queue.pop(out));
+            REQUIRE(out == i);
+        }
+        // the node of the first pop is the one the queue starts with and can't be reused, the second node keeps getting reused after that
+        REQUIRE(queue.allocatedNodes() == 2);
+
+        // a burst allocates nodes, those fitting in the cache are reused afterwards
+        constexpr uint64_t burst = MpscQueue<uint64_t>::CACHED_NODES * 2;
+        for(uint64_t round = 0; round < 3; round++) {
+            for(uint64_t i = 0; i < burst; i++) {
+                queue.push(uint64_t{i});
+            }
+            for(uint64_t i = 0; i < burst; i++) {
+                REQUIRE(queue.pop(out));
+                REQUIRE(out == i);
+            }
+            REQUIRE(queue.empty());
+        }
+        // the first round reuses the node cached above, every later round only allocates the nodes that did not fit in the cache
+        REQUIRE(queue.allocatedNodes() == 2 + (burst - 1) + 2 * (burst - MpscQueue<uint64_t>::CACHED_NODES));
+    }
+
+    SECTION("NetworkDataEvent from a pooled buffer") {
+        auto pool = BufferPool::create(64, 1);
+        auto buf = pool->acquire();
+        for(uint8_t i = 0; i < 4; i++) {
+            buf.data()[i] = i;
+        }
+        NetworkDataEvent evt{1, 0, 1000, buf.slice(0, 4)};
+
+        // copying the bytes out leaves the slice for other handlers
+        REQUIRE(evt.getData() == std::vector<uint8_t>{0, 1, 2, 3});
+        REQUIRE(evt.getSlice().size() == 4);
+        REQUIRE(evt.getBytes().size() == 4);
+        REQUIRE(&evt.getData() == &evt.getData());
+
+        REQUIRE(evt.moveData() == std::vector<uint8_t>{0, 1, 2, 3});
+        REQUIRE(evt.getSlice().size() == 4);
+        REQUIRE_THROWS(evt.getData());
+    }
+
     SECTION("typeName tests") {
         REQUIRE(typeName<UselessService>() == typeName<Ichor::UselessService>());
         REQUIRE(typeNameHash<UselessService>() == typeNameHash<Ichor::UselessService>());
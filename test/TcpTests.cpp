@@ -0,0 +1,319 @@
+#ifdef __linux__
+
+#include <ichor/event_queues/EpollQueue.h>
+#include <ichor/services/logging/LoggerAdmin.h>
+#include <ichor/services/logging/NullLogger.h>
+#include <ichor/services/network/tcp/TcpHostService.h>
+#include "Common.h"
+#include "TestServices/TcpEchoService.h"
+#include <arpa/inet.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <numeric>
+
+using namespace Ichor;
+using namespace std::string_literals;
+
+// blocking loopback client, retries until the host is listening
+int connectClient(uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+    for(int attempt = 0; attempt < 1'000; attempt++) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if(::connect(fd, (sockaddr *)&address, sizeof(address)) == 0) {
+            int setting = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &setting, sizeof(setting));
+            return fd;
+        }
+        ::close(fd);
+        std::this_thread::sleep_for(1ms);
+    }
+
+    return -1;
+}
+
+bool sendAll(int fd, std::vector<uint8_t> const &data) {
+    uint64_t sent{};
+    while(sent < data.size()) {
+        auto ret = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if(ret <= 0) {
+            return false;
+        }
+        sent += static_cast<uint64_t>(ret);
+    }
+    return true;
+}
+
+bool receiveAll(int fd, std::vector<uint8_t> &data) {
+    uint64_t received{};
+    while(received < data.size()) {
+        auto ret = ::recv(fd, data.data() + received, data.size() - received, 0);
+        if(ret <= 0) {
+            return false;
+        }
+        received += static_cast<uint64_t>(ret);
+    }
+    return true;
+}
+
+TEST_CASE("TcpTests") {
+    auto queue = std::make_unique<EpollQueue>();
+    auto &dm = queue->createManager();
+
+    SECTION("Round trip latency") {
+        constexpr uint16_t port = 8010;
+        constexpr uint64_t roundTrips = 200;
+
+        std::thread t([&]() {
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<TcpHostService, IHostService>(Properties{{"Address", Ichor::make_any<std::string>("127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(port)}});
+            dm.createServiceManager<TcpEchoService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        int fd = connectClient(port);
+        REQUIRE(fd >= 0);
+
+        std::vector<uint8_t> msg(64);
+        std::vector<uint8_t> echo(64);
+        uint64_t completed{};
+        auto start = std::chrono::steady_clock::now();
+        for(uint64_t i = 0; i < roundTrips; i++) {
+            std::fill(msg.begin(), msg.end(), static_cast<uint8_t>(i));
+            if(!sendAll(fd, msg) || !receiveAll(fd, echo) || echo != msg) {
+                break;
+            }
+            completed++;
+        }
+        auto end = std::chrono::steady_clock::now();
+        ::close(fd);
+
+        dm.pushEvent<QuitEvent>(0);
+        t.join();
+
+        REQUIRE(completed == roundTrips);
+        // polling the socket every 20 ms would take at least 4 seconds
+        REQUIRE(end - start < 1s);
+    }
+
+    SECTION("Throughput over multiple connections") {
+        constexpr uint16_t port = 8011;
+        constexpr uint64_t connections = 4;
+        constexpr uint64_t chunkSize = 64 * 1024;
+        constexpr uint64_t chunksPerConnection = 16;
+
+        std::thread t([&]() {
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<TcpHostService, IHostService>(Properties{{"Address", Ichor::make_any<std::string>("127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(port)}});
+            dm.createServiceManager<TcpEchoService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        std::vector<uint64_t> echoedBytes(connections);
+        std::vector<std::thread> clients{};
+        auto start = std::chrono::steady_clock::now();
+        for(uint64_t i = 0; i < connections; i++) {
+            clients.emplace_back([&echoedBytes, i]() {
+                int fd = connectClient(port);
+                if(fd < 0) {
+                    return;
+                }
+
+                std::vector<uint8_t> chunk(chunkSize);
+                std::vector<uint8_t> echo(chunkSize);
+                for(uint64_t j = 0; j < chunksPerConnection; j++) {
+                    std::iota(chunk.begin(), chunk.end(), static_cast<uint8_t>(i + j));
+                    if(!sendAll(fd, chunk) || !receiveAll(fd, echo) || echo != chunk) {
+                        break;
+                    }
+                    echoedBytes[i] += chunkSize;
+                }
+                ::close(fd);
+            });
+        }
+
+        for(auto &client : clients) {
+            client.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        dm.pushEvent<QuitEvent>(0);
+        t.join();
+
+        for(auto bytes : echoedBytes) {
+            REQUIRE(bytes == chunkSize * chunksPerConnection);
+        }
+        // a single 1 KiB read every 20 ms would take minutes
+        REQUIRE(end - start < 5s);
+    }
+
+    SECTION("Sending under back pressure") {
+        constexpr uint16_t port = 8012;
+        constexpr uint64_t chunkSize = 64 * 1024;
+        constexpr uint64_t chunks = 128;
+        TcpEchoService *echo{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<TcpHostService, IHostService>(Properties{{"Address", Ichor::make_any<std::string>("127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(port)},
+                                                                             {"BatchSends", Ichor::make_any<bool>(true)}, {"ReportSentMessages", Ichor::make_any<bool>(true)}});
+            echo = dm.createServiceManager<TcpEchoService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        int fd = connectClient(port);
+        REQUIRE(fd >= 0);
+
+        std::thread writer([fd]() {
+            std::vector<uint8_t> chunk(chunkSize);
+            for(uint64_t i = 0; i < chunks; i++) {
+                std::iota(chunk.begin(), chunk.end(), static_cast<uint8_t>(i));
+                if(!sendAll(fd, chunk)) {
+                    break;
+                }
+            }
+        });
+
+        // not reading fills up the send buffer of the connection, so that the echoes have to wait in its outbox
+        std::this_thread::sleep_for(200ms);
+
+        std::vector<uint8_t> received(chunkSize * chunks);
+        bool const receivedAll = receiveAll(fd, received);
+        writer.join();
+        ::close(fd);
+
+        dm.pushEvent<QuitEvent>(0);
+        t.join();
+
+        REQUIRE(receivedAll);
+        std::vector<uint8_t> expected(chunkSize);
+        for(uint64_t i = 0; i < chunks; i++) {
+            std::iota(expected.begin(), expected.end(), static_cast<uint8_t>(i));
+            REQUIRE(std::equal(expected.begin(), expected.end(), received.begin() + static_cast<int64_t>(i * chunkSize)));
+        }
+        REQUIRE(echo->_failedMessages == 0);
+        REQUIRE(echo->_echoedMessages > 0);
+        REQUIRE(echo->_sentMessages == echo->_echoedMessages);
+    }
+
+    SECTION("Listeners sharded over managers") {
+        constexpr uint16_t port = 8013;
+        constexpr uint64_t connections = 32;
+        auto secondQueue = std::make_unique<EpollQueue>();
+        auto &secondDm = secondQueue->createManager();
+        std::array<TcpEchoService*, 2> echoes{};
+
+        auto runShard = [&](IEventQueue &q, DependencyManager &mng, TcpEchoService *&echo) {
+            mng.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            mng.createServiceManager<TcpHostService, IHostService>(Properties{{"Address", Ichor::make_any<std::string>("127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(port)}, {"ReusePort", Ichor::make_any<bool>(true)}});
+            echo = mng.createServiceManager<TcpEchoService>();
+            q.start(CaptureSigInt);
+        };
+        std::thread t1([&]() {
+            runShard(*queue, dm, echoes[0]);
+        });
+        std::thread t2([&]() {
+            runShard(*secondQueue, secondDm, echoes[1]);
+        });
+
+        waitForRunning(dm);
+        waitForRunning(secondDm);
+        // both hosts have to be listening before connecting, or the first one gets all connections
+        std::this_thread::sleep_for(100ms);
+
+        std::vector<int> fds{};
+        uint64_t echoed{};
+        for(uint64_t i = 0; i < connections; i++) {
+            int fd = connectClient(port);
+            if(fd < 0) {
+                break;
+            }
+            fds.push_back(fd);
+
+            std::vector<uint8_t> msg(64, static_cast<uint8_t>(i));
+            std::vector<uint8_t> echo(64);
+            if(sendAll(fd, msg) && receiveAll(fd, echo) && echo == msg) {
+                echoed++;
+            }
+        }
+        for(auto fd : fds) {
+            ::close(fd);
+        }
+
+        dm.pushEvent<QuitEvent>(0);
+        secondDm.pushEvent<QuitEvent>(0);
+        t1.join();
+        t2.join();
+
+        REQUIRE(echoed == connections);
+        REQUIRE(echoes[0]->_connectionsSeen + echoes[1]->_connectionsSeen == connections);
+        // the kernel hashes connections over the listeners, the chance that they all end up at the same one is 2^-31
+        REQUIRE(echoes[0]->_connectionsSeen > 0);
+        REQUIRE(echoes[1]->_connectionsSeen > 0);
+    }
+
+    SECTION("Flooding a connection with small messages") {
+        constexpr uint16_t port = 8014;
+        constexpr uint64_t messageSize = 64;
+        constexpr uint64_t messages = 20'000;
+        constexpr uint32_t maxFreeBuffers = 16;
+        // 64 kB at most, far less than the 1.28 MB sent, so the test fails if buffers are not reused
+        auto pool = BufferPool::create(4 * 1024, maxFreeBuffers);
+        TcpEchoService *echo{};
+
+        std::thread t([&]() {
+            dm.createServiceManager<LoggerAdmin<NullLogger>, ILoggerAdmin>();
+            dm.createServiceManager<TcpHostService, IHostService>(Properties{{"Address", Ichor::make_any<std::string>("127.0.0.1"s)}, {"Port", Ichor::make_any<uint16_t>(port)},
+                                                                             {"CoalesceReads", Ichor::make_any<bool>(true)}, {"BufferPool", Ichor::make_any<std::shared_ptr<BufferPool>>(pool)}});
+            echo = dm.createServiceManager<TcpEchoService>();
+            queue->start(CaptureSigInt);
+        });
+
+        waitForRunning(dm);
+
+        int fd = connectClient(port);
+        REQUIRE(fd >= 0);
+
+        std::vector<uint8_t> received(messageSize * messages);
+        bool receivedAll{};
+
+        std::thread reader([fd, &received, &receivedAll]() {
+            receivedAll = receiveAll(fd, received);
+        });
+
+        std::vector<uint8_t> msg(messageSize);
+        for(uint64_t i = 0; i < messages; i++) {
+            std::fill(msg.begin(), msg.end(), static_cast<uint8_t>(i));
+            if(!sendAll(fd, msg)) {
+                break;
+            }
+        }
+        reader.join();
+        ::close(fd);
+
+        dm.pushEvent<QuitEvent>(0);
+        t.join();
+
+        REQUIRE(receivedAll);
+        bool inOrder = true;
+        for(uint64_t i = 0; i < messages; i++) {
+            inOrder = inOrder && received[i * messageSize] == static_cast<uint8_t>(i);
+        }
+        REQUIRE(inOrder);
+        REQUIRE(echo->_receivedBytes == messageSize * messages);
+        // returned buffers get reused, besides those kept for reuse only the one the connection is receiving into is new
+        REQUIRE(pool->allocatedBuffers() <= maxFreeBuffers + 1);
+    }
+}
+
+#endif
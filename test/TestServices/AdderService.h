@@ -0,0 +1,44 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <thread>
+
+using namespace Ichor;
+
+struct IAdderService {
+    virtual ~IAdderService() = default;
+    virtual uint64_t add(uint64_t value) = 0;
+    virtual void reset() = 0;
+    [[nodiscard]] virtual uint64_t const& total() const noexcept = 0;
+    [[nodiscard]] virtual std::thread::id lastThreadId() const noexcept = 0;
+};
+
+struct AdderService final : public IAdderService, public Service<AdderService> {
+    AdderService() = default;
+
+    StartBehaviour start() final {
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    uint64_t add(uint64_t value) final {
+        _lastThreadId = std::this_thread::get_id();
+        _total += value;
+        return _total;
+    }
+
+    void reset() final {
+        _lastThreadId = std::this_thread::get_id();
+        _total = 0;
+    }
+
+    [[nodiscard]] uint64_t const& total() const noexcept final {
+        return _total;
+    }
+
+    [[nodiscard]] std::thread::id lastThreadId() const noexcept final {
+        return _lastThreadId;
+    }
+
+    uint64_t _total{};
+    std::thread::id _lastThreadId{};
+};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/services/timer/TimerService.h>
+#include <ichor/Service.h>
+#include <ichor/LifecycleManager.h>
+
+using namespace Ichor;
+
+class ManyTimersService final : public Service<ManyTimersService> {
+public:
+    static constexpr uint64_t TIMERS = 1'000;
+    static constexpr uint64_t FIRES_PER_TIMER = 3;
+
+    ManyTimersService() = default;
+    ~ManyTimersService() final = default;
+
+    StartBehaviour start() final {
+        _timers.reserve(TIMERS);
+        for(uint64_t i = 0; i < TIMERS; i++) {
+            auto *timer = getManager().createServiceManager<Timer, ITimer>();
+            timer->setChronoInterval(std::chrono::milliseconds(1 + i % 10));
+            timer->setCallback(this, [this, timer](DependencyManager &dm) -> AsyncGenerator<void> {
+                count++;
+                if(++_firesPerTimer[timer] == FIRES_PER_TIMER) {
+                    timer->stopTimer();
+                }
+                co_return;
+            });
+            timer->startTimer();
+            _timers.push_back(timer);
+        }
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _timers.clear();
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    uint64_t count{};
+private:
+    std::vector<Timer*> _timers{};
+    unordered_map<Timer*, uint64_t> _firesPerTimer{};
+};
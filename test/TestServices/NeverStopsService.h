@@ -0,0 +1,17 @@
+#pragma once
+
+#include "UselessService.h"
+
+using namespace Ichor;
+
+struct NeverStopsService final : public IUselessService, public Service<NeverStopsService> {
+    NeverStopsService() = default;
+
+    StartBehaviour start() final {
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        return StartBehaviour::FAILED_DO_NOT_RETRY;
+    }
+};
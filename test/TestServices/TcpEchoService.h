@@ -0,0 +1,73 @@
+#pragma once
+
+#include <ichor/DependencyManager.h>
+#include <ichor/services/network/NetworkEvents.h>
+#include <ichor/services/network/IConnectionService.h>
+#include <ichor/Service.h>
+
+using namespace Ichor;
+
+// Sends everything received back over the connection it came from
+struct TcpEchoService final : public Service<TcpEchoService> {
+    TcpEchoService(DependencyRegister &reg, Properties props, DependencyManager *mng) : Service(std::move(props), mng) {
+        reg.registerDependency<IConnectionService>(this, false);
+    }
+    ~TcpEchoService() final = default;
+
+    StartBehaviour start() final {
+        _dataEventRegistration = getManager().registerEventHandler<NetworkDataEvent>(this);
+        _sentEventRegistration = getManager().registerEventHandler<SentMessageEvent>(this);
+        _failedSendEventRegistration = getManager().registerEventHandler<FailedSendMessageEvent>(this);
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _dataEventRegistration.reset();
+        _sentEventRegistration.reset();
+        _failedSendEventRegistration.reset();
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    void addDependencyInstance(IConnectionService *connectionService, IService *isvc) {
+        _connections.emplace(isvc->getServiceId(), connectionService);
+        _connectionsSeen++;
+    }
+
+    void removeDependencyInstance(IConnectionService *, IService *isvc) {
+        _connections.erase(isvc->getServiceId());
+    }
+
+    AsyncGenerator<void> handleEvent(NetworkDataEvent const &evt) {
+        auto connection = _connections.find(evt.originatingService);
+
+        auto const bytes = evt.getBytes();
+        _receivedBytes += bytes.size();
+
+        if(connection != _connections.end()) {
+            connection->second->sendAsync(std::vector<uint8_t>{bytes.begin(), bytes.end()});
+            _echoedMessages++;
+        }
+
+        co_return;
+    }
+
+    AsyncGenerator<void> handleEvent(SentMessageEvent const &) {
+        _sentMessages++;
+        co_return;
+    }
+
+    AsyncGenerator<void> handleEvent(FailedSendMessageEvent const &) {
+        _failedMessages++;
+        co_return;
+    }
+
+    unordered_map<uint64_t, IConnectionService*> _connections{};
+    EventHandlerRegistration _dataEventRegistration{};
+    EventHandlerRegistration _sentEventRegistration{};
+    EventHandlerRegistration _failedSendEventRegistration{};
+    uint64_t _connectionsSeen{};
+    uint64_t _receivedBytes{};
+    uint64_t _echoedMessages{};
+    uint64_t _sentMessages{};
+    uint64_t _failedMessages{};
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/events/SharedPayloadEvent.h>
+#include "../TestEvents.h"
+
+using namespace Ichor;
+
+struct ValueCollectorService final : public Service<ValueCollectorService> {
+    ValueCollectorService() = default;
+
+    StartBehaviour start() final {
+        _handler = getManager().registerEventHandler<ValueEvent>(this);
+        _payloadHandler = getManager().registerEventHandler<SharedPayloadEvent<std::vector<uint64_t>>>(this);
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _handler.reset();
+        _payloadHandler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    AsyncGenerator<void> handleEvent(ValueEvent const &evt) {
+        values.push_back(evt.value);
+
+        co_return;
+    }
+
+    AsyncGenerator<void> handleEvent(SharedPayloadEvent<std::vector<uint64_t>> const &evt) {
+        payloads.push_back(evt.payload);
+
+        co_return;
+    }
+
+    EventHandlerRegistration _handler{};
+    EventHandlerRegistration _payloadHandler{};
+    std::vector<uint64_t> values{};
+    std::vector<std::shared_ptr<std::vector<uint64_t> const>> payloads{};
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <ichor/Service.h>
+#include <ichor/events/Event.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+using namespace Ichor;
+
+template <Derived<Event> EventT>
+struct WorkerEventHandlerService final : public Service<WorkerEventHandlerService<EventT>> {
+    WorkerEventHandlerService() = default;
+
+    StartBehaviour start() final {
+        _handler = this->getManager().template registerWorkerEventHandler<EventT>(this);
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    StartBehaviour stop() final {
+        _handler.reset();
+
+        return StartBehaviour::SUCCEEDED;
+    }
+
+    void handleWorkerEvent(EventT const &evt) {
+        if(running.exchange(true)) {
+            handledConcurrently = true;
+        }
+
+        if(evt.id <= lastEventId) {
+            handledOutOfOrder = true;
+        }
+
+        lastEventId = evt.id;
+        lastThreadId = std::this_thread::get_id();
+        handledEvents++;
+        running.store(false);
+
+        if(throwOnEvent) {
+            throw std::runtime_error("WorkerEventHandlerService throwing on purpose");
+        }
+    }
+
+    EventHandlerRegistration _handler{};
+    std::atomic<bool> running{};
+    bool throwOnEvent{};
+    bool handledConcurrently{};
+    bool handledOutOfOrder{};
+    uint64_t handledEvents{};
+    uint64_t lastEventId{};
+    std::thread::id lastThreadId{};
+};